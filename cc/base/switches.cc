@@ -47,6 +47,25 @@ const char kTopControlsShowThreshold[] = "top-controls-show-threshold";
 // Number of worker threads used to rasterize content.
 const char kNumRasterThreads[] = "num-raster-threads";
 
+// Number of worker threads used to record the content of layers whose
+// clients can paint on several threads at once.
+const char kNumRecordingThreads[] = "num-recording-threads";
+
+// Give each raster thread its own task queue and let idle raster threads steal
+// tasks from the others, instead of sharing one queue between all threads.
+const char kEnableWorkStealingRasterScheduler[] =
+    "enable-work-stealing-raster-scheduler";
+
+// Split large tiles that the cheapness estimator predicts are expensive into
+// bands that are rastered in parallel on the raster threads.
+const char kEnableParallelTileRaster[] = "enable-parallel-tile-raster";
+
+// Let all raster threads play back the same recording of each picture, one
+// thread at a time, instead of giving each thread its own clone. Saves the
+// memory and copying of the clones, but serializes the raster of tiles that
+// share a picture.
+const char kEnableSharedPicturePlayback[] = "enable-shared-picture-playback";
+
 // Show metrics about overdraw in about:tracing recordings, such as the number
 // of pixels culled, and the number of pixels drawn, for each frame.
 const char kTraceOverdraw[] = "trace-overdraw";
@@ -27,6 +27,10 @@ CC_EXPORT extern const char kEnableRightAlignedScheduling[];
 CC_EXPORT extern const char kEnableTopControlsPositionCalculation[];
 CC_EXPORT extern const char kJankInsteadOfCheckerboard[];
 CC_EXPORT extern const char kNumRasterThreads[];
+CC_EXPORT extern const char kNumRecordingThreads[];
+CC_EXPORT extern const char kEnableWorkStealingRasterScheduler[];
+CC_EXPORT extern const char kEnableParallelTileRaster[];
+CC_EXPORT extern const char kEnableSharedPicturePlayback[];
 CC_EXPORT extern const char kTraceOverdraw[];
 CC_EXPORT extern const char kTopControlsHeight[];
 CC_EXPORT extern const char kTopControlsHideThreshold[];
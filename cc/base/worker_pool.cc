@@ -4,11 +4,13 @@
 
 #include "cc/base/worker_pool.h"
 
+#include "base/atomicops.h"
 #include "base/bind.h"
 #include "base/debug/trace_event.h"
 #include "base/stringprintf.h"
 #include "base/synchronization/condition_variable.h"
 #include "base/threading/simple_thread.h"
+#include "cc/base/scoped_ptr_vector.h"
 
 #if defined(OS_ANDROID)
 // TODO(epenner): Move thread priorities to base. (crbug.com/170549)
@@ -57,27 +59,43 @@ void WorkerPoolTask::DidComplete() {
 }  // namespace internal
 
 // Internal to the worker pool. Any data or logic that needs to be
-// shared between threads lives in this class. All members are guarded
-// by |lock_|.
-class WorkerPool::Inner : public base::DelegateSimpleThread::Delegate {
+// shared between threads lives in the implementations of this class.
+class WorkerPool::Inner {
  public:
-  Inner(WorkerPool* worker_pool,
-        size_t num_threads,
-        const std::string& thread_name_prefix,
-        bool need_on_task_completed_callback);
-  virtual ~Inner();
+  virtual ~Inner() {}
 
-  void Shutdown();
+  virtual void Shutdown() = 0;
 
-  void PostTask(scoped_ptr<internal::WorkerPoolTask> task, bool signal_workers);
+  virtual void PostTask(scoped_ptr<internal::WorkerPoolTask> task,
+                        bool signal_workers) = 0;
 
   // Appends all completed tasks to worker pool's completed tasks queue
   // and returns true if idle.
-  bool CollectCompletedTasks();
+  virtual bool CollectCompletedTasks() = 0;
 
   // Runs cheap tasks on caller thread until |time_limit| is reached
   // and returns true if idle.
-  bool RunCheapTasksUntilTimeLimit(base::TimeTicks time_limit);
+  virtual bool RunCheapTasksUntilTimeLimit(base::TimeTicks time_limit) = 0;
+};
+
+// Runs all tasks from a single queue. All members are guarded by |lock_|.
+class WorkerPool::SharedQueueInner
+    : public WorkerPool::Inner,
+      public base::DelegateSimpleThread::Delegate {
+ public:
+  SharedQueueInner(WorkerPool* worker_pool,
+                   size_t num_threads,
+                   const std::string& thread_name_prefix,
+                   bool need_on_task_completed_callback);
+  virtual ~SharedQueueInner();
+
+  // Overridden from WorkerPool::Inner:
+  virtual void Shutdown() OVERRIDE;
+  virtual void PostTask(scoped_ptr<internal::WorkerPoolTask> task,
+                        bool signal_workers) OVERRIDE;
+  virtual bool CollectCompletedTasks() OVERRIDE;
+  virtual bool RunCheapTasksUntilTimeLimit(
+      base::TimeTicks time_limit) OVERRIDE;
 
  private:
   // Appends all completed tasks to |completed_tasks|. Lock must
@@ -114,7 +132,7 @@ class WorkerPool::Inner : public base::DelegateSimpleThread::Delegate {
   // Target message loop used for posting callbacks.
   scoped_refptr<base::MessageLoopProxy> origin_loop_;
 
-  base::WeakPtrFactory<Inner> weak_ptr_factory_;
+  base::WeakPtrFactory<SharedQueueInner> weak_ptr_factory_;
 
   // Set to true when worker pool requires a callback for each
   // completed task.
@@ -145,13 +163,14 @@ class WorkerPool::Inner : public base::DelegateSimpleThread::Delegate {
 
   ScopedPtrDeque<base::DelegateSimpleThread> workers_;
 
-  DISALLOW_COPY_AND_ASSIGN(Inner);
+  DISALLOW_COPY_AND_ASSIGN(SharedQueueInner);
 };
 
-WorkerPool::Inner::Inner(WorkerPool* worker_pool,
-                         size_t num_threads,
-                         const std::string& thread_name_prefix,
-                         bool need_on_task_completed_callback)
+WorkerPool::SharedQueueInner::SharedQueueInner(
+    WorkerPool* worker_pool,
+    size_t num_threads,
+    const std::string& thread_name_prefix,
+    bool need_on_task_completed_callback)
     : worker_pool_on_origin_thread_(worker_pool),
       lock_(),
       has_pending_tasks_cv_(&lock_),
@@ -159,11 +178,13 @@ WorkerPool::Inner::Inner(WorkerPool* worker_pool,
       weak_ptr_factory_(ALLOW_THIS_IN_INITIALIZER_LIST(this)),
       need_on_task_completed_callback_(need_on_task_completed_callback),
       on_task_completed_callback_(
-          base::Bind(&WorkerPool::Inner::OnTaskCompletedOnOriginThread,
-                     weak_ptr_factory_.GetWeakPtr())),
+          base::Bind(
+              &WorkerPool::SharedQueueInner::OnTaskCompletedOnOriginThread,
+              weak_ptr_factory_.GetWeakPtr())),
       on_task_completed_pending_(false),
-      on_idle_callback_(base::Bind(&WorkerPool::Inner::OnIdleOnOriginThread,
-                                   weak_ptr_factory_.GetWeakPtr())),
+      on_idle_callback_(
+          base::Bind(&WorkerPool::SharedQueueInner::OnIdleOnOriginThread,
+                     weak_ptr_factory_.GetWeakPtr())),
       on_idle_pending_(false),
       next_thread_index_(0),
       running_task_count_(0),
@@ -181,7 +202,7 @@ WorkerPool::Inner::Inner(WorkerPool* worker_pool,
   }
 }
 
-WorkerPool::Inner::~Inner() {
+WorkerPool::SharedQueueInner::~SharedQueueInner() {
   base::AutoLock lock(lock_);
 
   DCHECK(shutdown_);
@@ -194,7 +215,7 @@ WorkerPool::Inner::~Inner() {
   DCHECK_EQ(running_task_count_, 0);
 }
 
-void WorkerPool::Inner::Shutdown() {
+void WorkerPool::SharedQueueInner::Shutdown() {
   {
     base::AutoLock lock(lock_);
 
@@ -212,8 +233,8 @@ void WorkerPool::Inner::Shutdown() {
   }
 }
 
-void WorkerPool::Inner::PostTask(scoped_ptr<internal::WorkerPoolTask> task,
-                                 bool signal_workers) {
+void WorkerPool::SharedQueueInner::PostTask(
+    scoped_ptr<internal::WorkerPoolTask> task, bool signal_workers) {
   base::AutoLock lock(lock_);
 
   pending_tasks_.push_back(task.Pass());
@@ -223,14 +244,14 @@ void WorkerPool::Inner::PostTask(scoped_ptr<internal::WorkerPoolTask> task,
     has_pending_tasks_cv_.Signal();
 }
 
-bool WorkerPool::Inner::CollectCompletedTasks() {
+bool WorkerPool::SharedQueueInner::CollectCompletedTasks() {
   base::AutoLock lock(lock_);
 
   return AppendCompletedTasksWithLockAcquired(
       &worker_pool_on_origin_thread_->completed_tasks_);
 }
 
-bool WorkerPool::Inner::RunCheapTasksUntilTimeLimit(
+bool WorkerPool::SharedQueueInner::RunCheapTasksUntilTimeLimit(
     base::TimeTicks time_limit) {
   base::AutoLock lock(lock_);
 
@@ -281,7 +302,7 @@ bool WorkerPool::Inner::RunCheapTasksUntilTimeLimit(
       &worker_pool_on_origin_thread_->completed_tasks_);
 }
 
-bool WorkerPool::Inner::AppendCompletedTasksWithLockAcquired(
+bool WorkerPool::SharedQueueInner::AppendCompletedTasksWithLockAcquired(
     ScopedPtrDeque<internal::WorkerPoolTask>* completed_tasks) {
   lock_.AssertAcquired();
 
@@ -291,7 +312,7 @@ bool WorkerPool::Inner::AppendCompletedTasksWithLockAcquired(
   return !running_task_count_ && pending_tasks_.empty();
 }
 
-void WorkerPool::Inner::ScheduleOnTaskCompletedWithLockAcquired() {
+void WorkerPool::SharedQueueInner::ScheduleOnTaskCompletedWithLockAcquired() {
   lock_.AssertAcquired();
 
   if (on_task_completed_pending_ || !need_on_task_completed_callback_)
@@ -300,7 +321,7 @@ void WorkerPool::Inner::ScheduleOnTaskCompletedWithLockAcquired() {
   on_task_completed_pending_ = true;
 }
 
-void WorkerPool::Inner::OnTaskCompletedOnOriginThread() {
+void WorkerPool::SharedQueueInner::OnTaskCompletedOnOriginThread() {
   {
     base::AutoLock lock(lock_);
 
@@ -314,7 +335,7 @@ void WorkerPool::Inner::OnTaskCompletedOnOriginThread() {
   worker_pool_on_origin_thread_->OnTaskCompleted();
 }
 
-void WorkerPool::Inner::ScheduleOnIdleWithLockAcquired() {
+void WorkerPool::SharedQueueInner::ScheduleOnIdleWithLockAcquired() {
   lock_.AssertAcquired();
 
   if (on_idle_pending_)
@@ -323,7 +344,7 @@ void WorkerPool::Inner::ScheduleOnIdleWithLockAcquired() {
   on_idle_pending_ = true;
 }
 
-void WorkerPool::Inner::OnIdleOnOriginThread() {
+void WorkerPool::SharedQueueInner::OnIdleOnOriginThread() {
   {
     base::AutoLock lock(lock_);
 
@@ -341,7 +362,7 @@ void WorkerPool::Inner::OnIdleOnOriginThread() {
   worker_pool_on_origin_thread_->OnIdle();
 }
 
-void WorkerPool::Inner::Run() {
+void WorkerPool::SharedQueueInner::Run() {
 #if defined(OS_ANDROID)
   // TODO(epenner): Move thread priorities to base. (crbug.com/170549)
   int nice_value = 10; // Idle priority.
@@ -400,10 +421,420 @@ void WorkerPool::Inner::Run() {
   }
 }
 
+// Gives each worker thread its own queue of pending tasks, guarded by its own
+// lock. Tasks are posted round-robin to the queues. A worker runs the tasks in
+// its own queue and steals from the queues of the other workers once its
+// queue is empty. Counters shared by all threads are atomics, so |lock_| is
+// only taken to put an idle worker to sleep or to wake one up.
+class WorkerPool::WorkStealingInner
+    : public WorkerPool::Inner,
+      public base::DelegateSimpleThread::Delegate {
+ public:
+  WorkStealingInner(WorkerPool* worker_pool,
+                    size_t num_threads,
+                    const std::string& thread_name_prefix,
+                    bool need_on_task_completed_callback);
+  virtual ~WorkStealingInner();
+
+  // Overridden from WorkerPool::Inner:
+  virtual void Shutdown() OVERRIDE;
+  virtual void PostTask(scoped_ptr<internal::WorkerPoolTask> task,
+                        bool signal_workers) OVERRIDE;
+  virtual bool CollectCompletedTasks() OVERRIDE;
+  virtual bool RunCheapTasksUntilTimeLimit(
+      base::TimeTicks time_limit) OVERRIDE;
+
+ private:
+  typedef ScopedPtrDeque<internal::WorkerPoolTask> TaskDeque;
+
+  struct TaskQueue {
+    // Protects the members below. Do not block while holding this lock.
+    base::Lock lock;
+
+    TaskDeque pending_tasks;
+    TaskDeque completed_tasks;
+  };
+
+  // Takes the next task from the queue of |thread_index|, or steals one from
+  // the other queues if that queue is empty. Returns NULL if no task is
+  // pending.
+  scoped_ptr<internal::WorkerPoolTask> TakeTask(unsigned thread_index);
+
+  // Takes the first cheap task found in any queue, or returns NULL.
+  scoped_ptr<internal::WorkerPoolTask> TakeCheapTask();
+
+  // Called after a task has been appended to a completed tasks queue.
+  void DidCompleteTask();
+
+  // Wakes up a sleeping worker if there is one.
+  void WakeUpWorker();
+
+  // Appends the completed tasks of all queues to worker pool's completed
+  // tasks queue and returns true if idle.
+  bool AppendCompletedTasks();
+
+  bool IsIdle() const;
+
+  // Schedule a OnTaskCompletedOnOriginThread callback if not already
+  // pending.
+  void ScheduleOnTaskCompleted();
+  void OnTaskCompletedOnOriginThread();
+
+  // Schedule an OnIdleOnOriginThread callback if not already pending.
+  void ScheduleOnIdle();
+  void OnIdleOnOriginThread();
+
+  // Overridden from base::DelegateSimpleThread:
+  virtual void Run() OVERRIDE;
+
+  // Pointer to worker pool. Can only be used on origin thread.
+  WorkerPool* worker_pool_on_origin_thread_;
+
+  // Target message loop used for posting callbacks.
+  scoped_refptr<base::MessageLoopProxy> origin_loop_;
+
+  base::WeakPtrFactory<WorkStealingInner> weak_ptr_factory_;
+
+  // Set to true when worker pool requires a callback for each
+  // completed task.
+  const bool need_on_task_completed_callback_;
+
+  const base::Closure on_task_completed_callback_;
+  // Set when a OnTaskCompletedOnOriginThread() callback is pending.
+  base::subtle::Atomic32 on_task_completed_pending_;
+
+  const base::Closure on_idle_callback_;
+  // Set when a OnIdleOnOriginThread() callback is pending.
+  base::subtle::Atomic32 on_idle_pending_;
+
+  // One queue per worker thread, indexed by thread index. Not modified after
+  // construction.
+  ScopedPtrVector<TaskQueue> queues_;
+
+  // Queue that the next task is posted to. Only used on origin thread.
+  size_t next_queue_index_;
+
+  // Provides each running thread loop with a unique index. First thread
+  // loop index is 0.
+  base::subtle::Atomic32 next_thread_index_;
+
+  // Number of tasks that have been posted but not taken by any thread yet.
+  base::subtle::Atomic32 pending_task_count_;
+
+  // Number of tasks that have been posted but not completed yet.
+  base::subtle::Atomic32 incomplete_task_count_;
+
+  // Number of workers waiting on |has_pending_tasks_cv_|.
+  base::subtle::Atomic32 sleeping_worker_count_;
+
+  // Protects |shutdown_|. Held by a worker while it decides to go to sleep.
+  base::Lock lock_;
+
+  // Condition variable that is waited on by worker threads until new
+  // tasks are posted or shutdown starts.
+  base::ConditionVariable has_pending_tasks_cv_;
+
+  // Set during shutdown. Tells workers to exit when no more tasks
+  // are pending.
+  bool shutdown_;
+
+  ScopedPtrDeque<base::DelegateSimpleThread> workers_;
+
+  DISALLOW_COPY_AND_ASSIGN(WorkStealingInner);
+};
+
+WorkerPool::WorkStealingInner::WorkStealingInner(
+    WorkerPool* worker_pool,
+    size_t num_threads,
+    const std::string& thread_name_prefix,
+    bool need_on_task_completed_callback)
+    : worker_pool_on_origin_thread_(worker_pool),
+      origin_loop_(base::MessageLoopProxy::current()),
+      weak_ptr_factory_(ALLOW_THIS_IN_INITIALIZER_LIST(this)),
+      need_on_task_completed_callback_(need_on_task_completed_callback),
+      on_task_completed_callback_(
+          base::Bind(
+              &WorkerPool::WorkStealingInner::OnTaskCompletedOnOriginThread,
+              weak_ptr_factory_.GetWeakPtr())),
+      on_task_completed_pending_(0),
+      on_idle_callback_(
+          base::Bind(&WorkerPool::WorkStealingInner::OnIdleOnOriginThread,
+                     weak_ptr_factory_.GetWeakPtr())),
+      on_idle_pending_(0),
+      next_queue_index_(0),
+      next_thread_index_(0),
+      pending_task_count_(0),
+      incomplete_task_count_(0),
+      sleeping_worker_count_(0),
+      lock_(),
+      has_pending_tasks_cv_(&lock_),
+      shutdown_(false) {
+  // All queues must exist before the first worker starts stealing.
+  DCHECK_GT(num_threads, 0u);
+  for (size_t i = 0; i < num_threads; ++i)
+    queues_.push_back(make_scoped_ptr(new TaskQueue));
+
+  while (workers_.size() < num_threads) {
+    scoped_ptr<base::DelegateSimpleThread> worker = make_scoped_ptr(
+        new base::DelegateSimpleThread(
+          this,
+          thread_name_prefix +
+          base::StringPrintf("Worker%lu", workers_.size() + 1).c_str()));
+    worker->Start();
+    workers_.push_back(worker.Pass());
+  }
+}
+
+WorkerPool::WorkStealingInner::~WorkStealingInner() {
+  DCHECK(shutdown_);
+
+  // Cancel all pending callbacks.
+  weak_ptr_factory_.InvalidateWeakPtrs();
+
+  DCHECK_EQ(base::subtle::NoBarrier_Load(&incomplete_task_count_), 0);
+  for (size_t i = 0; i < queues_.size(); ++i) {
+    DCHECK_EQ(queues_[i]->pending_tasks.size(), 0);
+    DCHECK_EQ(queues_[i]->completed_tasks.size(), 0);
+  }
+}
+
+void WorkerPool::WorkStealingInner::Shutdown() {
+  {
+    base::AutoLock lock(lock_);
+
+    DCHECK(!shutdown_);
+    shutdown_ = true;
+
+    // Wake up a worker so it knows it should exit. This will cause all workers
+    // to exit as each will wake up another worker before exiting.
+    has_pending_tasks_cv_.Signal();
+  }
+
+  while (workers_.size()) {
+    scoped_ptr<base::DelegateSimpleThread> worker = workers_.take_front();
+    worker->Join();
+  }
+}
+
+void WorkerPool::WorkStealingInner::PostTask(
+    scoped_ptr<internal::WorkerPoolTask> task, bool signal_workers) {
+  TaskQueue* queue = queues_[next_queue_index_];
+  next_queue_index_ = (next_queue_index_ + 1) % queues_.size();
+
+  base::subtle::NoBarrier_AtomicIncrement(&incomplete_task_count_, 1);
+  {
+    base::AutoLock lock(queue->lock);
+    queue->pending_tasks.push_back(task.Pass());
+  }
+  base::subtle::Barrier_AtomicIncrement(&pending_task_count_, 1);
+
+  // There is more work available, so wake up worker thread.
+  if (signal_workers)
+    WakeUpWorker();
+}
+
+bool WorkerPool::WorkStealingInner::CollectCompletedTasks() {
+  return AppendCompletedTasks();
+}
+
+bool WorkerPool::WorkStealingInner::RunCheapTasksUntilTimeLimit(
+    base::TimeTicks time_limit) {
+  while (base::TimeTicks::Now() < time_limit) {
+    scoped_ptr<internal::WorkerPoolTask> task = TakeCheapTask();
+
+    if (!task) {
+      // Schedule an idle callback if requested and not pending.
+      if (IsIdle())
+        ScheduleOnIdle();
+
+      // Exit when no more cheap tasks are pending.
+      break;
+    }
+
+    task->Run();
+
+    // Append tasks directly to worker pool's completed tasks queue.
+    worker_pool_on_origin_thread_->completed_tasks_.push_back(task.Pass());
+    base::subtle::Barrier_AtomicIncrement(&incomplete_task_count_, -1);
+    if (need_on_task_completed_callback_)
+      worker_pool_on_origin_thread_->OnTaskCompleted();
+  }
+
+  if (base::subtle::NoBarrier_Load(&pending_task_count_))
+    WakeUpWorker();
+
+  // Append any other completed tasks.
+  return AppendCompletedTasks();
+}
+
+scoped_ptr<internal::WorkerPoolTask> WorkerPool::WorkStealingInner::TakeTask(
+    unsigned thread_index) {
+  // Look at our own queue first, then at the queues of the other workers in
+  // order. Tasks are taken from the front of a queue, also when stealing, to
+  // keep running them in the order they were posted.
+  for (size_t i = 0; i < queues_.size(); ++i) {
+    TaskQueue* queue = queues_[(thread_index + i) % queues_.size()];
+    base::AutoLock lock(queue->lock);
+    if (queue->pending_tasks.empty())
+      continue;
+    base::subtle::NoBarrier_AtomicIncrement(&pending_task_count_, -1);
+    return queue->pending_tasks.take_front();
+  }
+  return scoped_ptr<internal::WorkerPoolTask>();
+}
+
+scoped_ptr<internal::WorkerPoolTask>
+WorkerPool::WorkStealingInner::TakeCheapTask() {
+  for (size_t i = 0; i < queues_.size(); ++i) {
+    TaskQueue* queue = queues_[i];
+    base::AutoLock lock(queue->lock);
+    for (TaskDeque::iterator iter = queue->pending_tasks.begin();
+         iter != queue->pending_tasks.end(); ++iter) {
+      if ((*iter)->IsCheap()) {
+        base::subtle::NoBarrier_AtomicIncrement(&pending_task_count_, -1);
+        return queue->pending_tasks.take(iter);
+      }
+    }
+  }
+  return scoped_ptr<internal::WorkerPoolTask>();
+}
+
+void WorkerPool::WorkStealingInner::DidCompleteTask() {
+  // Schedule a task completed callback if requested and not pending.
+  ScheduleOnTaskCompleted();
+
+  // Schedule an idle callback if this was the last task.
+  if (!base::subtle::Barrier_AtomicIncrement(&incomplete_task_count_, -1))
+    ScheduleOnIdle();
+}
+
+void WorkerPool::WorkStealingInner::WakeUpWorker() {
+  // A worker increments |sleeping_worker_count_| and then checks
+  // |pending_task_count_| before it waits, while the poster increments
+  // |pending_task_count_| before it gets here. Both use full barriers, so
+  // either the worker sees the new task or we see the sleeping worker.
+  if (!base::subtle::NoBarrier_Load(&sleeping_worker_count_))
+    return;
+
+  base::AutoLock lock(lock_);
+  has_pending_tasks_cv_.Signal();
+}
+
+bool WorkerPool::WorkStealingInner::AppendCompletedTasks() {
+  ScopedPtrDeque<internal::WorkerPoolTask>* completed_tasks =
+      &worker_pool_on_origin_thread_->completed_tasks_;
+
+  // Check for idle before collecting so that a task completing during the
+  // collection is not missed by the caller.
+  const bool is_idle = IsIdle();
+  for (size_t i = 0; i < queues_.size(); ++i) {
+    TaskQueue* queue = queues_[i];
+    base::AutoLock lock(queue->lock);
+    while (queue->completed_tasks.size())
+      completed_tasks->push_back(queue->completed_tasks.take_front().Pass());
+  }
+  return is_idle;
+}
+
+bool WorkerPool::WorkStealingInner::IsIdle() const {
+  return !base::subtle::Acquire_Load(&incomplete_task_count_);
+}
+
+void WorkerPool::WorkStealingInner::ScheduleOnTaskCompleted() {
+  if (!need_on_task_completed_callback_)
+    return;
+  if (base::subtle::Release_CompareAndSwap(&on_task_completed_pending_, 0, 1))
+    return;
+  origin_loop_->PostTask(FROM_HERE, on_task_completed_callback_);
+}
+
+void WorkerPool::WorkStealingInner::OnTaskCompletedOnOriginThread() {
+  DCHECK(base::subtle::NoBarrier_Load(&on_task_completed_pending_));
+
+  // Clear the flag before collecting so that tasks completing after this
+  // point schedule another callback.
+  base::subtle::NoBarrier_Store(&on_task_completed_pending_, 0);
+  base::subtle::MemoryBarrier();
+
+  AppendCompletedTasks();
+
+  worker_pool_on_origin_thread_->OnTaskCompleted();
+}
+
+void WorkerPool::WorkStealingInner::ScheduleOnIdle() {
+  if (base::subtle::Release_CompareAndSwap(&on_idle_pending_, 0, 1))
+    return;
+  origin_loop_->PostTask(FROM_HERE, on_idle_callback_);
+}
+
+void WorkerPool::WorkStealingInner::OnIdleOnOriginThread() {
+  DCHECK(base::subtle::NoBarrier_Load(&on_idle_pending_));
+  base::subtle::NoBarrier_Store(&on_idle_pending_, 0);
+  base::subtle::MemoryBarrier();
+
+  // Early out if no longer idle.
+  if (!IsIdle())
+    return;
+
+  AppendCompletedTasks();
+
+  worker_pool_on_origin_thread_->OnIdle();
+}
+
+void WorkerPool::WorkStealingInner::Run() {
+#if defined(OS_ANDROID)
+  // TODO(epenner): Move thread priorities to base. (crbug.com/170549)
+  int nice_value = 10; // Idle priority.
+  setpriority(PRIO_PROCESS, base::PlatformThread::CurrentId(), nice_value);
+#endif
+
+  // Get a unique thread index.
+  const unsigned thread_index =
+      base::subtle::NoBarrier_AtomicIncrement(&next_thread_index_, 1) - 1;
+  DCHECK_LT(thread_index, queues_.size());
+  TaskQueue* queue = queues_[thread_index];
+
+  while (true) {
+    scoped_ptr<internal::WorkerPoolTask> task = TakeTask(thread_index);
+    if (task) {
+      // There may be more work available, so wake up another
+      // worker thread.
+      if (base::subtle::NoBarrier_Load(&pending_task_count_))
+        WakeUpWorker();
+
+      task->RunOnThread(thread_index);
+
+      {
+        base::AutoLock lock(queue->lock);
+        queue->completed_tasks.push_back(task.Pass());
+      }
+      DidCompleteTask();
+      continue;
+    }
+
+    base::AutoLock lock(lock_);
+
+    // Exit when shutdown is set and no more tasks are pending.
+    if (shutdown_ && !base::subtle::NoBarrier_Load(&pending_task_count_)) {
+      // We noticed we should exit. Wake up the next worker so it knows it
+      // should exit as well (because the Shutdown() code only signals once).
+      has_pending_tasks_cv_.Signal();
+      break;
+    }
+
+    // Wait for new pending tasks, unless one was posted since we looked.
+    base::subtle::Barrier_AtomicIncrement(&sleeping_worker_count_, 1);
+    if (!shutdown_ && !base::subtle::NoBarrier_Load(&pending_task_count_))
+      has_pending_tasks_cv_.Wait();
+    base::subtle::Barrier_AtomicIncrement(&sleeping_worker_count_, -1);
+  }
+}
+
 WorkerPool::WorkerPool(WorkerPoolClient* client,
                        size_t num_threads,
                        base::TimeDelta check_for_completed_tasks_delay,
-                       const std::string& thread_name_prefix)
+                       const std::string& thread_name_prefix,
+                       Scheduler scheduler)
     : client_(client),
       origin_loop_(base::MessageLoopProxy::current()),
       weak_ptr_factory_(ALLOW_THIS_IN_INITIALIZER_LIST(this)),
@@ -413,14 +844,14 @@ WorkerPool::WorkerPool(WorkerPoolClient* client,
           base::Bind(&WorkerPool::RunCheapTasks,
                      weak_ptr_factory_.GetWeakPtr())),
       run_cheap_tasks_pending_(false),
-      inner_(make_scoped_ptr(
-                 new Inner(
-                     this,
-                     num_threads,
-                     thread_name_prefix,
-                     // Request OnTaskCompleted() callback when check
-                     // for completed tasks delay is 0.
-                     check_for_completed_tasks_delay == base::TimeDelta()))) {
+      inner_(CreateInner(
+                 this,
+                 scheduler,
+                 num_threads,
+                 thread_name_prefix,
+                 // Request OnTaskCompleted() callback when check
+                 // for completed tasks delay is 0.
+                 check_for_completed_tasks_delay == base::TimeDelta())) {
 }
 
 WorkerPool::~WorkerPool() {
@@ -450,6 +881,31 @@ void WorkerPool::SetRunCheapTasksTimeLimit(
   ScheduleRunCheapTasks();
 }
 
+// static
+scoped_ptr<WorkerPool::Inner> WorkerPool::CreateInner(
+    WorkerPool* worker_pool,
+    Scheduler scheduler,
+    size_t num_threads,
+    const std::string& thread_name_prefix,
+    bool need_on_task_completed_callback) {
+  switch (scheduler) {
+    case SHARED_QUEUE_SCHEDULER:
+      return make_scoped_ptr(new SharedQueueInner(
+          worker_pool,
+          num_threads,
+          thread_name_prefix,
+          need_on_task_completed_callback)).PassAs<Inner>();
+    case WORK_STEALING_SCHEDULER:
+      return make_scoped_ptr(new WorkStealingInner(
+          worker_pool,
+          num_threads,
+          thread_name_prefix,
+          need_on_task_completed_callback)).PassAs<Inner>();
+  }
+  NOTREACHED();
+  return scoped_ptr<Inner>();
+}
+
 void WorkerPool::OnIdle() {
   TRACE_EVENT0("cc", "WorkerPool::OnIdle");
 
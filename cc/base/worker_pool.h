@@ -52,6 +52,16 @@ class WorkerPool {
  public:
   typedef base::Callback<void()> Callback;
 
+  // How pending tasks are handed out to the worker threads.
+  enum Scheduler {
+    // All worker threads take tasks from one queue guarded by one lock.
+    SHARED_QUEUE_SCHEDULER,
+    // Each worker thread has its own queue and steals tasks from the queues
+    // of other workers when its own is empty. Less lock contention with many
+    // threads.
+    WORK_STEALING_SCHEDULER,
+  };
+
   virtual ~WorkerPool();
 
   static scoped_ptr<WorkerPool> Create(
@@ -59,10 +69,24 @@ class WorkerPool {
       size_t num_threads,
       base::TimeDelta check_for_completed_tasks_delay,
       const std::string& thread_name_prefix) {
+    return Create(client,
+                  num_threads,
+                  check_for_completed_tasks_delay,
+                  thread_name_prefix,
+                  SHARED_QUEUE_SCHEDULER);
+  }
+
+  static scoped_ptr<WorkerPool> Create(
+      WorkerPoolClient* client,
+      size_t num_threads,
+      base::TimeDelta check_for_completed_tasks_delay,
+      const std::string& thread_name_prefix,
+      Scheduler scheduler) {
     return make_scoped_ptr(new WorkerPool(client,
                                           num_threads,
                                           check_for_completed_tasks_delay,
-                                          thread_name_prefix));
+                                          thread_name_prefix,
+                                          scheduler));
   }
 
   // Tells the worker pool to shutdown and returns once all pending tasks have
@@ -80,13 +104,24 @@ class WorkerPool {
   WorkerPool(WorkerPoolClient* client,
              size_t num_threads,
              base::TimeDelta check_for_completed_tasks_delay,
-             const std::string& thread_name_prefix);
+             const std::string& thread_name_prefix,
+             Scheduler scheduler);
 
   void PostTask(scoped_ptr<internal::WorkerPoolTask> task);
 
  private:
   class Inner;
+  class SharedQueueInner;
+  class WorkStealingInner;
   friend class Inner;
+  friend class SharedQueueInner;
+  friend class WorkStealingInner;
+
+  static scoped_ptr<Inner> CreateInner(WorkerPool* worker_pool,
+                                       Scheduler scheduler,
+                                       size_t num_threads,
+                                       const std::string& thread_name_prefix,
+                                       bool need_on_task_completed_callback);
 
   void OnTaskCompleted();
   void OnIdle();
@@ -0,0 +1,104 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cc/base/worker_pool.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/message_loop.h"
+#include "base/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace cc {
+namespace {
+
+static const int kNumTasks = 50000;
+static const int kTaskWorkIterations = 2000;
+static const size_t kNumThreads[] = { 1, 2, 4, 8, 16, 32 };
+
+class PerfWorkerPoolClient : public WorkerPoolClient {
+ public:
+  virtual void DidFinishDispatchingWorkerPoolCompletionCallbacks() OVERRIDE {}
+};
+
+// Records how long the task waited before it started running, then does a
+// small amount of work to stand in for a raster task.
+void RunTask(base::TimeTicks post_time, base::TimeDelta* latency) {
+  *latency = base::TimeTicks::HighResNow() - post_time;
+  volatile int sum = 0;
+  for (int i = 0; i < kTaskWorkIterations; ++i)
+    sum += i;
+}
+
+class WorkerPoolPerfTest : public testing::Test {
+ public:
+  WorkerPoolPerfTest() : num_completed_tasks_(0) {}
+
+  void RunTest(const char* name,
+               WorkerPool::Scheduler scheduler,
+               size_t num_threads) {
+    std::vector<base::TimeDelta> latencies(kNumTasks);
+    base::TimeDelta elapsed;
+    {
+      // Request a completion callback for every batch of completed tasks
+      // so that the elapsed time is not dominated by a polling delay.
+      scoped_ptr<WorkerPool> worker_pool = WorkerPool::Create(
+          &client_, num_threads, base::TimeDelta(), "PerfTest", scheduler);
+
+      num_completed_tasks_ = 0;
+      base::TimeTicks start_time = base::TimeTicks::HighResNow();
+      for (int i = 0; i < kNumTasks; ++i) {
+        worker_pool->PostTaskAndReply(
+            base::Bind(&RunTask,
+                       base::TimeTicks::HighResNow(),
+                       &latencies[i]),
+            base::Bind(&WorkerPoolPerfTest::OnTaskCompleted,
+                       base::Unretained(this)));
+      }
+      message_loop_.Run();
+      elapsed = base::TimeTicks::HighResNow() - start_time;
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    // Format matches chrome/test/perf/perf_test.h:PrintResult
+    printf("*RESULT worker_pool_%s_%u_threads: throughput= %.2f tasks/ms\n",
+           name,
+           static_cast<unsigned>(num_threads),
+           kNumTasks / elapsed.InMillisecondsF());
+    printf("*RESULT worker_pool_%s_%u_threads: latency_50= %.2f us\n",
+           name,
+           static_cast<unsigned>(num_threads),
+           latencies[kNumTasks / 2].InMillisecondsF() * 1000);
+    printf("*RESULT worker_pool_%s_%u_threads: latency_99= %.2f us\n",
+           name,
+           static_cast<unsigned>(num_threads),
+           latencies[kNumTasks * 99 / 100].InMillisecondsF() * 1000);
+  }
+
+  void OnTaskCompleted() {
+    if (++num_completed_tasks_ == kNumTasks)
+      message_loop_.Quit();
+  }
+
+ protected:
+  MessageLoop message_loop_;
+  PerfWorkerPoolClient client_;
+  int num_completed_tasks_;
+};
+
+TEST_F(WorkerPoolPerfTest, SharedQueue) {
+  for (size_t i = 0; i < arraysize(kNumThreads); ++i)
+    RunTest("shared_queue", WorkerPool::SHARED_QUEUE_SCHEDULER, kNumThreads[i]);
+}
+
+TEST_F(WorkerPoolPerfTest, WorkStealing) {
+  for (size_t i = 0; i < arraysize(kNumThreads); ++i)
+    RunTest("work_stealing", WorkerPool::WORK_STEALING_SCHEDULER,
+            kNumThreads[i]);
+}
+
+}  // namespace
+}  // namespace cc
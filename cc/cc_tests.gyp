@@ -204,6 +204,8 @@
         'cc_test_support',
       ],
       'sources': [
+        'base/worker_pool_perftest.cc',
+        'resources/raster_worker_pool_perftest.cc',
         'trees/layer_tree_host_perftest.cc',
         'test/run_all_unittests.cc',
         'test/cc_test_suite.cc',
@@ -16,6 +16,7 @@ RenderingStats::RenderingStats()
       num_impl_thread_scrolls(0),
       num_main_thread_scrolls(0),
       num_layers_drawn(0),
+      num_layers_pushed(0),
       num_missing_tiles(0),
       total_deferred_image_decode_count(0),
       total_deferred_image_cache_hit_count(0),
@@ -35,11 +36,14 @@ void RenderingStats::EnumerateFields(Enumerator* enumerator) const {
   enumerator->AddDouble("totalCommitTimeInSeconds",
                         total_commit_time.InSecondsF());
   enumerator->AddInt64("totalCommitCount", total_commit_count);
+  enumerator->AddDouble("totalMainThreadBlockedTimeInSeconds",
+                        total_main_thread_blocked_time.InSecondsF());
   enumerator->AddInt64("totalPixelsPainted", total_pixels_painted);
   enumerator->AddInt64("totalPixelsRasterized", total_pixels_rasterized);
   enumerator->AddInt64("numImplThreadScrolls", num_impl_thread_scrolls);
   enumerator->AddInt64("numMainThreadScrolls", num_main_thread_scrolls);
   enumerator->AddInt64("numLayersDrawn", num_layers_drawn);
+  enumerator->AddInt64("numLayersPushed", num_layers_pushed);
   enumerator->AddInt64("numMissingTiles", num_missing_tiles);
   enumerator->AddInt64("totalDeferredImageDecodeCount",
                        total_deferred_image_decode_count);
@@ -63,11 +67,13 @@ void RenderingStats::Add(const RenderingStats& other) {
       other.total_rasterize_time_for_now_bins_on_pending_tree;
   total_commit_time += other.total_commit_time;
   total_commit_count += other.total_commit_count;
+  total_main_thread_blocked_time += other.total_main_thread_blocked_time;
   total_pixels_painted += other.total_pixels_painted;
   total_pixels_rasterized += other.total_pixels_rasterized;
   num_impl_thread_scrolls += other.num_impl_thread_scrolls;
   num_main_thread_scrolls += other.num_main_thread_scrolls;
   num_layers_drawn += other.num_layers_drawn;
+  num_layers_pushed += other.num_layers_pushed;
   num_missing_tiles += other.num_missing_tiles;
   total_deferred_image_decode_count += other.total_deferred_image_decode_count;
   total_deferred_image_cache_hit_count +=
@@ -20,11 +20,13 @@ struct CC_EXPORT RenderingStats {
   base::TimeDelta total_rasterize_time_for_now_bins_on_pending_tree;
   base::TimeDelta total_commit_time;
   int64 total_commit_count;
+  base::TimeDelta total_main_thread_blocked_time;
   int64 total_pixels_painted;
   int64 total_pixels_rasterized;
   int64 num_impl_thread_scrolls;
   int64 num_main_thread_scrolls;
   int64 num_layers_drawn;
+  int64 num_layers_pushed;
   int64 num_missing_tiles;
   int64 total_deferred_image_decode_count;
   int64 total_deferred_image_cache_hit_count;
@@ -77,6 +77,15 @@ void RenderingStatsInstrumentation::AddCommit(base::TimeDelta duration) {
   rendering_stats_.total_commit_count++;
 }
 
+void RenderingStatsInstrumentation::AddMainThreadBlocked(
+    base::TimeDelta duration) {
+  if (!record_rendering_stats_)
+    return;
+
+  base::AutoLock scoped_lock(lock_);
+  rendering_stats_.total_main_thread_blocked_time += duration;
+}
+
 void RenderingStatsInstrumentation::AddPaint(base::TimeDelta duration,
                                              int64 pixels) {
   if (!record_rendering_stats_)
@@ -127,6 +136,14 @@ void RenderingStatsInstrumentation::AddLayersDrawn(int64 amount) {
   rendering_stats_.num_layers_drawn += amount;
 }
 
+void RenderingStatsInstrumentation::AddLayersPushed(int64 amount) {
+  if (!record_rendering_stats_)
+    return;
+
+  base::AutoLock scoped_lock(lock_);
+  rendering_stats_.num_layers_pushed += amount;
+}
+
 void RenderingStatsInstrumentation::AddMissingTiles(int64 amount) {
   if (!record_rendering_stats_)
     return;
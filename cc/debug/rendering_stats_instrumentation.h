@@ -41,6 +41,7 @@ class CC_EXPORT RenderingStatsInstrumentation {
   void SetDroppedFrameCount(int64 count);
 
   void AddCommit(base::TimeDelta duration);
+  void AddMainThreadBlocked(base::TimeDelta duration);
   void AddPaint(base::TimeDelta duration, int64 pixels);
   void AddRaster(base::TimeDelta duration,
                  int64 pixels,
@@ -50,6 +51,7 @@ class CC_EXPORT RenderingStatsInstrumentation {
   void IncrementMainThreadScrolls();
 
   void AddLayersDrawn(int64 amount);
+  void AddLayersPushed(int64 amount);
   void AddMissingTiles(int64 amount);
 
   void AddDeferredImageDecode(base::TimeDelta duration);
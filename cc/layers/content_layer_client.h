@@ -26,6 +26,11 @@ class CC_EXPORT ContentLayerClient {
   // If the client paints LCD text, it may want to invalidate the layer.
   virtual void DidChangeLayerCanUseLCDText() = 0;
 
+  // Returns true if PaintContents() may be called on several threads at
+  // once, each call with its own canvas and clip. Picture layers then record
+  // their tiles in parallel on the recording threads of the LayerTreeHost.
+  virtual bool CanPaintConcurrently() const { return false; }
+
  protected:
   virtual ~ContentLayerClient() {}
 };
@@ -31,6 +31,8 @@ Layer::Layer()
       layer_id_(s_next_layer_id++),
       ignore_set_needs_commit_(false),
       parent_(NULL),
+      needs_push_properties_(true),
+      num_dependents_need_push_properties_(0),
       layer_tree_host_(NULL),
       scrollable_(false),
       should_scroll_on_main_thread_(false),
@@ -110,6 +112,10 @@ void Layer::SetLayerTreeHost(LayerTreeHost* host) {
 }
 
 void Layer::SetNeedsCommit() {
+  // Changes made while updating are committed with the update, but still
+  // need to be pushed.
+  SetNeedsPushProperties();
+
   if (ignore_set_needs_commit_)
     return;
   if (layer_tree_host_)
@@ -121,6 +127,28 @@ void Layer::SetNeedsFullTreeSync() {
     layer_tree_host_->SetNeedsFullTreeSync();
 }
 
+void Layer::SetNeedsPushProperties() {
+  if (needs_push_properties_)
+    return;
+  if (!parent_should_know_need_push_properties() && parent_)
+    parent_->AddDependentNeedsPushProperties();
+  needs_push_properties_ = true;
+}
+
+void Layer::AddDependentNeedsPushProperties() {
+  DCHECK_GE(num_dependents_need_push_properties_, 0);
+  if (!parent_should_know_need_push_properties() && parent_)
+    parent_->AddDependentNeedsPushProperties();
+  num_dependents_need_push_properties_++;
+}
+
+void Layer::RemoveDependentNeedsPushProperties() {
+  num_dependents_need_push_properties_--;
+  DCHECK_GE(num_dependents_need_push_properties_, 0);
+  if (!parent_should_know_need_push_properties() && parent_)
+    parent_->RemoveDependentNeedsPushProperties();
+}
+
 gfx::Rect Layer::LayerRectToContentRect(const gfx::RectF& layer_rect) const {
   gfx::RectF content_rect =
       gfx::ScaleRect(layer_rect, contents_scale_x(), contents_scale_y());
@@ -154,6 +182,14 @@ bool Layer::BlocksPendingCommitRecursive() const {
 
 void Layer::SetParent(Layer* layer) {
   DCHECK(!layer || !layer->HasAncestor(this));
+
+  if (parent_should_know_need_push_properties()) {
+    if (parent_)
+      parent_->RemoveDependentNeedsPushProperties();
+    if (layer)
+      layer->AddDependentNeedsPushProperties();
+  }
+
   parent_ = layer;
   SetLayerTreeHost(parent_ ? parent_->layer_tree_host() : NULL);
 
@@ -481,6 +517,7 @@ void Layer::SetTouchEventHandlerRegion(const Region& region) {
   if (touch_event_handler_region_ == region)
     return;
   touch_event_handler_region_ = region;
+  SetNeedsPushProperties();
 }
 
 void Layer::SetDrawCheckerboardForMissingTiles(bool checkerboard) {
@@ -631,6 +668,12 @@ void Layer::PushPropertiesTo(LayerImpl* layer) {
   // Reset any state that should be cleared for the next update.
   stacking_order_changed_ = false;
   update_rect_ = gfx::RectF();
+
+  // Animations are pushed until they have been removed from the impl side,
+  // and the scroll delta sent to the main thread is cleared with every
+  // commit, so animating and scrollable layers push with every commit.
+  needs_push_properties_ =
+      layer_animation_controller_->has_any_animation() || scrollable_;
 }
 
 scoped_ptr<LayerImpl> Layer::CreateLayerImpl(LayerTreeImpl* tree_impl) {
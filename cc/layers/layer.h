@@ -256,6 +256,20 @@ class CC_EXPORT Layer : public base::RefCounted<Layer>,
 
   virtual void PushPropertiesTo(LayerImpl* layer);
 
+  // True when this layer has changed since it last pushed its properties, or
+  // must push them with every commit. The tree synchronizer only pushes
+  // layers that need it, and only walks into subtrees where a descendant
+  // does.
+  bool needs_push_properties() const { return needs_push_properties_; }
+  bool descendant_needs_push_properties() const {
+    return num_dependents_need_push_properties_ > 0;
+  }
+
+  // Marks this layer as needing PushPropertiesTo() with the next commit,
+  // without requesting one. Subclasses whose impl side state must be
+  // refreshed every commit call this at the end of PushPropertiesTo().
+  void SetNeedsPushProperties();
+
   void ClearRenderSurface() { draw_properties_.render_surface.reset(); }
   void CreateRenderSurface();
 
@@ -379,6 +393,12 @@ class CC_EXPORT Layer : public base::RefCounted<Layer>,
   bool ignore_set_needs_commit_;
 
  private:
+  void AddDependentNeedsPushProperties();
+  void RemoveDependentNeedsPushProperties();
+  bool parent_should_know_need_push_properties() const {
+    return needs_push_properties() || descendant_needs_push_properties();
+  }
+
   friend class base::RefCounted<Layer>;
 
   void SetParent(Layer* layer);
@@ -399,6 +419,12 @@ class CC_EXPORT Layer : public base::RefCounted<Layer>,
   LayerList children_;
   Layer* parent_;
 
+  // Whether this layer needs to push its properties, and how many of its
+  // children, mask and replica layers need to or have a descendant that
+  // does.
+  bool needs_push_properties_;
+  int num_dependents_need_push_properties_;
+
   // Layer instances have a weak pointer to their LayerTreeHost.
   // This pointer value is nil when a Layer is not in a tree and is
   // updated via SetLayerTreeHost() if a layer moves between trees.
@@ -111,6 +111,9 @@ void NinePatchLayer::PushPropertiesTo(LayerImpl* layer) {
     layer_impl->SetLayout(
         gfx::Size(bitmap_.width(), bitmap_.height()), image_aperture_);
   }
+
+  // The resource may be evicted and recreated without a commit request.
+  SetNeedsPushProperties();
 }
 
 }
@@ -44,6 +44,10 @@ void PictureLayer::PushPropertiesTo(LayerImpl* base_layer) {
   layer_impl->pile_ =
       PicturePileImpl::CreateFromOther(pile_, layer_impl->is_using_lcd_text_);
   layer_impl->SyncFromActiveLayer();
+
+  // The pending layer hands its pile and tilings to the active layer when it
+  // is activated, and the recycled pending tree gets them back from here.
+  SetNeedsPushProperties();
 }
 
 void PictureLayer::SetLayerTreeHost(LayerTreeHost* host) {
@@ -52,6 +56,8 @@ void PictureLayer::SetLayerTreeHost(LayerTreeHost* host) {
     pile_->SetMinContentsScale(host->settings().minimum_contents_scale);
     pile_->SetTileGridSize(host->settings().default_tile_size);
     pile_->set_num_raster_threads(host->settings().num_raster_threads);
+    pile_->set_shared_picture_playback(
+        host->settings().shared_picture_playback);
     pile_->set_slow_down_raster_scale_factor(
         host->debug_state().slow_down_raster_scale_factor);
   }
@@ -87,6 +93,7 @@ void PictureLayer::Update(ResourceUpdateQueue*,
                 background_color(),
                 pile_invalidation_,
                 visible_layer_rect,
+                layer_tree_host()->recording_worker_pool(),
                 stats);
 }
 
@@ -136,6 +136,9 @@ void ScrollbarLayer::PushPropertiesTo(LayerImpl* layer) {
   // set in LayerImpl, so we need to push it here.
   if (scroll_layer_id_ == Layer::PINCH_ZOOM_ROOT_SCROLL_LAYER_ID)
     scrollbar_layer->set_scroll_layer_id(scroll_layer_id_);
+
+  // The scrollbar data is read from |scrollbar_| here, not set on this layer.
+  SetNeedsPushProperties();
 }
 
 ScrollbarLayer* ScrollbarLayer::ToScrollbarLayer() {
@@ -220,6 +220,10 @@ void TiledLayer::PushPropertiesTo(LayerImpl* layer) {
        iter != invalid_tiles.end();
        ++iter)
     tiler_->TakeTile((*iter)->i(), (*iter)->j());
+
+  // Tile backings can be evicted on the impl thread between commits, which
+  // the impl layer only learns about from here.
+  SetNeedsPushProperties();
 }
 
 bool TiledLayer::BlocksPendingCommit() const { return true; }
@@ -147,13 +147,17 @@ void Picture::Raster(
   // Pictures by default have LCD text enabled.
   if (!enable_lcd_text)
     canvas->setDrawFilter(&disable_lcd_text_filter);
-  canvas->drawPicture(*picture_);
+  {
+    base::AutoLock lock(playback_lock_);
+    canvas->drawPicture(*picture_);
+  }
   canvas->restore();
 }
 
 void Picture::GatherPixelRefs(const gfx::Rect& layer_rect,
                               std::list<skia::LazyPixelRef*>& pixel_ref_list) {
   DCHECK(picture_);
+  base::AutoLock lock(playback_lock_);
   SkData* pixel_refs = SkPictureUtils::GatherPixelRefs(
       picture_.get(), SkRect::MakeXYWH(layer_rect.x(),
                                        layer_rect.y(),
@@ -10,6 +10,7 @@
 
 #include "base/basictypes.h"
 #include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
 #include "cc/base/cc_export.h"
 #include "skia/ext/lazy_pixel_ref.h"
 #include "skia/ext/refptr.h"
@@ -50,6 +51,9 @@ class CC_EXPORT Picture
   bool HasRecording() const { return picture_.get() != NULL; }
 
   // Apply this contents scale and raster the content rect into the canvas.
+  // Playback may write to objects the recording holds, so a picture shared
+  // by several raster threads is played back by one of them at a time. A
+  // clone is only played back by its own thread.
   void Raster(SkCanvas* canvas,
               gfx::Rect content_rect,
               float contents_scale,
@@ -75,6 +79,9 @@ class CC_EXPORT Picture
   typedef std::vector<scoped_refptr<Picture> > PictureVector;
   PictureVector clones_;
 
+  // Held for the playback of |picture_| by Raster() and GatherPixelRefs().
+  base::Lock playback_lock_;
+
   friend class base::RefCountedThreadSafe<Picture>;
   DISALLOW_COPY_AND_ASSIGN(Picture);
 };
@@ -4,7 +4,15 @@
 
 #include <algorithm>
 
+#include "base/bind.h"
+#include "base/bind_helpers.h"
+#include "base/debug/trace_event.h"
+#include "base/synchronization/lock.h"
+#include "cc/base/completion_event.h"
 #include "cc/base/region.h"
+#include "cc/base/worker_pool.h"
+#include "cc/debug/rendering_stats.h"
+#include "cc/layers/content_layer_client.h"
 #include "cc/resources/picture_pile.h"
 #include "cc/resources/picture_pile_impl.h"
 
@@ -19,6 +27,43 @@ const float kResetThreshold = 0.7f;
 // picture that intersects the visible layer rect expanded by this distance
 // will be recorded.
 const int kPixelDistanceToRecord = 8000;
+
+// Lets the thread that posted the recording tasks of an update wait for
+// them. The last task to finish signals it.
+class RecordingTasks {
+ public:
+  explicit RecordingTasks(int num_tasks) : num_pending_(num_tasks) {}
+
+  void DidFinishTask() {
+    bool last_task;
+    {
+      base::AutoLock lock(lock_);
+      last_task = --num_pending_ == 0;
+    }
+    if (last_task)
+      done_.Signal();
+  }
+
+  void WaitForAll() { done_.Wait(); }
+
+ private:
+  base::Lock lock_;
+  int num_pending_;
+  cc::CompletionEvent done_;
+
+  DISALLOW_COPY_AND_ASSIGN(RecordingTasks);
+};
+
+void RecordOnWorkerThread(
+    scoped_refptr<cc::Picture> picture,
+    cc::ContentLayerClient* painter,
+    const SkTileGridPicture::TileGridInfo& tile_grid_info,
+    cc::RenderingStats* stats,
+    RecordingTasks* tasks) {
+  picture->Record(painter, stats, tile_grid_info);
+  tasks->DidFinishTask();
+}
+
 }
 
 namespace cc {
@@ -34,6 +79,7 @@ void PicturePile::Update(
     SkColor background_color,
     const Region& invalidation,
     gfx::Rect visible_layer_rect,
+    WorkerPool* recording_worker_pool,
     RenderingStats* stats) {
   background_color_ = background_color;
 
@@ -81,6 +127,7 @@ void PicturePile::Update(
   }
 
   // Walk through all pictures in the rect of interest and record.
+  std::vector<scoped_refptr<Picture> > pictures_to_record;
   for (TilingData::Iterator iter(&tiling_, interest_rect); iter; ++iter) {
     // Create a picture in this list if it doesn't exist.
     PictureList& pic_list = picture_list_map_[iter.index()];
@@ -100,16 +147,60 @@ void PicturePile::Update(
 
     for (PictureList::iterator pic = pic_list.begin();
          pic != pic_list.end(); ++pic) {
-      if (!(*pic)->HasRecording()) {
-        (*pic)->Record(painter, stats, tile_grid_info_);
-        (*pic)->CloneForDrawing(num_raster_threads_);
-      }
+      if (!(*pic)->HasRecording())
+        pictures_to_record.push_back(*pic);
     }
   }
 
+  if (recording_worker_pool && painter->CanPaintConcurrently() &&
+      pictures_to_record.size() > 1) {
+    RecordInParallel(painter, pictures_to_record, recording_worker_pool,
+                     stats);
+  } else {
+    for (size_t i = 0; i < pictures_to_record.size(); ++i)
+      pictures_to_record[i]->Record(painter, stats, tile_grid_info_);
+  }
+
+  if (!shared_picture_playback_) {
+    for (size_t i = 0; i < pictures_to_record.size(); ++i)
+      pictures_to_record[i]->CloneForDrawing(num_raster_threads_);
+  }
+
   UpdateRecordedRegion();
 }
 
+void PicturePile::RecordInParallel(
+    ContentLayerClient* painter,
+    const std::vector<scoped_refptr<Picture> >& pictures,
+    WorkerPool* recording_worker_pool,
+    RenderingStats* stats) {
+  TRACE_EVENT1("cc", "PicturePile::RecordInParallel",
+               "num_pictures", pictures.size());
+  DCHECK_GT(pictures.size(), 1u);
+
+  // Each task adds to its own stats, which are summed once all are done.
+  std::vector<RenderingStats> task_stats(pictures.size());
+  RecordingTasks tasks(pictures.size() - 1);
+  for (size_t i = 1; i < pictures.size(); ++i) {
+    recording_worker_pool->PostTaskAndReply(
+        base::Bind(&RecordOnWorkerThread,
+                   pictures[i],
+                   painter,
+                   tile_grid_info_,
+                   stats ? &task_stats[i] : NULL,
+                   &tasks),
+        base::Bind(&base::DoNothing));
+  }
+
+  pictures[0]->Record(painter, stats, tile_grid_info_);
+  tasks.WaitForAll();
+
+  if (stats) {
+    for (size_t i = 1; i < task_stats.size(); ++i)
+      stats->Add(task_stats[i]);
+  }
+}
+
 class FullyContainedPredicate {
  public:
   FullyContainedPredicate(gfx::Rect rect) : layer_rect_(rect) {}
@@ -5,12 +5,15 @@
 #ifndef CC_RESOURCES_PICTURE_PILE_H_
 #define CC_RESOURCES_PICTURE_PILE_H_
 
+#include <vector>
+
 #include "cc/resources/picture_pile_base.h"
 #include "ui/gfx/rect.h"
 
 namespace cc {
 class PicturePileImpl;
 class Region;
+class WorkerPool;
 struct RenderingStats;
 
 class CC_EXPORT PicturePile : public PicturePileBase {
@@ -19,17 +22,27 @@ class CC_EXPORT PicturePile : public PicturePileBase {
 
   // Re-record parts of the picture that are invalid.
   // Invalidations are in layer space.
+  // If |recording_worker_pool| is not NULL and |painter| can paint
+  // concurrently, the pictures are recorded in parallel on the pool and the
+  // calling thread, and this returns once all of them are recorded.
   void Update(
       ContentLayerClient* painter,
       SkColor background_color,
       const Region& invalidation,
       gfx::Rect visible_layer_rect,
+      WorkerPool* recording_worker_pool,
       RenderingStats* stats);
 
   void set_num_raster_threads(int num_raster_threads) {
     num_raster_threads_ = num_raster_threads;
   }
 
+  // When |shared|, the raster threads play back the pictures of this pile
+  // instead of clones of them, one thread at a time for each picture.
+  void set_shared_picture_playback(bool shared) {
+    shared_picture_playback_ = shared;
+  }
+
   void set_slow_down_raster_scale_factor(int factor) {
     slow_down_raster_scale_factor_for_debug_ = factor;
   }
@@ -44,6 +57,14 @@ class CC_EXPORT PicturePile : public PicturePileBase {
       PictureList& picture_list,
       gfx::Rect invalidation);
 
+  // Records |pictures|, the first one on the calling thread and the others
+  // on |recording_worker_pool|, and waits for all of them.
+  void RecordInParallel(
+      ContentLayerClient* painter,
+      const std::vector<scoped_refptr<Picture> >& pictures,
+      WorkerPool* recording_worker_pool,
+      RenderingStats* stats);
+
   DISALLOW_COPY_AND_ASSIGN(PicturePile);
 };
 
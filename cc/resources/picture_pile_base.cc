@@ -21,7 +21,8 @@ PicturePileBase::PicturePileBase()
     : min_contents_scale_(0),
       background_color_(SkColorSetARGBInline(0, 0, 0, 0)),
       slow_down_raster_scale_factor_for_debug_(0),
-      num_raster_threads_(0) {
+      num_raster_threads_(0),
+      shared_picture_playback_(false) {
   tiling_.SetMaxTextureSize(gfx::Size(kBasePictureSize, kBasePictureSize));
   tile_grid_info_.fTileInterval.setEmpty();
   tile_grid_info_.fMargin.setEmpty();
@@ -37,7 +38,8 @@ PicturePileBase::PicturePileBase(const PicturePileBase* other)
       background_color_(other->background_color_),
       slow_down_raster_scale_factor_for_debug_(
           other->slow_down_raster_scale_factor_for_debug_),
-      num_raster_threads_(other->num_raster_threads_) {
+      num_raster_threads_(other->num_raster_threads_),
+      shared_picture_playback_(other->shared_picture_playback_) {
 }
 
 PicturePileBase::PicturePileBase(
@@ -49,7 +51,8 @@ PicturePileBase::PicturePileBase(
       background_color_(other->background_color_),
       slow_down_raster_scale_factor_for_debug_(
           other->slow_down_raster_scale_factor_for_debug_),
-      num_raster_threads_(other->num_raster_threads_) {
+      num_raster_threads_(other->num_raster_threads_),
+      shared_picture_playback_(other->shared_picture_playback_) {
   const PictureListMap& other_pic_list_map = other->picture_list_map_;
   for (PictureListMap::const_iterator map_iter = other_pic_list_map.begin();
        map_iter != other_pic_list_map.end(); ++map_iter) {
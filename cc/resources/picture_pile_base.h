@@ -60,6 +60,7 @@ class CC_EXPORT PicturePileBase : public base::RefCounted<PicturePileBase> {
   SkColor background_color_;
   int slow_down_raster_scale_factor_for_debug_;
   int num_raster_threads_;
+  bool shared_picture_playback_;
 
  private:
   void SetBufferPixels(int buffer_pixels);
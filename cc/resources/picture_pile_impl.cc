@@ -52,7 +52,8 @@ PicturePileImpl::PicturePileImpl(const PicturePileBase* other,
                                  bool enable_lcd_text)
     : PicturePileBase(other),
       enable_lcd_text_(enable_lcd_text),
-      clones_for_drawing_(ClonesForDrawing(this, num_raster_threads())) {
+      clones_for_drawing_(ClonesForDrawing(
+          this, shared_picture_playback_ ? 0 : num_raster_threads())) {
 }
 
 PicturePileImpl::PicturePileImpl(
@@ -67,6 +68,9 @@ PicturePileImpl::~PicturePileImpl() {
 
 PicturePileImpl* PicturePileImpl::GetCloneForDrawingOnThread(
     unsigned thread_index) const {
+  // Shared pictures are played back by every raster thread.
+  if (shared_picture_playback_)
+    return const_cast<PicturePileImpl*>(this);
   CHECK_GT(clones_for_drawing_.clones_.size(), thread_index);
   return clones_for_drawing_.clones_[thread_index];
 }
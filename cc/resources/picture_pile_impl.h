@@ -24,7 +24,8 @@ class CC_EXPORT PicturePileImpl : public PicturePileBase {
       const PicturePileBase* other,
       bool enable_lcd_text);
 
-  // Get paint-safe version of this picture for a specific thread.
+  // Get paint-safe version of this picture for a specific thread. With shared
+  // picture playback, this is the pile itself.
   PicturePileImpl* GetCloneForDrawingOnThread(unsigned thread_index) const;
 
   // Raster a subrect of this PicturePileImpl into the given canvas.
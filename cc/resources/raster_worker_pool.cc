@@ -46,11 +46,14 @@ const int kCheckForCompletedTasksDelayMs = 6;
 }  // namespace
 
 RasterWorkerPool::RasterWorkerPool(
-    WorkerPoolClient* client, size_t num_threads) : WorkerPool(
+    WorkerPoolClient* client,
+    size_t num_threads,
+    Scheduler scheduler) : WorkerPool(
         client,
         num_threads,
         base::TimeDelta::FromMilliseconds(kCheckForCompletedTasksDelayMs),
-        kWorkerThreadNamePrefix) {
+        kWorkerThreadNamePrefix,
+        scheduler) {
 }
 
 RasterWorkerPool::~RasterWorkerPool() {
@@ -21,8 +21,9 @@ class RasterWorkerPool : public WorkerPool {
   virtual ~RasterWorkerPool();
 
   static scoped_ptr<RasterWorkerPool> Create(
-      WorkerPoolClient* client, size_t num_threads) {
-    return make_scoped_ptr(new RasterWorkerPool(client, num_threads));
+      WorkerPoolClient* client, size_t num_threads, Scheduler scheduler) {
+    return make_scoped_ptr(new RasterWorkerPool(client, num_threads,
+                                                scheduler));
   }
 
   void PostRasterTaskAndReply(PicturePileImpl* picture_pile,
@@ -31,7 +32,9 @@ class RasterWorkerPool : public WorkerPool {
                               const base::Closure& reply);
 
  private:
-  RasterWorkerPool(WorkerPoolClient* client, size_t num_threads);
+  RasterWorkerPool(WorkerPoolClient* client,
+                   size_t num_threads,
+                   Scheduler scheduler);
 
   DISALLOW_COPY_AND_ASSIGN(RasterWorkerPool);
 };
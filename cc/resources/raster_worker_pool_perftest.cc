@@ -0,0 +1,187 @@
+// Copyright 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cc/resources/raster_worker_pool.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/message_loop.h"
+#include "base/time.h"
+#include "cc/base/region.h"
+#include "cc/debug/rendering_stats.h"
+#include "cc/layers/content_layer_client.h"
+#include "cc/resources/picture_pile.h"
+#include "cc/resources/picture_pile_impl.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkDevice.h"
+#include "third_party/skia/include/core/SkPaint.h"
+#include "ui/gfx/rect.h"
+#include "ui/gfx/rect_f.h"
+
+namespace cc {
+namespace {
+
+static const int kViewportWidth = 1536;
+static const int kViewportHeight = 1024;
+static const int kTileSize = 512;
+static const int kMinRasterBandHeight = 64;
+static const int kNumRuns = 5;
+static const size_t kNumThreads[] = { 1, 2, 4, 8 };
+
+// Paints enough overlapping anti-aliased shapes to make every tile expensive
+// to raster.
+class ExpensiveContentLayerClient : public ContentLayerClient {
+ public:
+  virtual void PaintContents(SkCanvas* canvas,
+                             gfx::Rect clip,
+                             gfx::RectF* opaque) OVERRIDE {
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    canvas->drawColor(SK_ColorWHITE);
+    for (int y = 0; y < kViewportHeight; y += 16) {
+      for (int x = 0; x < kViewportWidth; x += 16) {
+        paint.setColor(SkColorSetARGB(128, x % 255, y % 255, (x + y) % 255));
+        canvas->drawCircle(x, y, 24, paint);
+      }
+    }
+  }
+  virtual void DidChangeLayerCanUseLCDText() OVERRIDE {}
+};
+
+class PerfWorkerPoolClient : public WorkerPoolClient {
+ public:
+  virtual void DidFinishDispatchingWorkerPoolCompletionCallbacks() OVERRIDE {}
+};
+
+void RunRasterTask(uint8* buffer,
+                   int stride,
+                   gfx::Rect rect,
+                   PicturePileImpl* picture_pile) {
+  SkBitmap bitmap;
+  bitmap.setConfig(SkBitmap::kARGB_8888_Config,
+                   rect.width(),
+                   rect.height(),
+                   stride);
+  bitmap.setPixels(buffer);
+  SkDevice device(bitmap);
+  SkCanvas canvas(&device);
+  picture_pile->Raster(&canvas, rect, 1.f);
+}
+
+// Measures the time from posting the raster tasks for every tile in the
+// viewport until the last of them has completed, with each tile rastered
+// by one task or split into bands the way TileManager splits expensive
+// tiles.
+class RasterWorkerPoolPerfTest : public testing::Test {
+ public:
+  RasterWorkerPoolPerfTest() : num_pending_tasks_(0) {
+    gfx::Size viewport(kViewportWidth, kViewportHeight);
+    scoped_refptr<PicturePile> pile(new PicturePile);
+    pile->Resize(viewport);
+    pile->SetMinContentsScale(1.f);
+    pile->set_num_raster_threads(kNumThreads[arraysize(kNumThreads) - 1]);
+    RenderingStats stats;
+    pile->Update(&client_,
+                 SK_ColorWHITE,
+                 Region(gfx::Rect(viewport)),
+                 gfx::Rect(viewport),
+                 NULL,
+                 &stats);
+    picture_pile_ = PicturePileImpl::CreateFromOther(pile, false);
+
+    for (int y = 0; y < kViewportHeight; y += kTileSize) {
+      for (int x = 0; x < kViewportWidth; x += kTileSize)
+        tiles_.push_back(gfx::Rect(x, y, kTileSize, kTileSize));
+    }
+    buffer_.resize(tiles_.size() * kTileSize * stride());
+  }
+
+  void RunTest(const char* name, size_t num_threads, bool split_tiles) {
+    base::TimeDelta best;
+    for (int run = 0; run < kNumRuns; ++run) {
+      scoped_ptr<RasterWorkerPool> raster_worker_pool =
+          RasterWorkerPool::Create(&worker_pool_client_,
+                                   num_threads,
+                                   WorkerPool::SHARED_QUEUE_SCHEDULER);
+
+      base::TimeTicks start_time = base::TimeTicks::HighResNow();
+      for (size_t i = 0; i < tiles_.size(); ++i)
+        PostTile(raster_worker_pool.get(), i, num_threads, split_tiles);
+      message_loop_.Run();
+      base::TimeDelta elapsed = base::TimeTicks::HighResNow() - start_time;
+      if (run == 0 || elapsed < best)
+        best = elapsed;
+    }
+
+    // Format matches chrome/test/perf/perf_test.h:PrintResult
+    printf("*RESULT viewport_raster_%s_%u_threads: time= %.2f ms\n",
+           name,
+           static_cast<unsigned>(num_threads),
+           best.InMillisecondsF());
+  }
+
+  void OnTaskCompleted() {
+    if (!--num_pending_tasks_)
+      message_loop_.Quit();
+  }
+
+ protected:
+  static int stride() {
+    return SkBitmap::ComputeRowBytes(SkBitmap::kARGB_8888_Config, kTileSize);
+  }
+
+  void PostTile(RasterWorkerPool* raster_worker_pool,
+                size_t tile_index,
+                size_t num_threads,
+                bool split_tiles) {
+    const gfx::Rect& rect = tiles_[tile_index];
+    uint8* buffer = &buffer_[tile_index * kTileSize * stride()];
+    int num_bands = 1;
+    if (split_tiles) {
+      num_bands = std::max(
+          std::min(static_cast<int>(num_threads),
+                   rect.height() / kMinRasterBandHeight), 1);
+    }
+
+    for (int i = 0; i < num_bands; ++i) {
+      int top = rect.height() * i / num_bands;
+      int bottom = rect.height() * (i + 1) / num_bands;
+      raster_worker_pool->PostRasterTaskAndReply(
+          picture_pile_,
+          false,
+          base::Bind(&RunRasterTask,
+                     buffer + top * stride(),
+                     stride(),
+                     gfx::Rect(rect.x(), rect.y() + top,
+                               rect.width(), bottom - top)),
+          base::Bind(&RasterWorkerPoolPerfTest::OnTaskCompleted,
+                     base::Unretained(this)));
+      ++num_pending_tasks_;
+    }
+  }
+
+  MessageLoop message_loop_;
+  PerfWorkerPoolClient worker_pool_client_;
+  ExpensiveContentLayerClient client_;
+  scoped_refptr<PicturePileImpl> picture_pile_;
+  std::vector<gfx::Rect> tiles_;
+  std::vector<uint8> buffer_;
+  int num_pending_tasks_;
+};
+
+TEST_F(RasterWorkerPoolPerfTest, WholeTiles) {
+  for (size_t i = 0; i < arraysize(kNumThreads); ++i)
+    RunTest("whole_tiles", kNumThreads[i], false);
+}
+
+TEST_F(RasterWorkerPoolPerfTest, SplitTiles) {
+  for (size_t i = 0; i < arraysize(kNumThreads); ++i)
+    RunTest("split_tiles", kNumThreads[i], true);
+}
+
+}  // namespace
+}  // namespace cc
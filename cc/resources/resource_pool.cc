@@ -27,20 +27,33 @@ ResourcePool::Resource::~Resource() {
   resource_provider_->DeleteResource(id());
 }
 
+ResourcePool::Stats::Stats()
+    : acquired_count(0),
+      reused_count(0),
+      evicted_count(0),
+      unused_bytes(0) {
+}
+
 ResourcePool::ResourcePool(ResourceProvider* resource_provider)
     : resource_provider_(resource_provider),
       max_memory_usage_bytes_(0),
-      memory_usage_bytes_(0) {
+      memory_usage_bytes_(0),
+      request_count_(0) {
 }
 
 ResourcePool::~ResourcePool() {
   SetMaxMemoryUsageBytes(0);
+  DCHECK_EQ(stats_.unused_bytes, 0u);
 }
 
 scoped_ptr<ResourcePool::Resource> ResourcePool::AcquireResource(
     const gfx::Size& size, GLenum format) {
-  for (ResourceList::iterator it = resources_.begin();
-       it != resources_.end(); ++it) {
+  stats_.acquired_count++;
+  FreeList& free_list = free_lists_[ResourceKey(size, format)];
+  free_list.last_request = ++request_count_;
+
+  for (ResourceList::iterator it = free_list.resources.begin();
+       it != free_list.resources.end(); ++it) {
     Resource* resource = *it;
 
     // TODO(epenner): It would be nice to DCHECK that this
@@ -49,12 +62,9 @@ scoped_ptr<ResourcePool::Resource> ResourcePool::AcquireResource(
     if (!resource_provider_->CanLockForWrite(resource->id()))
       continue;
 
-    if (resource->size() != size)
-      continue;
-    if (resource->format() != format)
-      continue;
-
-    resources_.erase(it);
+    free_list.resources.erase(it);
+    stats_.reused_count++;
+    stats_.unused_bytes -= resource->bytes();
     return make_scoped_ptr(resource);
   }
 
@@ -73,23 +83,44 @@ scoped_ptr<ResourcePool::Resource> ResourcePool::AcquireResource(
 
 void ResourcePool::ReleaseResource(
     scoped_ptr<ResourcePool::Resource> resource) {
-  if (memory_usage_bytes_ > max_memory_usage_bytes_) {
-    memory_usage_bytes_ -= resource->bytes();
-    return;
-  }
-
-  resources_.push_back(resource.release());
+  FreeList& free_list =
+      free_lists_[ResourceKey(resource->size(), resource->format())];
+  stats_.unused_bytes += resource->bytes();
+  free_list.resources.push_back(resource.release());
+
+  // The released resource is the last one of its free list to be evicted,
+  // but other sizes and formats may be worth keeping more.
+  EvictUnusedResources();
 }
 
 void ResourcePool::SetMaxMemoryUsageBytes(size_t max_memory_usage_bytes) {
   max_memory_usage_bytes_ = max_memory_usage_bytes;
+  EvictUnusedResources();
+}
 
-  while (!resources_.empty()) {
-    if (memory_usage_bytes_ <= max_memory_usage_bytes_)
+void ResourcePool::EvictUnusedResources() {
+  while (memory_usage_bytes_ > max_memory_usage_bytes_) {
+    // There are only a few sizes and formats of tiles, so the least recently
+    // requested free list is simply searched for. Empty free lists are kept
+    // so that their request recency survives until resources are released
+    // to them again.
+    FreeListMap::iterator lru = free_lists_.end();
+    for (FreeListMap::iterator it = free_lists_.begin();
+         it != free_lists_.end(); ++it) {
+      if (it->second.resources.empty())
+        continue;
+      if (lru == free_lists_.end() ||
+          it->second.last_request < lru->second.last_request)
+        lru = it;
+    }
+    if (lru == free_lists_.end())
       break;
-    Resource* resource = resources_.front();
-    resources_.pop_front();
+
+    Resource* resource = lru->second.resources.front();
+    lru->second.resources.pop_front();
     memory_usage_bytes_ -= resource->bytes();
+    stats_.unused_bytes -= resource->bytes();
+    stats_.evicted_count++;
     delete resource;
   }
 }
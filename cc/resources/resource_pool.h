@@ -6,6 +6,7 @@
 #define CC_RESOURCES_RESOURCE_POOL_H_
 
 #include <list>
+#include <map>
 
 #include "base/memory/scoped_ptr.h"
 #include "cc/base/cc_export.h"
@@ -15,6 +16,10 @@
 namespace cc {
 class ResourceProvider;
 
+// Recycles the resources of tiles. Released resources are kept in free lists
+// by size and format, so acquiring one only looks at the resources that could
+// be reused. When the pool is over its memory budget, the unused resources of
+// the size and format that was requested least recently are deleted first.
 class CC_EXPORT ResourcePool {
  public:
   class CC_EXPORT Resource : public cc::Resource {
@@ -30,6 +35,23 @@ class CC_EXPORT ResourcePool {
     DISALLOW_COPY_AND_ASSIGN(Resource);
   };
 
+  // How well the pool recycles resources, since it was created.
+  struct CC_EXPORT Stats {
+    Stats();
+
+    // The resources handed out by AcquireResource(), and how many of them
+    // were reused from the free lists rather than created.
+    size_t acquired_count;
+    size_t reused_count;
+
+    // The unused resources deleted to stay within the memory budget.
+    size_t evicted_count;
+
+    // The memory of the resources in the free lists, which is allocated but
+    // not used by any tile.
+    size_t unused_bytes;
+  };
+
   static scoped_ptr<ResourcePool> Create(ResourceProvider* resource_provider) {
     return make_scoped_ptr(new ResourcePool(resource_provider));
   }
@@ -44,16 +66,59 @@ class CC_EXPORT ResourcePool {
 
   void SetMaxMemoryUsageBytes(size_t max_memory_usage_bytes);
 
+  const Stats& stats() const { return stats_; }
+
  protected:
   ResourcePool(ResourceProvider* resource_provider);
 
  private:
+  typedef std::list<Resource*> ResourceList;
+
+  // The size and format of the resources of a free list.
+  struct ResourceKey {
+    ResourceKey(const gfx::Size& size, GLenum format)
+        : width(size.width()),
+          height(size.height()),
+          format(format) {
+    }
+
+    bool operator<(const ResourceKey& other) const {
+      if (width != other.width)
+        return width < other.width;
+      if (height != other.height)
+        return height < other.height;
+      return format < other.format;
+    }
+
+    int width;
+    int height;
+    GLenum format;
+  };
+
+  struct FreeList {
+    FreeList() : last_request(0) {}
+
+    // Oldest released first.
+    ResourceList resources;
+
+    // The value of |request_count_| when a resource of this size and format
+    // was last acquired.
+    size_t last_request;
+  };
+  typedef std::map<ResourceKey, FreeList> FreeListMap;
+
+  // Deletes unused resources, least recently requested size and format
+  // first, until the pool is within its memory budget.
+  void EvictUnusedResources();
+
   ResourceProvider* resource_provider_;
   size_t max_memory_usage_bytes_;
   size_t memory_usage_bytes_;
 
-  typedef std::list<Resource*> ResourceList;
-  ResourceList resources_;
+  FreeListMap free_lists_;
+  size_t request_count_;
+
+  Stats stats_;
 
   DISALLOW_COPY_AND_ASSIGN(ResourcePool);
 };
@@ -10,6 +10,7 @@
 #include "base/debug/trace_event.h"
 #include "base/json/json_writer.h"
 #include "base/logging.h"
+#include "base/memory/ref_counted.h"
 #include "base/metrics/histogram.h"
 #include "cc/debug/devtools_instrumentation.h"
 #include "cc/resources/platform_color.h"
@@ -48,6 +49,14 @@ const int kMaxNumPendingTasksPerThread = 40;
 // TODO(skyostil): Determine this limit more dynamically.
 const int kRunCheapTasksTimeMs = 6;
 
+// Tiles predicted to be expensive are split into horizontal bands that are
+// rastered in parallel when they have at least this many pixels. Smaller
+// tiles are not worth the extra tasks.
+const int kMinPixelsForParallelTileRaster = 256 * 256;
+
+// Minimum height of a band when a tile is rastered in parallel.
+const int kMinRasterBandHeight = 64;
+
 // Determine bin based on three categories of tiles: things we need now,
 // things we need soon, and eventually.
 inline TileManagerBin BinFromTilePriority(const TilePriority& prio) {
@@ -146,22 +155,57 @@ scoped_ptr<base::Value> TileRasterStateAsValue(
   }
 }
 
+// Shared by the raster tasks of a tile that is split into bands. The tile's
+// raster has finished when the reply of the last band has run.
+class TileManager::RasterBands
+    : public base::RefCountedThreadSafe<RasterBands> {
+ public:
+  RasterBands(scoped_ptr<ResourcePool::Resource> tile_resource, int num_bands)
+      : resource(tile_resource.Pass()),
+        num_bands_pending(num_bands),
+        durations(num_bands) {
+  }
+
+  scoped_ptr<ResourcePool::Resource> resource;
+  int num_bands_pending;
+
+  // Raster time of each band. Written by the thread that rasters the band
+  // and read on the origin thread once all bands have completed.
+  std::vector<base::TimeDelta> durations;
+
+ private:
+  friend class base::RefCountedThreadSafe<RasterBands>;
+
+  ~RasterBands() {}
+
+  DISALLOW_COPY_AND_ASSIGN(RasterBands);
+};
+
 TileManager::TileManager(
     TileManagerClient* client,
     ResourceProvider* resource_provider,
     size_t num_raster_threads,
+    bool use_work_stealing_raster_scheduler,
+    bool use_parallel_tile_raster,
     bool use_cheapness_estimator,
     bool use_color_estimator,
     bool prediction_benchmarking,
     RenderingStatsInstrumentation* rendering_stats_instrumentation)
     : client_(client),
       resource_pool_(ResourcePool::Create(resource_provider)),
-      raster_worker_pool_(RasterWorkerPool::Create(this, num_raster_threads)),
+      raster_worker_pool_(RasterWorkerPool::Create(
+          this,
+          num_raster_threads,
+          use_work_stealing_raster_scheduler ?
+              WorkerPool::WORK_STEALING_SCHEDULER :
+              WorkerPool::SHARED_QUEUE_SCHEDULER)),
       manage_tiles_pending_(false),
       manage_tiles_call_count_(0),
       bytes_pending_upload_(0),
       has_performed_uploads_since_last_flush_(false),
       ever_exceeded_memory_budget_(false),
+      num_raster_threads_(num_raster_threads),
+      use_parallel_tile_raster_(use_parallel_tile_raster),
       use_cheapness_estimator_(use_cheapness_estimator),
       use_color_estimator_(use_color_estimator),
       prediction_benchmarking_(prediction_benchmarking),
@@ -441,7 +485,11 @@ void TileManager::ForceTileUploadToComplete(Tile* tile) {
 void TileManager::GetMemoryStats(
     size_t* memory_required_bytes,
     size_t* memory_nice_to_have_bytes,
-    size_t* memory_used_bytes) const {
+    size_t* memory_used_bytes,
+    ResourcePool::Stats* resource_pool_stats) const {
+  if (resource_pool_stats)
+    *resource_pool_stats = resource_pool_->stats();
+
   *memory_required_bytes = 0;
   *memory_nice_to_have_bytes = 0;
   *memory_used_bytes = 0;
@@ -486,13 +534,23 @@ scoped_ptr<base::Value> TileManager::GetMemoryRequirementsAsValue() const {
   size_t memory_required_bytes;
   size_t memory_nice_to_have_bytes;
   size_t memory_used_bytes;
+  ResourcePool::Stats resource_pool_stats;
   GetMemoryStats(&memory_required_bytes,
                  &memory_nice_to_have_bytes,
-                 &memory_used_bytes);
+                 &memory_used_bytes,
+                 &resource_pool_stats);
   requirements->SetInteger("memory_required_bytes", memory_required_bytes);
   requirements->SetInteger("memory_nice_to_have_bytes",
                            memory_nice_to_have_bytes);
   requirements->SetInteger("memory_used_bytes", memory_used_bytes);
+  requirements->SetInteger("resource_pool_acquired_count",
+                           resource_pool_stats.acquired_count);
+  requirements->SetInteger("resource_pool_reused_count",
+                           resource_pool_stats.reused_count);
+  requirements->SetInteger("resource_pool_evicted_count",
+                           resource_pool_stats.evicted_count);
+  requirements->SetInteger("resource_pool_unused_bytes",
+                           resource_pool_stats.unused_bytes);
   return requirements.PassAs<base::Value>();
 }
 
@@ -836,6 +894,12 @@ void TileManager::DispatchOneRasterTask(scoped_refptr<Tile> tile) {
   uint8* buffer =
       resource_pool_->resource_provider()->MapPixelBuffer(resource_id);
 
+  int num_bands = NumRasterBandsForTile(*tile);
+  if (num_bands > 1) {
+    DispatchRasterBandTasks(tile, resource.Pass(), buffer, num_bands);
+    return;
+  }
+
   ManagedTileState& managed_tile_state = tile->managed_state();
   raster_worker_pool_->PostRasterTaskAndReply(
       tile->picture_pile(),
@@ -854,6 +918,69 @@ void TileManager::DispatchOneRasterTask(scoped_refptr<Tile> tile) {
   pending_tasks_++;
 }
 
+int TileManager::NumRasterBandsForTile(const Tile& tile) const {
+  if (!use_parallel_tile_raster_ || num_raster_threads_ < 2)
+    return 1;
+
+  // Only split tiles that the cheapness estimator predicts are expensive.
+  // Cheap tiles finish quickly on one thread and may even run on the
+  // origin thread.
+  const ManagedTileState& mts = tile.managed_state();
+  if (!use_cheapness_estimator_ ||
+      !mts.picture_pile_analyzed ||
+      mts.picture_pile_analysis.is_cheap_to_raster)
+    return 1;
+
+  gfx::Rect rect = tile.content_rect();
+  if (rect.width() * rect.height() < kMinPixelsForParallelTileRaster)
+    return 1;
+
+  int num_bands = std::min(static_cast<int>(num_raster_threads_),
+                           rect.height() / kMinRasterBandHeight);
+  return std::max(num_bands, 1);
+}
+
+void TileManager::DispatchRasterBandTasks(
+    scoped_refptr<Tile> tile,
+    scoped_ptr<ResourcePool::Resource> resource,
+    uint8* buffer,
+    int num_bands) {
+  TRACE_EVENT1("cc", "TileManager::DispatchRasterBandTasks",
+               "num_bands", num_bands);
+  scoped_refptr<RasterBands> bands(new RasterBands(resource.Pass(),
+                                                   num_bands));
+  gfx::Rect rect = tile->content_rect();
+  int stride = SkBitmap::ComputeRowBytes(SkBitmap::kARGB_8888_Config,
+                                         rect.width());
+  RasterTaskMetadata metadata = GetRasterTaskMetadata(*tile);
+
+  // Each band is a separate task, so the worker pool runs the bands on
+  // different threads, each with its own clone of the picture pile unless
+  // picture playback is shared.
+  for (int i = 0; i < num_bands; ++i) {
+    int top = rect.height() * i / num_bands;
+    int bottom = rect.height() * (i + 1) / num_bands;
+    gfx::Rect band_rect(rect.x(), rect.y() + top, rect.width(), bottom - top);
+    raster_worker_pool_->PostRasterTaskAndReply(
+        tile->picture_pile(),
+        false,
+        base::Bind(&TileManager::RunRasterBandTask,
+                   buffer + top * stride,
+                   stride,
+                   band_rect,
+                   tile->contents_scale(),
+                   metadata,
+                   rendering_stats_instrumentation_,
+                   &bands->durations[i]),
+        base::Bind(&TileManager::OnRasterBandTaskCompleted,
+                   base::Unretained(this),
+                   tile,
+                   bands,
+                   manage_tiles_call_count_));
+    pending_tasks_++;
+  }
+}
+
 TileManager::RasterTaskMetadata TileManager::GetRasterTaskMetadata(
     const Tile& tile) const {
   RasterTaskMetadata metadata;
@@ -917,6 +1044,34 @@ void TileManager::OnRasterTaskCompleted(
   }
 }
 
+void TileManager::OnRasterBandTaskCompleted(
+    scoped_refptr<Tile> tile,
+    scoped_refptr<RasterBands> bands,
+    int manage_tiles_call_count_when_dispatched) {
+  TRACE_EVENT0("cc", "TileManager::OnRasterBandTaskCompleted");
+  DCHECK_GT(bands->num_bands_pending, 0);
+
+  // OnRasterTaskCompleted() accounts for the last band's pending task.
+  if (--bands->num_bands_pending) {
+    pending_tasks_--;
+    return;
+  }
+
+  if (prediction_benchmarking_ &&
+      rendering_stats_instrumentation_->record_rendering_stats()) {
+    base::TimeDelta duration;
+    for (size_t i = 0; i < bands->durations.size(); ++i)
+      duration += bands->durations[i];
+    // The tile was only split because it was predicted to be expensive.
+    RecordCheapnessPredictorResults(false,
+                                    duration.InMillisecondsF() <= 1.0f);
+  }
+
+  OnRasterTaskCompleted(tile,
+                        bands->resource.Pass(),
+                        manage_tiles_call_count_when_dispatched);
+}
+
 void TileManager::DidFinishTileInitialization(Tile* tile) {
   tile->drawing_info().resource_is_being_initialized_ = false;
   if (tile->priority(ACTIVE_TREE).distance_to_visible_in_pixels == 0)
@@ -1017,6 +1172,51 @@ void TileManager::RunRasterTask(
   }
 }
 
+// static
+void TileManager::RunRasterBandTask(
+    uint8* buffer,
+    int stride,
+    const gfx::Rect& band_rect,
+    float contents_scale,
+    const RasterTaskMetadata& metadata,
+    RenderingStatsInstrumentation* stats_instrumentation,
+    base::TimeDelta* duration,
+    PicturePileImpl* picture_pile) {
+  TRACE_EVENT2(
+      "cc", "TileManager::RunRasterBandTask",
+      "is_on_pending_tree",
+      metadata.is_tile_in_pending_tree_now_bin,
+      "is_low_res",
+      metadata.tile_resolution == LOW_RESOLUTION);
+  devtools_instrumentation::ScopedRasterTask raster_task(metadata.layer_id);
+
+  DCHECK(picture_pile);
+  DCHECK(buffer);
+
+  // |buffer| points at the first row of the band inside the tile's pixels.
+  SkBitmap bitmap;
+  bitmap.setConfig(SkBitmap::kARGB_8888_Config,
+                   band_rect.width(),
+                   band_rect.height(),
+                   stride);
+  bitmap.setPixels(buffer);
+  SkDevice device(bitmap);
+  SkCanvas canvas(&device);
+
+  base::TimeTicks start_time = stats_instrumentation->StartRecording();
+
+  int64 total_pixels_rasterized =
+      picture_pile->Raster(&canvas, band_rect, contents_scale);
+
+  *duration = stats_instrumentation->EndRecording(start_time);
+
+  if (stats_instrumentation->record_rendering_stats()) {
+    stats_instrumentation->AddRaster(*duration,
+                                     total_pixels_rasterized,
+                                     metadata.is_tile_in_pending_tree_now_bin);
+  }
+}
+
 // static
 void TileManager::RecordCheapnessPredictorResults(bool is_predicted_cheap,
                                                   bool is_actually_cheap) {
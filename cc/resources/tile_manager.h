@@ -76,6 +76,8 @@ class CC_EXPORT TileManager : public WorkerPoolClient {
   TileManager(TileManagerClient* client,
               ResourceProvider *resource_provider,
               size_t num_raster_threads,
+              bool use_work_stealing_raster_scheduler,
+              bool use_parallel_tile_raster,
               bool use_cheapess_estimator,
               bool use_color_estimator,
               bool prediction_benchmarking,
@@ -95,9 +97,11 @@ class CC_EXPORT TileManager : public WorkerPoolClient {
 
   scoped_ptr<base::Value> BasicStateAsValue() const;
   scoped_ptr<base::Value> AllTilesAsValue() const;
+  // |resource_pool_stats| may be NULL.
   void GetMemoryStats(size_t* memory_required_bytes,
                       size_t* memory_nice_to_have_bytes,
-                      size_t* memory_used_bytes) const;
+                      size_t* memory_used_bytes,
+                      ResourcePool::Stats* resource_pool_stats) const;
   bool HasPendingWorkScheduled(WhichTree tree) const;
 
   const MemoryHistory::Entry& memory_stats_from_last_assign() const {
@@ -120,6 +124,7 @@ class CC_EXPORT TileManager : public WorkerPoolClient {
   }
 
  private:
+  class RasterBands;
 
   // Data that is passed to raster tasks.
   struct RasterTaskMetadata {
@@ -153,10 +158,19 @@ class CC_EXPORT TileManager : public WorkerPoolClient {
   bool CanDispatchRasterTask(Tile* tile) const;
   scoped_ptr<ResourcePool::Resource> PrepareTileForRaster(Tile* tile);
   void DispatchOneRasterTask(scoped_refptr<Tile> tile);
+  int NumRasterBandsForTile(const Tile& tile) const;
+  void DispatchRasterBandTasks(scoped_refptr<Tile> tile,
+                               scoped_ptr<ResourcePool::Resource> resource,
+                               uint8* buffer,
+                               int num_bands);
   void OnRasterTaskCompleted(
       scoped_refptr<Tile> tile,
       scoped_ptr<ResourcePool::Resource> resource,
       int manage_tiles_call_count_when_dispatched);
+  void OnRasterBandTaskCompleted(
+      scoped_refptr<Tile> tile,
+      scoped_refptr<RasterBands> bands,
+      int manage_tiles_call_count_when_dispatched);
   void DidFinishTileInitialization(Tile* tile);
   void DidTileRasterStateChange(Tile* tile, TileRasterState state);
   void DidTileTreeBinChange(Tile* tile,
@@ -171,6 +185,15 @@ class CC_EXPORT TileManager : public WorkerPoolClient {
       const RasterTaskMetadata& metadata,
       RenderingStatsInstrumentation* stats_instrumentation,
       PicturePileImpl* picture_pile);
+  static void RunRasterBandTask(
+      uint8* buffer,
+      int stride,
+      const gfx::Rect& band_rect,
+      float contents_scale,
+      const RasterTaskMetadata& metadata,
+      RenderingStatsInstrumentation* stats_instrumentation,
+      base::TimeDelta* duration,
+      PicturePileImpl* picture_pile);
   static void RunImageDecodeTask(
       skia::LazyPixelRef* pixel_ref,
       RenderingStatsInstrumentation* stats_instrumentation);
@@ -214,6 +237,8 @@ class CC_EXPORT TileManager : public WorkerPoolClient {
 
   RenderingStatsInstrumentation* rendering_stats_instrumentation_;
 
+  size_t num_raster_threads_;
+  bool use_parallel_tile_raster_;
   bool use_cheapness_estimator_;
   bool use_color_estimator_;
   int raster_state_count_[NUM_STATES][NUM_TREES][NUM_BINS];
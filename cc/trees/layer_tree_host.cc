@@ -37,6 +37,12 @@
 
 namespace {
 static int s_num_layer_tree_instances;
+
+const char kRecordingThreadNamePrefix[] = "CompositorRecording";
+
+// Picture layers wait for their recording tasks themselves, and the replies
+// do nothing, so completed tasks are only collected now and then.
+const int kCheckForCompletedRecordingTasksDelayMs = 100;
 }
 
 namespace cc {
@@ -128,6 +134,8 @@ LayerTreeHost::~LayerTreeHost() {
   DCHECK(proxy_->IsMainThread());
   TRACE_EVENT0("cc", "LayerTreeHost::~LayerTreeHost");
   proxy_->Stop();
+  // Wait for the recording threads before the layers they record go away.
+  recording_worker_pool_.reset();
   s_num_layer_tree_instances--;
   RateLimiterMap::iterator it = rate_limiters_.begin();
   if (it != rate_limiters_.end())
@@ -286,7 +294,10 @@ void LayerTreeHost::FinishCommitOnImplThread(LayerTreeHostImpl* host_impl) {
     sync_tree->SetRootLayer(TreeSynchronizer::SynchronizeTrees(
         root_layer(), sync_tree->DetachLayerTree(), sync_tree)); {
     TRACE_EVENT0("cc", "LayerTreeHost::PushProperties");
-    TreeSynchronizer::PushProperties(root_layer(), sync_tree->root_layer());
+    size_t num_layers_pushed =
+        TreeSynchronizer::PushProperties(root_layer(), sync_tree->root_layer());
+    TRACE_COUNTER_ID1("cc", "LayersPushed", this, num_layers_pushed);
+    rendering_stats_instrumentation_->AddLayersPushed(num_layers_pushed);
   }
 
   sync_tree->set_needs_full_tree_sync(needs_full_tree_sync_);
@@ -950,6 +961,18 @@ void LayerTreeHost::RateLimit() {
   proxy_->ForceSerializeOnSwapBuffers();
 }
 
+WorkerPool* LayerTreeHost::recording_worker_pool() {
+  if (!recording_worker_pool_ && settings_.num_recording_threads) {
+    recording_worker_pool_ = WorkerPool::Create(
+        this,
+        settings_.num_recording_threads,
+        base::TimeDelta::FromMilliseconds(
+            kCheckForCompletedRecordingTasksDelayMs),
+        kRecordingThreadNamePrefix);
+  }
+  return recording_worker_pool_.get();
+}
+
 bool LayerTreeHost::RequestPartialTextureUpdate() {
   if (partial_texture_update_requests_ >= settings_.max_partial_texture_updates)
     return false;
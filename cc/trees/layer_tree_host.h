@@ -17,6 +17,7 @@
 #include "cc/animation/animation_events.h"
 #include "cc/base/cc_export.h"
 #include "cc/base/scoped_ptr_vector.h"
+#include "cc/base/worker_pool.h"
 #include "cc/scheduler/rate_limiter.h"
 #include "cc/trees/layer_tree_host_client.h"
 #include "cc/trees/layer_tree_host_common.h"
@@ -76,7 +77,8 @@ struct CC_EXPORT RendererCapabilities {
   bool avoid_pow2_textures;
 };
 
-class CC_EXPORT LayerTreeHost : public RateLimiterClient {
+class CC_EXPORT LayerTreeHost : public RateLimiterClient,
+                                 public WorkerPoolClient {
  public:
   static scoped_ptr<LayerTreeHost> Create(LayerTreeHostClient* client,
                                           const LayerTreeSettings& settings,
@@ -213,6 +215,13 @@ class CC_EXPORT LayerTreeHost : public RateLimiterClient {
   // RateLimiterClient implementation.
   virtual void RateLimit() OVERRIDE;
 
+  // WorkerPoolClient implementation.
+  virtual void DidFinishDispatchingWorkerPoolCompletionCallbacks() OVERRIDE {}
+
+  // Returns the pool that picture layers record on when their client can
+  // paint concurrently, or NULL if settings().num_recording_threads is 0.
+  WorkerPool* recording_worker_pool();
+
   bool buffered_updates() const {
     return settings_.max_partial_texture_updates !=
         std::numeric_limits<size_t>::max();
@@ -325,6 +334,9 @@ class CC_EXPORT LayerTreeHost : public RateLimiterClient {
 
   scoped_ptr<AnimationRegistrar> animation_registrar_;
 
+  // Created on first use.
+  scoped_ptr<WorkerPool> recording_worker_pool_;
+
   DISALLOW_COPY_AND_ASSIGN(LayerTreeHost);
 };
 
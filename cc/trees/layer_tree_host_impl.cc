@@ -282,9 +282,17 @@ void LayerTreeHostImpl::ManageTiles() {
   size_t memory_required_bytes;
   size_t memory_nice_to_have_bytes;
   size_t memory_used_bytes;
+  ResourcePool::Stats resource_pool_stats;
   tile_manager_->GetMemoryStats(&memory_required_bytes,
                                 &memory_nice_to_have_bytes,
-                                &memory_used_bytes);
+                                &memory_used_bytes,
+                                &resource_pool_stats);
+  TRACE_COUNTER_ID2("cc", "ResourcePool", this,
+                    "reused_percent",
+                    resource_pool_stats.acquired_count ?
+                        100 * resource_pool_stats.reused_count /
+                            resource_pool_stats.acquired_count : 0,
+                    "unused_bytes", resource_pool_stats.unused_bytes);
   SendManagedMemoryStats(memory_required_bytes,
                          memory_nice_to_have_bytes,
                          memory_used_bytes);
@@ -1259,13 +1267,16 @@ bool LayerTreeHostImpl::InitializeRenderer(
     return false;
 
   if (settings_.impl_side_painting) {
-    tile_manager_.reset(new TileManager(this,
-                                        resource_provider.get(),
-                                        settings_.num_raster_threads,
-                                        settings_.use_cheapness_estimator,
-                                        settings_.use_color_estimator,
-                                        settings_.prediction_benchmarking,
-                                        rendering_stats_instrumentation_));
+    tile_manager_.reset(
+        new TileManager(this,
+                        resource_provider.get(),
+                        settings_.num_raster_threads,
+                        settings_.work_stealing_raster_scheduler,
+                        settings_.parallel_tile_raster,
+                        settings_.use_cheapness_estimator,
+                        settings_.use_color_estimator,
+                        settings_.prediction_benchmarking,
+                        rendering_stats_instrumentation_));
   }
 
   if (output_surface->capabilities().has_parent_compositor) {
@@ -9,12 +9,18 @@
 #include "base/path_service.h"
 #include "base/string_piece.h"
 #include "cc/layers/content_layer.h"
+#include "cc/layers/content_layer_client.h"
 #include "cc/layers/nine_patch_layer.h"
+#include "cc/layers/picture_layer.h"
 #include "cc/layers/solid_color_layer.h"
 #include "cc/test/fake_content_layer_client.h"
 #include "cc/test/layer_tree_json_parser.h"
 #include "cc/test/layer_tree_test.h"
 #include "cc/test/paths.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkPaint.h"
+#include "ui/gfx/rect.h"
+#include "ui/gfx/rect_f.h"
 
 namespace cc {
 namespace {
@@ -129,5 +135,105 @@ TEST_F(ScrollingLayerTreePerfTest, LongScrollablePage) {
   RunTest(false);
 }
 
+static const int kPageWidth = 1536;
+static const int kPageHeight = 12288;
+static const int kViewportHeight = 1024;
+static const int kNumMeasuredCommits = 20;
+
+// Paints a page of overlapping anti-aliased shapes, drawing only into the
+// canvas it is given, so it can paint on several threads at once.
+class ConcurrentContentLayerClient : public ContentLayerClient {
+ public:
+  virtual void PaintContents(SkCanvas* canvas,
+                             gfx::Rect clip,
+                             gfx::RectF* opaque) OVERRIDE {
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    canvas->drawColor(SK_ColorWHITE);
+    for (int y = clip.y() - clip.y() % 16; y < clip.bottom(); y += 16) {
+      for (int x = clip.x() - clip.x() % 16; x < clip.right(); x += 16) {
+        paint.setColor(SkColorSetARGB(128, x % 255, y % 255, (x + y) % 255));
+        canvas->drawCircle(x, y, 24, paint);
+      }
+    }
+    *opaque = gfx::RectF(clip);
+  }
+  virtual void DidChangeLayerCanUseLCDText() OVERRIDE {}
+  virtual bool CanPaintConcurrently() const OVERRIDE { return true; }
+};
+
+// Invalidates a whole long page on every frame, like a resize or a theme
+// change does, and measures the time from the start of the main thread
+// frame until its commit has completed. Each commit has to record all the
+// pictures of the page first.
+class FullInvalidationPerfTest : public LayerTreeTest {
+ public:
+  FullInvalidationPerfTest()
+      : num_recording_threads_(0),
+        num_commits_(0) {
+  }
+
+  void RunWithRecordingThreads(const std::string& name,
+                               size_t num_recording_threads) {
+    test_name_ = name;
+    num_recording_threads_ = num_recording_threads;
+    RunTest(true);
+  }
+
+  virtual void InitializeSettings(LayerTreeSettings* settings) OVERRIDE {
+    settings->impl_side_painting = true;
+    settings->num_recording_threads = num_recording_threads_;
+  }
+
+  virtual void BeginTest() OVERRIDE {
+    gfx::Size viewport(kPageWidth, kViewportHeight);
+    layer_tree_host()->SetViewportSize(viewport, viewport);
+    layer_ = PictureLayer::Create(&client_);
+    layer_->SetBounds(gfx::Size(kPageWidth, kPageHeight));
+    layer_->SetIsDrawable(true);
+    layer_tree_host()->SetRootLayer(layer_);
+    PostSetNeedsCommitToMainThread();
+  }
+
+  virtual void Layout() OVERRIDE {
+    frame_start_time_ = base::TimeTicks::HighResNow();
+  }
+
+  virtual void DidCommit() OVERRIDE {
+    ++num_commits_;
+    if (num_commits_ > kWarmupRuns)
+      commit_latency_ += base::TimeTicks::HighResNow() - frame_start_time_;
+    if (num_commits_ == kWarmupRuns + kNumMeasuredCommits) {
+      EndTest();
+      return;
+    }
+    layer_->SetNeedsDisplay();
+  }
+
+  virtual void AfterTest() OVERRIDE {
+    // Format matches chrome/test/perf/perf_test.h:PrintResult
+    printf("*RESULT %s: commit_latency= %.2f ms\n",
+           test_name_.c_str(),
+           commit_latency_.InMillisecondsF() / kNumMeasuredCommits);
+  }
+
+ private:
+  std::string test_name_;
+  size_t num_recording_threads_;
+  int num_commits_;
+  base::TimeTicks frame_start_time_;
+  base::TimeDelta commit_latency_;
+  ConcurrentContentLayerClient client_;
+  scoped_refptr<PictureLayer> layer_;
+};
+
+TEST_F(FullInvalidationPerfTest, SerialRecording) {
+  RunWithRecordingThreads("full_invalidation_serial_recording", 0);
+}
+
+TEST_F(FullInvalidationPerfTest, FourRecordingThreads) {
+  RunWithRecordingThreads("full_invalidation_4_recording_threads", 4);
+}
+
 }  // namespace
 }  // namespace cc
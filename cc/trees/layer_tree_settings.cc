@@ -43,6 +43,10 @@ LayerTreeSettings::LayerTreeSettings()
       refresh_rate(0.0),
       max_partial_texture_updates(std::numeric_limits<size_t>::max()),
       num_raster_threads(1),
+      work_stealing_raster_scheduler(false),
+      parallel_tile_raster(false),
+      shared_picture_playback(false),
+      num_recording_threads(0),
       default_tile_size(gfx::Size(256, 256)),
       max_untiled_layer_size(gfx::Size(512, 512)),
       minimum_occlusion_tracking_size(gfx::Size(160, 160)),
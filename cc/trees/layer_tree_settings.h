@@ -48,6 +48,10 @@ class CC_EXPORT LayerTreeSettings {
   double refresh_rate;
   size_t max_partial_texture_updates;
   size_t num_raster_threads;
+  bool work_stealing_raster_scheduler;
+  bool parallel_tile_raster;
+  bool shared_picture_playback;
+  size_t num_recording_threads;
   gfx::Size default_tile_size;
   gfx::Size max_untiled_layer_size;
   gfx::Size minimum_occlusion_tracking_size;
@@ -91,7 +91,7 @@ bool ThreadProxy::CompositeAndReadback(void* pixels, gfx::Rect rect) {
         base::Bind(&ThreadProxy::ForceBeginFrameOnImplThread,
                    impl_thread_weak_ptr_,
                    &begin_frame_completion));
-    begin_frame_completion.Wait();
+    WaitForImplThread(&begin_frame_completion);
   }
   in_composite_and_readback_ = true;
   BeginFrame(scoped_ptr<BeginFrameAndCommitState>());
@@ -107,7 +107,7 @@ bool ThreadProxy::CompositeAndReadback(void* pixels, gfx::Rect rect) {
         base::Bind(&ThreadProxy::RequestReadbackOnImplThread,
                    impl_thread_weak_ptr_,
                    &request));
-    request.completion.Wait();
+    WaitForImplThread(&request.completion);
   }
   return request.success;
 }
@@ -163,7 +163,7 @@ void ThreadProxy::FinishAllRendering() {
       base::Bind(&ThreadProxy::FinishAllRenderingOnImplThread,
                  impl_thread_weak_ptr_,
                  &completion));
-  completion.Wait();
+  WaitForImplThread(&completion);
 }
 
 bool ThreadProxy::IsStarted() const {
@@ -197,21 +197,18 @@ void ThreadProxy::SetSurfaceReadyOnImplThread() {
 
 void ThreadProxy::SetVisible(bool visible) {
   TRACE_EVENT0("cc", "ThreadProxy::SetVisible");
-  DebugScopedSetMainThreadBlocked main_thread_blocked(this);
-  CompletionEvent completion;
+  // The impl thread does not read any main thread state to change its
+  // visibility, and later requests are posted after this one, so there is no
+  // need to wait for it.
   Proxy::ImplThread()->PostTask(base::Bind(&ThreadProxy::SetVisibleOnImplThread,
                                            impl_thread_weak_ptr_,
-                                           &completion,
                                            visible));
-  completion.Wait();
 }
 
-void ThreadProxy::SetVisibleOnImplThread(CompletionEvent* completion,
-                                         bool visible) {
+void ThreadProxy::SetVisibleOnImplThread(bool visible) {
   TRACE_EVENT0("cc", "ThreadProxy::SetVisibleOnImplThread");
   layer_tree_host_impl_->SetVisible(visible);
   scheduler_on_impl_thread_->SetVisible(visible);
-  completion->Signal();
 }
 
 bool ThreadProxy::InitializeRenderer() {
@@ -229,7 +226,7 @@ bool ThreadProxy::InitializeRenderer() {
                  &completion,
                  &initialize_succeeded,
                  &capabilities));
-  completion.Wait();
+  WaitForImplThread(&completion);
 
   if (initialize_succeeded) {
     renderer_initialized_ = true;
@@ -270,7 +267,7 @@ bool ThreadProxy::RecreateOutputSurface() {
                  offscreen_context_provider,
                  &recreate_succeeded,
                  &capabilities));
-  completion.Wait();
+  WaitForImplThread(&completion);
 
   if (recreate_succeeded)
     renderer_capabilities_main_thread_copy_ = capabilities;
@@ -526,7 +523,7 @@ void ThreadProxy::Start() {
                  base::Unretained(this),
                  &completion,
                  handler.release()));
-  completion.Wait();
+  WaitForImplThread(&completion);
 
   main_thread_weak_ptr_ = weak_factory_.GetWeakPtr();
 
@@ -547,7 +544,7 @@ void ThreadProxy::Stop() {
         base::Bind(&ThreadProxy::LayerTreeHostClosedOnImplThread,
                    impl_thread_weak_ptr_,
                    &completion));
-    completion.Wait();
+    WaitForImplThread(&completion);
   }
 
   weak_factory_.InvalidateWeakPtrs();
@@ -564,7 +561,7 @@ void ThreadProxy::ForceSerializeOnSwapBuffers() {
       base::Bind(&ThreadProxy::ForceSerializeOnSwapBuffersOnImplThread,
                  impl_thread_weak_ptr_,
                  &completion));
-  completion.Wait();
+  WaitForImplThread(&completion);
 }
 
 void ThreadProxy::ForceSerializeOnSwapBuffersOnImplThread(
@@ -725,10 +722,6 @@ void ThreadProxy::BeginFrame(
 
     DebugScopedSetMainThreadBlocked main_thread_blocked(this);
 
-    RenderingStatsInstrumentation* stats_instrumentation =
-        layer_tree_host_->rendering_stats_instrumentation();
-    base::TimeTicks start_time = stats_instrumentation->StartRecording();
-
     CompletionEvent completion;
     Proxy::ImplThread()->PostTask(
         base::Bind(&ThreadProxy::BeginFrameCompleteOnImplThread,
@@ -736,10 +729,9 @@ void ThreadProxy::BeginFrame(
                    &completion,
                    queue.release(),
                    offscreen_context_provider));
-    completion.Wait();
+    base::TimeDelta duration = WaitForImplThread(&completion);
 
-    base::TimeDelta duration = stats_instrumentation->EndRecording(start_time);
-    stats_instrumentation->AddCommit(duration);
+    layer_tree_host_->rendering_stats_instrumentation()->AddCommit(duration);
   }
 
   layer_tree_host_->CommitComplete();
@@ -816,12 +808,18 @@ void ThreadProxy::ScheduledActionCommit() {
   layer_tree_host_impl_->BeginCommit();
   layer_tree_host_->BeginCommitOnImplThread(layer_tree_host_impl_.get());
   layer_tree_host_->FinishCommitOnImplThread(layer_tree_host_impl_.get());
-  layer_tree_host_impl_->CommitComplete();
+
+  // With impl-side painting the pending tree now holds everything it needs
+  // from the main thread, so the main thread is released before the pending
+  // tree's draw properties and tile priorities are updated. Otherwise
+  // CommitComplete() reads the main thread's contents texture manager.
+  bool impl_side_painting = layer_tree_host_->settings().impl_side_painting;
+  if (!impl_side_painting)
+    layer_tree_host_impl_->CommitComplete();
 
   next_frame_is_newly_committed_frame_on_impl_thread_ = true;
 
-  if (layer_tree_host_->settings().impl_side_painting &&
-      layer_tree_host_->BlocksPendingCommit()) {
+  if (impl_side_painting && layer_tree_host_->BlocksPendingCommit()) {
     // For some layer types in impl-side painting, the commit is held until
     // the pending tree is activated.
     TRACE_EVENT_INSTANT0("cc", "HoldCommit", TRACE_EVENT_SCOPE_THREAD);
@@ -833,6 +831,9 @@ void ThreadProxy::ScheduledActionCommit() {
     commit_completion_event_on_impl_thread_ = NULL;
   }
 
+  if (impl_side_painting)
+    layer_tree_host_impl_->CommitComplete();
+
   // SetVisible kicks off the next scheduler action, so this must be last.
   scheduler_on_impl_thread_->SetVisible(layer_tree_host_impl_->visible());
 }
@@ -969,7 +970,7 @@ void ThreadProxy::AcquireLayerTextures() {
                  impl_thread_weak_ptr_,
                  &completion));
   // Block until it is safe to write to layer textures from the main thread.
-  completion.Wait();
+  WaitForImplThread(&completion);
 
   textures_acquired_ = true;
 }
@@ -1044,6 +1045,20 @@ void ThreadProxy::BeginContextRecreation() {
   Proxy::MainThread()->PostTask(output_surface_recreation_callback_.callback());
 }
 
+base::TimeDelta ThreadProxy::WaitForImplThread(CompletionEvent* completion) {
+  DCHECK(IsMainThread());
+  DCHECK(IsMainThreadBlocked());
+  RenderingStatsInstrumentation* stats_instrumentation =
+      layer_tree_host_->rendering_stats_instrumentation();
+  base::TimeTicks start_time = stats_instrumentation->StartRecording();
+
+  completion->Wait();
+
+  base::TimeDelta duration = stats_instrumentation->EndRecording(start_time);
+  stats_instrumentation->AddMainThreadBlocked(duration);
+  return duration;
+}
+
 void ThreadProxy::TryToRecreateOutputSurface() {
   DCHECK(IsMainThread());
   DCHECK(layer_tree_host_);
@@ -1233,7 +1248,7 @@ skia::RefPtr<SkPicture> ThreadProxy::CapturePicture() {
                    impl_thread_weak_ptr_,
                    &completion,
                    &picture));
-    completion.Wait();
+    WaitForImplThread(&completion);
   }
   return picture;
 }
@@ -129,6 +129,12 @@ class ThreadProxy : public Proxy,
                           base::Time wall_clock_time);
   void BeginContextRecreation();
   void TryToRecreateOutputSurface();
+  // Waits for |completion| to be signaled on the impl thread, and adds the
+  // wait to the main thread blocked time in RenderingStats. Returns the time
+  // waited when rendering stats are recorded. Used for every blocking call
+  // to the impl thread except the debugging and testing helpers AsValue()
+  // and CommitPendingForTesting().
+  base::TimeDelta WaitForImplThread(CompletionEvent* completion);
 
   // Called on impl thread.
   struct ReadbackRequest {
@@ -156,7 +162,7 @@ class ThreadProxy : public Proxy,
   void InitializeImplOnImplThread(CompletionEvent* completion,
                                   InputHandler* input_handler);
   void SetSurfaceReadyOnImplThread();
-  void SetVisibleOnImplThread(CompletionEvent* completion, bool visible);
+  void SetVisibleOnImplThread(bool visible);
   void InitializeOutputSurfaceOnImplThread(
       scoped_ptr<OutputSurface> output_surface);
   void InitializeRendererOnImplThread(CompletionEvent* completion,
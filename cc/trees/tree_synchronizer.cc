@@ -86,6 +86,14 @@ scoped_ptr<LayerImpl> ReuseOrCreateLayerImpl(RawPtrLayerImplMap* new_layers,
   return layer_impl.Pass();
 }
 
+// A structural sync may create or reuse any LayerImpl, so every Layer pushes
+// its properties after one.
+void SetNeedsPushPropertiesAfterSync(Layer* layer) {
+  layer->SetNeedsPushProperties();
+}
+
+void SetNeedsPushPropertiesAfterSync(LayerImpl* layer) {}
+
 template <typename LayerType>
 scoped_ptr<LayerImpl> SynchronizeTreesRecursiveInternal(
     RawPtrLayerImplMap* new_layers,
@@ -97,6 +105,7 @@ scoped_ptr<LayerImpl> SynchronizeTreesRecursiveInternal(
 
   scoped_ptr<LayerImpl> layer_impl =
       ReuseOrCreateLayerImpl(new_layers, old_layers, layer, tree_impl);
+  SetNeedsPushPropertiesAfterSync(layer);
 
   layer_impl->ClearChildList();
   for (size_t i = 0; i < layer->children().size(); ++i) {
@@ -185,8 +194,9 @@ void UpdateScrollbarLayerPointersRecursive(const RawPtrLayerImplMap* new_layers,
       new_layers, layer);
 }
 
-template <typename LayerType>
-void PushPropertiesInternal(LayerType* layer, LayerImpl* layer_impl) {
+void PushPropertiesInternal(LayerImpl* layer,
+                            LayerImpl* layer_impl,
+                            size_t* num_layers_pushed) {
   if (!layer) {
     DCHECK(!layer_impl);
     return;
@@ -194,24 +204,76 @@ void PushPropertiesInternal(LayerType* layer, LayerImpl* layer_impl) {
 
   DCHECK_EQ(layer->id(), layer_impl->id());
   layer->PushPropertiesTo(layer_impl);
+  (*num_layers_pushed)++;
 
-  PushPropertiesInternal(layer->mask_layer(), layer_impl->mask_layer());
-  PushPropertiesInternal(layer->replica_layer(), layer_impl->replica_layer());
+  PushPropertiesInternal(
+      layer->mask_layer(), layer_impl->mask_layer(), num_layers_pushed);
+  PushPropertiesInternal(
+      layer->replica_layer(), layer_impl->replica_layer(), num_layers_pushed);
 
   const ScopedPtrVector<LayerImpl>& impl_children = layer_impl->children();
   DCHECK_EQ(layer->children().size(), impl_children.size());
 
   for (size_t i = 0; i < layer->children().size(); ++i) {
-    PushPropertiesInternal(layer->child_at(i), impl_children[i]);
+    PushPropertiesInternal(
+        layer->child_at(i), impl_children[i], num_layers_pushed);
   }
 }
 
-void TreeSynchronizer::PushProperties(Layer* layer, LayerImpl* layer_impl) {
-  PushPropertiesInternal(layer, layer_impl);
+bool TreeSynchronizer::PushPropertiesRecursive(Layer* layer,
+                                               LayerImpl* layer_impl,
+                                               size_t* num_layers_pushed) {
+  if (!layer) {
+    DCHECK(!layer_impl);
+    return false;
+  }
+
+  DCHECK_EQ(layer->id(), layer_impl->id());
+  if (layer->needs_push_properties()) {
+    layer->PushPropertiesTo(layer_impl);
+    (*num_layers_pushed)++;
+  }
+
+  if (layer->descendant_needs_push_properties()) {
+    int num_dependents_need_push_properties = 0;
+    if (PushPropertiesRecursive(layer->mask_layer(),
+                                layer_impl->mask_layer(),
+                                num_layers_pushed))
+      num_dependents_need_push_properties++;
+    if (PushPropertiesRecursive(layer->replica_layer(),
+                                layer_impl->replica_layer(),
+                                num_layers_pushed))
+      num_dependents_need_push_properties++;
+
+    const ScopedPtrVector<LayerImpl>& impl_children = layer_impl->children();
+    DCHECK_EQ(layer->children().size(), impl_children.size());
+
+    for (size_t i = 0; i < layer->children().size(); ++i) {
+      if (PushPropertiesRecursive(
+              layer->child_at(i), impl_children[i], num_layers_pushed))
+        num_dependents_need_push_properties++;
+    }
+
+    // Some layers stay dirty after pushing, to push again with the next
+    // commit; keep the counts leading to them.
+    layer->num_dependents_need_push_properties_ =
+        num_dependents_need_push_properties;
+  }
+
+  return layer->parent_should_know_need_push_properties();
+}
+
+size_t TreeSynchronizer::PushProperties(Layer* layer, LayerImpl* layer_impl) {
+  size_t num_layers_pushed = 0;
+  PushPropertiesRecursive(layer, layer_impl, &num_layers_pushed);
+  return num_layers_pushed;
 }
 
-void TreeSynchronizer::PushProperties(LayerImpl* layer, LayerImpl* layer_impl) {
-  PushPropertiesInternal(layer, layer_impl);
+size_t TreeSynchronizer::PushProperties(LayerImpl* layer,
+                                        LayerImpl* layer_impl) {
+  size_t num_layers_pushed = 0;
+  PushPropertiesInternal(layer, layer_impl, &num_layers_pushed);
+  return num_layers_pushed;
 }
 
 }  // namespace cc
@@ -31,13 +31,22 @@ class CC_EXPORT TreeSynchronizer {
       LayerTreeImpl* tree_impl);
 
   // Pushes properties from a Layer or LayerImpl tree to a structurally
-  // equivalent LayerImpl tree.
-  static void PushProperties(Layer* layer_root, LayerImpl* layer_impl_root);
-  static void PushProperties(LayerImpl* layer_root, LayerImpl* layer_impl_root);
+  // equivalent LayerImpl tree, and returns the number of layers pushed. From
+  // a Layer tree only the layers that need it are pushed, skipping subtrees
+  // that have none; see Layer::needs_push_properties(). Synchronizing the
+  // trees marks every Layer as needing it.
+  static size_t PushProperties(Layer* layer_root, LayerImpl* layer_impl_root);
+  static size_t PushProperties(LayerImpl* layer_root,
+                               LayerImpl* layer_impl_root);
 
  private:
   TreeSynchronizer();  // Not instantiable.
 
+  // Returns true if |layer|'s parent should keep visiting it.
+  static bool PushPropertiesRecursive(Layer* layer,
+                                      LayerImpl* layer_impl,
+                                      size_t* num_layers_pushed);
+
   DISALLOW_COPY_AND_ASSIGN(TreeSynchronizer);
 };
 
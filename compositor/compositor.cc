@@ -20,6 +20,7 @@
 #include "cc/layers/layer.h"
 #include "cc/trees/layer_tree_host.h"
 #include "third_party/skia/include/core/SkBitmap.h"
+#include "uibase/animation/animation_container.h"
 #include "compositor/compositor_observer.h"
 #include "compositor/compositor_switches.h"
 #include "compositor/dip_util.h"
@@ -303,6 +304,10 @@ void Compositor::OnSwapBuffersAborted() {
 
 void Compositor::OnUpdateVSyncParameters(base::TimeTicks timebase,
                                          base::TimeDelta interval) {
+  if (CommandLine::ForCurrentProcess()->HasSwitch(
+          switches::kUIEnableVSyncAnimationTicks)) {
+    AnimationContainer::SetVSyncParameters(timebase, interval);
+  }
   FOR_EACH_OBSERVER(CompositorObserver,
                     observer_list_,
                     OnUpdateVSyncParameters(this, timebase, interval));
@@ -10,6 +10,8 @@ const char kDisableTestCompositor[] = "disable-test-compositor";
 
 const char kUIEnableThreadedCompositing[] = "ui-enable-threaded-compositing";
 
+const char kUIEnableVSyncAnimationTicks[] = "ui-enable-vsync-animation-ticks";
+
 const char kUIEnableSoftwareCompositing[] = "ui-enable-software-compositing";
 
 const char kUIMaxFramesPending[] = "ui-max-frames-pending";
@@ -8,6 +8,7 @@
 
 #include <algorithm>
 
+#include "base/basictypes.h"
 #include "base/build_config.h"
 
 #if defined(ARCH_CPU_X86_FAMILY)
@@ -32,11 +33,36 @@ CPU::CPU()
     has_ssse3_(false),
     has_sse41_(false),
     has_sse42_(false),
+    has_avx_(false),
+    has_avx2_(false),
     cpu_vendor_("unknown") {
   Initialize();
 }
 
 #if defined(ARCH_CPU_X86_FAMILY)
+#if defined(_MSC_VER) && _MSC_FULL_VER < 160040219
+
+// Visual Studio 2010 SP1 added the _xgetbv() intrinsic. Older compilers get
+// the instruction emitted by hand, and x64 builds, which have no inline
+// assembly, report that the OS does not save the YMM registers.
+uint64 _xgetbv(uint32 xcr) {
+#if defined(_M_IX86)
+  uint32 eax_value, edx_value;
+  __asm {
+    mov ecx, xcr
+    _emit 0x0f
+    _emit 0x01
+    _emit 0xd0
+    mov eax_value, eax
+    mov edx_value, edx
+  }
+  return (static_cast<uint64>(edx_value) << 32) | eax_value;
+#else
+  return 0;
+#endif
+}
+
+#endif  // _MSC_FULL_VER < 160040219
 #ifndef _MSC_VER
 
 #if defined(__pic__) && defined(__i386__)
@@ -80,6 +106,17 @@ void __cpuidex(int cpu_info[4], int info_type, int info_index) {
 }
 
 #endif
+
+// xgetbv returns the value of an Intel Extended Control Register (XCR).
+// Currently only XCR0 is defined by Intel so |xcr| should always be zero.
+uint64 _xgetbv(uint32 xcr) {
+  uint32 eax, edx;
+
+  __asm__ volatile (
+    "xgetbv" : "=a"(eax), "=d"(edx) : "c"(xcr));
+  return (static_cast<uint64>(edx) << 32) | eax;
+}
+
 #endif  // _MSC_VER
 #endif  // ARCH_CPU_X86_FAMILY
 
@@ -117,7 +154,18 @@ void CPU::Initialize() {
     has_ssse3_ = (cpu_info[2] & 0x00000200) != 0;
     has_sse41_ = (cpu_info[2] & 0x00080000) != 0;
     has_sse42_ = (cpu_info[2] & 0x00100000) != 0;
-    has_avx_ = (cpu_info[2] & 0x10000000) != 0;
+    // AVX instructions also need the OS to save the YMM registers on context
+    // switches, which it reports with OSXSAVE (bit 27) and the XMM and YMM
+    // state bits of XCR0.
+    has_avx_ = (cpu_info[2] & 0x10000000) != 0 &&
+               (cpu_info[2] & 0x08000000) != 0 &&
+               (_xgetbv(0) & 6) == 6;
+  }
+
+  // Extended features are in leaf 7, subleaf 0.
+  if (num_ids >= 7) {
+    __cpuidex(cpu_info, 7, 0);
+    has_avx2_ = has_avx_ && (cpu_info[1] & 0x00000020) != 0;
   }
 
   // Get the brand string of the cpu.
@@ -139,6 +187,7 @@ void CPU::Initialize() {
 }
 
 CPU::IntelMicroArchitecture CPU::GetIntelMicroArchitecture() const {
+  if (has_avx2()) return AVX2;
   if (has_avx()) return AVX;
   if (has_sse42()) return SSE42;
   if (has_sse41()) return SSE41;
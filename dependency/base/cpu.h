@@ -26,6 +26,7 @@ class BASE_EXPORT CPU {
     SSE41,
     SSE42,
     AVX,
+    AVX2,
     MAX_INTEL_MICRO_ARCHITECTURE
   };
 
@@ -44,7 +45,9 @@ class BASE_EXPORT CPU {
   bool has_ssse3() const { return has_ssse3_; }
   bool has_sse41() const { return has_sse41_; }
   bool has_sse42() const { return has_sse42_; }
+  // AVX and AVX2 are only reported when the OS also saves the YMM registers.
   bool has_avx() const { return has_avx_; }
+  bool has_avx2() const { return has_avx2_; }
   IntelMicroArchitecture GetIntelMicroArchitecture() const;
   const std::string& cpu_brand() const { return cpu_brand_; }
 
@@ -66,6 +69,7 @@ class BASE_EXPORT CPU {
   bool has_sse41_;
   bool has_sse42_;
   bool has_avx_;
+  bool has_avx2_;
   std::string cpu_vendor_;
   std::string cpu_brand_;
 };
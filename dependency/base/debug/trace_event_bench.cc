@@ -0,0 +1,124 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// This small program measures the per-call cost of the instrumentation that
+// sits on hot paths such as cc::TileManager::ManageTiles(): TRACE_EVENT
+// macros while tracing is disabled and enabled, first-use category lookups,
+// and UMA_HISTOGRAM samples. Each case is run for a number of iterations and
+// the average cost per call is printed in nanoseconds.
+//
+// With -max_disabled_ns the program exits with status 1 if a disabled trace
+// event costs more than the given number of nanoseconds, so it can be used
+// as a check in a perf bot.
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "base/at_exit.h"
+#include "base/basictypes.h"
+#include "base/command_line.h"
+#include "base/debug/trace_event.h"
+#include "base/metrics/histogram.h"
+#include "base/metrics/statistics_recorder.h"
+#include "base/string_number_conversions.h"
+#include "base/time.h"
+
+namespace {
+
+const int kDefaultIterations = 10000000;
+
+// Runs |function| |iterations| times and returns the average cost of one call
+// in nanoseconds.
+double TimeCall(void (*function)(int), int iterations) {
+  base::TimeTicks start = base::TimeTicks::HighResNow();
+  for (int i = 0; i < iterations; ++i)
+    function(i);
+  base::TimeDelta elapsed = base::TimeTicks::HighResNow() - start;
+  return elapsed.InMillisecondsF() * 1000000.0 / iterations;
+}
+
+void ScopedTraceEvent(int i) {
+  TRACE_EVENT0("bench", "ScopedTraceEvent");
+}
+
+void ScopedTraceEventWithArgs(int i) {
+  TRACE_EVENT2("bench", "ScopedTraceEventWithArgs", "i", i, "half", i / 2);
+}
+
+void InstantTraceEvent(int i) {
+  TRACE_EVENT_INSTANT1("bench", "InstantTraceEvent", "i", i);
+}
+
+void CategoryLookup(int i) {
+  // What a call site pays the first time it runs.
+  base::debug::TraceLog::GetCategoryEnabled("bench");
+}
+
+void HistogramSample(int i) {
+  UMA_HISTOGRAM_COUNTS_100("Bench.HistogramSample", i & 63);
+}
+
+void Usage() {
+  printf("trace_event_bench [-iterations n] [-max_disabled_ns x] [-help]\n"
+         "  -iterations n: calls per measurement (default:%d)\n"
+         "  -max_disabled_ns x: fail if a disabled trace event costs more\n"
+         "      than x nanoseconds\n"
+         "  -help: prints this help and exits\n",
+         kDefaultIterations);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  base::AtExitManager exit_manager;
+  CommandLine::Init(argc, argv);
+  const CommandLine* command_line = CommandLine::ForCurrentProcess();
+
+  int iterations = kDefaultIterations;
+  double max_disabled_ns = 0;
+  if (command_line->HasSwitch("help") ||
+      (command_line->HasSwitch("iterations") &&
+       !base::StringToInt(command_line->GetSwitchValueASCII("iterations"),
+                          &iterations)) ||
+      (command_line->HasSwitch("max_disabled_ns") &&
+       !base::StringToDouble(
+           command_line->GetSwitchValueASCII("max_disabled_ns"),
+           &max_disabled_ns)) ||
+      iterations <= 0) {
+    Usage();
+    return 1;
+  }
+
+  base::StatisticsRecorder::Initialize();
+  base::debug::TraceLog* trace_log = base::debug::TraceLog::GetInstance();
+
+  const double disabled_ns = TimeCall(&ScopedTraceEvent, iterations);
+  printf("TRACE_EVENT0 disabled: %.2f ns\n", disabled_ns);
+  printf("TRACE_EVENT2 disabled: %.2f ns\n",
+         TimeCall(&ScopedTraceEventWithArgs, iterations));
+  printf("TRACE_EVENT_INSTANT1 disabled: %.2f ns\n",
+         TimeCall(&InstantTraceEvent, iterations));
+  printf("category lookup: %.2f ns\n", TimeCall(&CategoryLookup, iterations));
+  printf("UMA_HISTOGRAM_COUNTS_100: %.2f ns\n",
+         TimeCall(&HistogramSample, iterations));
+
+  // Enabled events are much more expensive and fill the trace buffer, so run
+  // fewer of them.
+  const int enabled_iterations = std::max(iterations / 1000, 1);
+  trace_log->SetEnabled(std::vector<std::string>(),
+                        std::vector<std::string>());
+  printf("TRACE_EVENT0 enabled: %.2f ns\n",
+         TimeCall(&ScopedTraceEvent, enabled_iterations));
+  trace_log->SetDisabled();
+
+  if (max_disabled_ns > 0 && disabled_ns > max_disabled_ns) {
+    printf("FAILED: disabled trace event costs more than %.2f ns\n",
+           max_disabled_ns);
+    return 1;
+  }
+  return 0;
+}
@@ -6,6 +6,7 @@
 
 #include <algorithm>
 
+#include "base/atomicops.h"
 #include "base/bind.h"
 #include "base/debug/leak_annotations.h"
 #include "base/debug/trace_event.h"
@@ -44,6 +45,12 @@ namespace debug {
 const size_t kTraceEventBufferSize = 500000;
 const size_t kTraceEventBatchSize = 1000;
 
+// Number of trace events each thread buffers in the per-thread record modes.
+const size_t kTraceEventThreadBufferSize = 16384;
+
+// Default period kept by the RECORD_CONTINUOUSLY mode.
+const int kDefaultContinuousRecordingWindowSeconds = 10;
+
 #define TRACE_EVENT_MAX_CATEGORIES 100
 
 namespace {
@@ -63,7 +70,10 @@ unsigned char g_category_enabled[TRACE_EVENT_MAX_CATEGORIES] = { 0 };
 const int g_category_already_shutdown = 0;
 const int g_category_categories_exhausted = 1;
 const int g_category_metadata = 2;
-int g_category_index = 3; // skip initial 3 categories
+// Categories are only ever appended. New entries are written under the
+// TraceLog lock and then published with a release store to g_category_index,
+// so existing categories can be looked up without the lock.
+subtle::Atomic32 g_category_index = 3; // skip initial 3 categories
 
 // The most-recently captured name of the current thread
 LazyInstance<ThreadLocalPointer<const char> >::Leaky
@@ -312,6 +322,123 @@ void TraceResultBuffer::Finish() {
   output_callback_.Run("]");
 }
 
+////////////////////////////////////////////////////////////////////////////////
+//
+// TraceLog::ThreadEventBuffer
+//
+////////////////////////////////////////////////////////////////////////////////
+
+// Fixed-size ring of the events of one thread. Only the owning thread adds
+// events, and readers synchronize with it through two flags instead of a
+// lock: the owner raises |writing_| and then checks |flushing_|, a reader
+// raises |flushing_| and then waits for |writing_| to drop. So at most one of
+// them touches the events at a time, and the owner drops the events it adds
+// while a reader holds the buffer.
+class TraceLog::ThreadEventBuffer {
+ public:
+  ThreadEventBuffer(int thread_id, size_t capacity)
+      : thread_id_(thread_id),
+        events_(capacity),
+        next_index_(0),
+        size_(0),
+        writing_(0),
+        flushing_(0),
+        orphaned_(0) {
+  }
+
+  int thread_id() const { return thread_id_; }
+
+  // Called on the owning thread. When the buffer is full the event replaces
+  // the oldest one if |overwrite| is set and is dropped otherwise. Returns
+  // true if this event made the buffer full.
+  bool AddEvent(const TraceEvent& event, bool overwrite) {
+    subtle::NoBarrier_Store(&writing_, 1);
+    subtle::MemoryBarrier();
+    if (subtle::NoBarrier_Load(&flushing_)) {
+      subtle::Release_Store(&writing_, 0);
+      return false;
+    }
+
+    bool became_full = false;
+    size_t size = static_cast<size_t>(subtle::NoBarrier_Load(&size_));
+    if (size < events_.size() || overwrite) {
+      events_[next_index_] = event;
+      next_index_ = (next_index_ + 1) % events_.size();
+      if (size < events_.size()) {
+        ++size;
+        subtle::NoBarrier_Store(&size_, static_cast<subtle::Atomic32>(size));
+        became_full = size == events_.size();
+      }
+    }
+
+    subtle::Release_Store(&writing_, 0);
+    return became_full;
+  }
+
+  // Called on any thread, one at a time. Appends the events to |events|,
+  // oldest first, and empties the buffer.
+  void TakeEvents(std::vector<TraceEvent>* events) {
+    subtle::NoBarrier_Store(&flushing_, 1);
+    subtle::MemoryBarrier();
+    while (subtle::Acquire_Load(&writing_))
+      PlatformThread::YieldCurrentThread();
+
+    const size_t capacity = events_.size();
+    const size_t size = static_cast<size_t>(subtle::NoBarrier_Load(&size_));
+    const size_t first = (next_index_ + capacity - size) % capacity;
+    for (size_t i = 0; i < size; ++i) {
+      TraceEvent& event = events_[(first + i) % capacity];
+      events->push_back(event);
+      // Release copied parameters now rather than when the slot is reused.
+      event = TraceEvent();
+    }
+    next_index_ = 0;
+    subtle::NoBarrier_Store(&size_, 0);
+
+    subtle::Release_Store(&flushing_, 0);
+  }
+
+  // Fraction of the buffer in use. May be stale.
+  float GetPercentFull() const {
+    return static_cast<float>(subtle::NoBarrier_Load(&size_)) /
+        events_.size();
+  }
+
+  // Called on the owning thread when it exits. The thread no longer touches
+  // the buffer after this.
+  void MarkOrphaned() { subtle::Release_Store(&orphaned_, 1); }
+  bool orphaned() const { return subtle::Acquire_Load(&orphaned_) != 0; }
+
+ private:
+  const int thread_id_;
+  std::vector<TraceEvent> events_;
+
+  // Slot that the next event goes to.
+  size_t next_index_;
+
+  // Number of events in the buffer.
+  subtle::Atomic32 size_;
+
+  subtle::Atomic32 writing_;
+  subtle::Atomic32 flushing_;
+  subtle::Atomic32 orphaned_;
+
+  DISALLOW_COPY_AND_ASSIGN(ThreadEventBuffer);
+};
+
+namespace {
+
+struct EventTimestampLess {
+  bool operator()(const TraceEvent& a, const TraceEvent& b) const {
+    return a.timestamp() < b.timestamp();
+  }
+  bool operator()(const TraceEvent& a, TimeTicks b) const {
+    return a.timestamp() < b;
+  }
+};
+
+}  // namespace
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 // TraceLog
@@ -347,6 +474,10 @@ TraceLog* TraceLog::GetInstance() {
 
 TraceLog::TraceLog()
     : enabled_(false),
+      record_mode_(RECORD_UNTIL_FULL),
+      continuous_recording_window_(
+          TimeDelta::FromSeconds(kDefaultContinuousRecordingWindowSeconds)),
+      thread_event_buffer_slot_(&TraceLog::OnThreadExit),
       dispatching_to_observer_list_(false),
       watch_category_(NULL) {
   // Trace is enabled or disabled on one thread while other threads are
@@ -368,6 +499,9 @@ TraceLog::TraceLog()
 }
 
 TraceLog::~TraceLog() {
+  // Threads that are still running must not find their old buffer.
+  thread_event_buffer_slot_.Free();
+  STLDeleteElements(&thread_event_buffers_);
 }
 
 const unsigned char* TraceLog::GetCategoryEnabled(const char* name) {
@@ -418,25 +552,40 @@ static void EnableMatchingCategories(const std::vector<std::string>& patterns,
     EnableMatchingCategory(i, patterns, matched_value, unmatched_value);
 }
 
+// static
+unsigned char* TraceLog::FindCategoryEnabled(const char* name) {
+  int category_count = subtle::Acquire_Load(&g_category_index);
+  for (int i = 0; i < category_count; i++) {
+    if (strcmp(g_categories[i], name) == 0)
+      return &g_category_enabled[i];
+  }
+  return NULL;
+}
+
 const unsigned char* TraceLog::GetCategoryEnabledInternal(const char* name) {
-  AutoLock lock(lock_);
   DCHECK(!strchr(name, '"')) << "Category names may not contain double quote";
 
-  unsigned char* category_enabled = NULL;
-  // Search for pre-existing category matching this name
-  for (int i = 0; i < g_category_index; i++) {
-    if (strcmp(g_categories[i], name) == 0) {
-      category_enabled = &g_category_enabled[i];
-      break;
-    }
+  // Most call sites use a category that another call site has already
+  // created, so only take the lock to create a new one.
+  unsigned char* category_enabled = FindCategoryEnabled(name);
+  if (category_enabled) {
+#if defined(OS_ANDROID)
+    AutoLock lock(lock_);
+    ApplyATraceEnabledFlag(category_enabled);
+#endif
+    return category_enabled;
   }
 
+  AutoLock lock(lock_);
+  // Search again in case another thread created the category meanwhile.
+  category_enabled = FindCategoryEnabled(name);
+
   if (!category_enabled) {
     // Create a new category
     DCHECK(g_category_index < TRACE_EVENT_MAX_CATEGORIES) <<
         "must increase TRACE_EVENT_MAX_CATEGORIES";
     if (g_category_index < TRACE_EVENT_MAX_CATEGORIES) {
-      int new_index = g_category_index++;
+      int new_index = g_category_index;
       // Don't hold on to the name pointer, so that we can create categories
       // with strings not known at compile time (this is required by
       // SetWatchEvent).
@@ -458,6 +607,9 @@ const unsigned char* TraceLog::GetCategoryEnabledInternal(const char* name) {
         g_category_enabled[new_index] = 0;
       }
       category_enabled = &g_category_enabled[new_index];
+      // Publish the category to FindCategoryEnabled() only once its name and
+      // enabled flag are in place.
+      subtle::Release_Store(&g_category_index, new_index + 1);
     } else {
       category_enabled = &g_category_enabled[g_category_categories_exhausted];
     }
@@ -534,6 +686,18 @@ void TraceLog::GetEnabledTraceCategories(
   }
 }
 
+void TraceLog::SetRecordMode(RecordMode mode) {
+  AutoLock lock(lock_);
+  DCHECK(!enabled_) << "Cannot change the record mode while tracing";
+  record_mode_ = mode;
+}
+
+void TraceLog::SetContinuousRecordingWindow(TimeDelta window) {
+  AutoLock lock(lock_);
+  DCHECK(!enabled_) << "Cannot change the recording window while tracing";
+  continuous_recording_window_ = window;
+}
+
 void TraceLog::SetDisabled() {
   AutoLock lock(lock_);
   if (!enabled_)
@@ -580,7 +744,17 @@ void TraceLog::RemoveEnabledStateObserver(
 }
 
 float TraceLog::GetBufferPercentFull() const {
-  return (float)((double)logged_events_.size()/(double)kTraceEventBufferSize);
+  if (record_mode_ == RECORD_UNTIL_FULL)
+    return (float)((double)logged_events_.size()/(double)kTraceEventBufferSize);
+
+  // Report the fullest thread, since that is the one that loses events.
+  AutoLock lock(lock_);
+  float percent_full = 0.f;
+  for (size_t i = 0; i < thread_event_buffers_.size(); ++i) {
+    percent_full = std::max(percent_full,
+                            thread_event_buffers_[i]->GetPercentFull());
+  }
+  return percent_full;
 }
 
 void TraceLog::SetNotificationCallback(
@@ -594,6 +768,7 @@ void TraceLog::Flush(const TraceLog::OutputCallback& cb) {
   {
     AutoLock lock(lock_);
     previous_logged_events.swap(logged_events_);
+    TakeThreadBufferEventsWhileLocked(&previous_logged_events);
   }  // release lock
 
   for (size_t i = 0;
@@ -626,6 +801,27 @@ void TraceLog::AddTraceEvent(char phase,
 #endif
 
   TimeTicks now = TimeTicks::NowFromSystemTraceTime() - time_offset_;
+
+  if (record_mode_ != RECORD_UNTIL_FULL) {
+    // |category_enabled| is read without the lock, as by the trace macros.
+    if (*category_enabled != CATEGORY_ENABLED)
+      return;
+
+    int thread_id = static_cast<int>(PlatformThread::CurrentId());
+    UpdateThreadName(thread_id);
+
+    if (flags & TRACE_EVENT_FLAG_MANGLE_ID)
+      id ^= process_id_hash_;
+
+    AddTraceEventToThreadBuffer(
+        TraceEvent(thread_id,
+                   now, phase, category_enabled, name, id,
+                   num_args, arg_names, arg_types, arg_values,
+                   flags),
+        category_enabled, name);
+    return;
+  }
+
   NotificationHelper notifier(this);
   {
     AutoLock lock(lock_);
@@ -643,25 +839,7 @@ void TraceLog::AddTraceEvent(char phase,
     // favor common case performance over corner case correctness.
     if (new_name != g_current_thread_name.Get().Get() &&
         new_name && *new_name) {
-      g_current_thread_name.Get().Set(new_name);
-      base::hash_map<int, std::string>::iterator existing_name =
-          thread_names_.find(thread_id);
-      if (existing_name == thread_names_.end()) {
-        // This is a new thread id, and a new name.
-        thread_names_[thread_id] = new_name;
-      } else {
-        // This is a thread id that we've seen before, but potentially with a
-        // new name.
-        std::vector<base::StringPiece> existing_names;
-        Tokenize(existing_name->second, ",", &existing_names);
-        bool found = std::find(existing_names.begin(),
-                               existing_names.end(),
-                               new_name) != existing_names.end();
-        if (!found) {
-          existing_name->second.push_back(',');
-          existing_name->second.append(new_name);
-        }
-      }
+      UpdateThreadNameWhileLocked(thread_id, new_name);
     }
 
     if (flags & TRACE_EVENT_FLAG_MANGLE_ID)
@@ -683,6 +861,124 @@ void TraceLog::AddTraceEvent(char phase,
   notifier.SendNotificationIfAny();
 }
 
+void TraceLog::UpdateThreadName(int thread_id) {
+  const char* new_name = PlatformThread::GetName();
+  // See the matching check in AddTraceEvent(). |g_current_thread_name| is
+  // thread local, so the lock is only needed once the name changed.
+  if (new_name == g_current_thread_name.Get().Get() || !new_name || !*new_name)
+    return;
+  AutoLock lock(lock_);
+  UpdateThreadNameWhileLocked(thread_id, new_name);
+}
+
+void TraceLog::UpdateThreadNameWhileLocked(int thread_id,
+                                           const char* new_name) {
+  lock_.AssertAcquired();
+  g_current_thread_name.Get().Set(new_name);
+  base::hash_map<int, std::string>::iterator existing_name =
+      thread_names_.find(thread_id);
+  if (existing_name == thread_names_.end()) {
+    // This is a new thread id, and a new name.
+    thread_names_[thread_id] = new_name;
+  } else {
+    // This is a thread id that we've seen before, but potentially with a
+    // new name.
+    std::vector<base::StringPiece> existing_names;
+    Tokenize(existing_name->second, ",", &existing_names);
+    bool found = std::find(existing_names.begin(),
+                           existing_names.end(),
+                           new_name) != existing_names.end();
+    if (!found) {
+      existing_name->second.push_back(',');
+      existing_name->second.append(new_name);
+    }
+  }
+}
+
+void TraceLog::AddTraceEventToThreadBuffer(
+    const TraceEvent& event,
+    const unsigned char* category_enabled,
+    const char* name) {
+  ThreadEventBuffer* buffer = GetThreadEventBuffer();
+  bool became_full =
+      buffer->AddEvent(event, record_mode_ == RECORD_CONTINUOUSLY);
+
+  // Only take the lock for the rare events that need a notification.
+  // |watch_category_| is read racily; a stale value only delays or drops
+  // a notification around a SetWatchEvent() call.
+  if (!became_full && watch_category_ != category_enabled)
+    return;
+
+  NotificationHelper notifier(this);
+  {
+    AutoLock lock(lock_);
+    if (became_full && record_mode_ == RECORD_PER_THREAD)
+      notifier.AddNotificationWhileLocked(TRACE_BUFFER_FULL);
+    if (watch_category_ == category_enabled && watch_event_name_ == name)
+      notifier.AddNotificationWhileLocked(EVENT_WATCH_NOTIFICATION);
+  }  // release lock
+
+  notifier.SendNotificationIfAny();
+}
+
+TraceLog::ThreadEventBuffer* TraceLog::GetThreadEventBuffer() {
+  ThreadEventBuffer* buffer =
+      static_cast<ThreadEventBuffer*>(thread_event_buffer_slot_.Get());
+  if (buffer)
+    return buffer;
+
+  buffer = new ThreadEventBuffer(static_cast<int>(PlatformThread::CurrentId()),
+                                 kTraceEventThreadBufferSize);
+  {
+    AutoLock lock(lock_);
+    thread_event_buffers_.push_back(buffer);
+  }
+  thread_event_buffer_slot_.Set(buffer);
+  return buffer;
+}
+
+void TraceLog::TakeThreadBufferEventsWhileLocked(
+    std::vector<TraceEvent>* events) {
+  lock_.AssertAcquired();
+  if (thread_event_buffers_.empty())
+    return;
+
+  std::vector<TraceEvent> thread_events;
+  std::vector<ThreadEventBuffer*> live_buffers;
+  for (size_t i = 0; i < thread_event_buffers_.size(); ++i) {
+    ThreadEventBuffer* buffer = thread_event_buffers_[i];
+    // Check before taking the events, so that an exiting thread can't add
+    // events after we looked.
+    bool orphaned = buffer->orphaned();
+    buffer->TakeEvents(&thread_events);
+    if (orphaned)
+      delete buffer;
+    else
+      live_buffers.push_back(buffer);
+  }
+  thread_event_buffers_.swap(live_buffers);
+
+  // Merge the threads into one timeline.
+  std::stable_sort(thread_events.begin(), thread_events.end(),
+                   EventTimestampLess());
+
+  size_t first = 0;
+  if (record_mode_ == RECORD_CONTINUOUSLY && !thread_events.empty()) {
+    TimeTicks start =
+        thread_events.back().timestamp() - continuous_recording_window_;
+    first = std::lower_bound(thread_events.begin(), thread_events.end(),
+                             start, EventTimestampLess()) -
+        thread_events.begin();
+  }
+  events->insert(events->end(), thread_events.begin() + first,
+                 thread_events.end());
+}
+
+// static
+void TraceLog::OnThreadExit(void* thread_event_buffer) {
+  static_cast<ThreadEventBuffer*>(thread_event_buffer)->MarkOrphaned();
+}
+
 void TraceLog::AddTraceEventEtw(char phase,
                                 const char* name,
                                 const void* id,
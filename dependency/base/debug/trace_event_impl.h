@@ -18,6 +18,7 @@
 #include "base/string_util.h"
 #include "base/synchronization/condition_variable.h"
 #include "base/synchronization/lock.h"
+#include "base/threading/thread_local_storage.h"
 #include "base/timer.h"
 
 // Older style trace macros with explicit id and extra data
@@ -87,6 +88,7 @@ class BASE_EXPORT TraceEvent {
                                 std::string* out);
 
   TimeTicks timestamp() const { return timestamp_; }
+  char phase() const { return phase_; }
 
   // Exposed for unittesting:
 
@@ -170,6 +172,21 @@ class BASE_EXPORT TraceLog {
     EVENT_WATCH_NOTIFICATION = 1 << 1
   };
 
+  // How trace events are recorded.
+  enum RecordMode {
+    // All threads record into one buffer guarded by a lock. Recording stops
+    // when the buffer is full.
+    RECORD_UNTIL_FULL,
+    // Each thread records into its own fixed-size buffer without taking a
+    // lock, and the buffers are merged by Flush(). A thread stops recording
+    // when its buffer is full.
+    RECORD_PER_THREAD,
+    // Like RECORD_PER_THREAD, but a full buffer overwrites its oldest events
+    // and Flush() only returns the events of the last continuous recording
+    // window. Meant to be left on and flushed when something goes wrong.
+    RECORD_CONTINUOUSLY
+  };
+
   static TraceLog* GetInstance();
 
   // Get set of known categories. This can change as new code paths are reached.
@@ -202,6 +219,16 @@ class BASE_EXPORT TraceLog {
   void GetEnabledTraceCategories(std::vector<std::string>* included_out,
                                  std::vector<std::string>* excluded_out);
 
+  // Sets how events are recorded. Must be called while tracing is disabled.
+  // Defaults to RECORD_UNTIL_FULL.
+  void SetRecordMode(RecordMode mode);
+  RecordMode record_mode() const { return record_mode_; }
+
+  // Sets how far back Flush() goes in RECORD_CONTINUOUSLY mode. Events older
+  // than |window| relative to the newest event are dropped. Each thread's
+  // buffer also has a fixed size, so a busy thread may cover less than this.
+  void SetContinuousRecordingWindow(TimeDelta window);
+
   // Disable tracing for all categories.
   void SetDisabled();
   // Helper method to enable/disable tracing for all categories.
@@ -244,7 +271,8 @@ class BASE_EXPORT TraceLog {
   // Flush all collected events to the given output callback. The callback will
   // be called one or more times with IPC-bite-size chunks. The string format is
   // undefined. Use TraceResultBuffer to convert one or more trace strings to
-  // JSON.
+  // JSON. Flush() may be called while tracing is enabled; in the per-thread
+  // modes a thread drops the events it adds while its buffer is being read.
   typedef base::Callback<void(const scoped_refptr<base::RefCountedString>&)>
       OutputCallback;
   void Flush(const OutputCallback& cb);
@@ -277,7 +305,8 @@ class BASE_EXPORT TraceLog {
   // For every matching event, a notification will be fired. NOTE: the
   // notification will fire for each matching event that has already occurred
   // since tracing was started (including before tracing if the process was
-  // started with tracing turned on).
+  // started with tracing turned on). Events already recorded into per-thread
+  // buffers are not searched.
   void SetWatchEvent(const std::string& category_name,
                      const std::string& event_name);
   // Cancel the watch event. If tracing is enabled, this may race with the
@@ -294,7 +323,7 @@ class BASE_EXPORT TraceLog {
   // Allows resurrecting our singleton instance post-AtExit processing.
   static void Resurrect();
 
-  // Allow tests to inspect TraceEvents.
+  // Allow tests to inspect TraceEvents. Only covers RECORD_UNTIL_FULL.
   size_t GetEventsSize() const { return logged_events_.size(); }
   const TraceEvent& GetEventAt(size_t index) const {
     DCHECK(index < logged_events_.size());
@@ -323,6 +352,8 @@ class BASE_EXPORT TraceLog {
     ATRACE_ENABLED = 1 << 1
   };
 
+  class ThreadEventBuffer;
+
   // Helper class for managing notification_thread_count_ and running
   // notification callbacks. This is very similar to a reader-writer lock, but
   // shares the lock with TraceLog and manages the notification flags.
@@ -349,8 +380,33 @@ class BASE_EXPORT TraceLog {
   TraceLog();
   ~TraceLog();
   const unsigned char* GetCategoryEnabledInternal(const char* name);
+  // Returns the enabled flag of an existing category, or NULL. Doesn't need
+  // |lock_|.
+  static unsigned char* FindCategoryEnabled(const char* name);
   void AddThreadNameMetadataEvents();
 
+  // Records the name of the current thread if it changed since the last event
+  // on this thread. Takes |lock_| only when it changed.
+  void UpdateThreadName(int thread_id);
+  void UpdateThreadNameWhileLocked(int thread_id, const char* new_name);
+
+  // Adds an event to the calling thread's buffer in the per-thread modes.
+  void AddTraceEventToThreadBuffer(const TraceEvent& event,
+                                   const unsigned char* category_enabled,
+                                   const char* name);
+
+  // Returns the calling thread's buffer, creating it on first use.
+  ThreadEventBuffer* GetThreadEventBuffer();
+
+  // Moves the events of all thread buffers to |events|, deletes the buffers
+  // of threads that have exited and, in RECORD_CONTINUOUSLY mode, drops the
+  // events that are outside the recording window. Lock must already be
+  // acquired before calling this function.
+  void TakeThreadBufferEventsWhileLocked(std::vector<TraceEvent>* events);
+
+  // TLS destructor of |thread_event_buffer_slot_|.
+  static void OnThreadExit(void* thread_event_buffer);
+
 #if defined(OS_ANDROID)
   void SendToATrace(char phase,
                     const char* category,
@@ -363,13 +419,21 @@ class BASE_EXPORT TraceLog {
   static void ApplyATraceEnabledFlag(unsigned char* category_enabled);
 #endif
 
-  // TODO(nduca): switch to per-thread trace buffers to reduce thread
-  // synchronization.
   // This lock protects TraceLog member accesses from arbitrary threads.
-  Lock lock_;
+  // In the per-thread modes it is not taken for recording events.
+  mutable Lock lock_;
   bool enabled_;
   NotificationCallback notification_callback_;
   std::vector<TraceEvent> logged_events_;
+
+  // Only changed while tracing is disabled, so read without |lock_|.
+  RecordMode record_mode_;
+  TimeDelta continuous_recording_window_;
+
+  // The buffers of all threads that recorded in a per-thread mode, owned.
+  // The calling thread's buffer is also kept in |thread_event_buffer_slot_|.
+  std::vector<ThreadEventBuffer*> thread_event_buffers_;
+  ThreadLocalStorage::Slot thread_event_buffer_slot_;
   std::vector<std::string> included_categories_;
   std::vector<std::string> excluded_categories_;
   bool dispatching_to_observer_list_;
@@ -141,6 +141,9 @@ class Lock;
 // a macro argument here.  The name is only used in a DCHECK, to assure that
 // callers don't try to vary the name of the histogram (which would tend to be
 // ignored by the one-time initialization of the histogtram_pointer).
+// After the first call the block is one acquire load of the cached pointer
+// plus the Add(); the name check compares against the literal in place so
+// that debug builds don't allocate a string on every sample either.
 #define STATIC_HISTOGRAM_POINTER_BLOCK(constant_histogram_name, \
                                        histogram_add_method_invocation, \
                                        histogram_factory_get_invocation) \
@@ -153,8 +156,8 @@ class Lock;
       base::subtle::Release_Store(&atomic_histogram_pointer, \
           reinterpret_cast<base::subtle::AtomicWord>(histogram_pointer)); \
     } \
-    DCHECK_EQ(histogram_pointer->histogram_name(), \
-              std::string(constant_histogram_name)); \
+    DCHECK(histogram_pointer->histogram_name() == \
+           constant_histogram_name); \
     histogram_pointer->histogram_add_method_invocation; \
   } while (0)
 
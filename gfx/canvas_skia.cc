@@ -15,6 +15,7 @@
 #include "gfx/rect.h"
 #include "gfx/render_text.h"
 #include "gfx/shadow_value.h"
+#include "gfx/text_size_cache.h"
 #include "gfx/text_utils.h"
 
 namespace {
@@ -101,7 +102,7 @@ void ElideTextAndAdjustRange(const gfx::Font& font,
                              string16* text,
                              ui::Range* range) {
   const char16 start_char = (range->IsValid() ? text->at(range->start()) : 0);
-  *text = ui::ElideText(*text, font, width, ui::ELIDE_AT_END);
+  *text = ui::ElideTextWithAdvances(*text, font, width, ui::ELIDE_AT_END);
   if (!range->IsValid())
     return;
   if (range->start() >= text->length() ||
@@ -188,6 +189,17 @@ void Canvas::SizeStringInt(const string16& text,
 
   flags = AdjustPlatformSpecificFlags(text, flags);
 
+  // The available width only affects the result when wrapping.
+  const int cache_flags = flags;
+  const int cache_width = (flags & MULTI_LINE) ? *width : 0;
+  TextSizeCache* size_cache = TextSizeCache::GetInstance();
+  Size cached_size;
+  if (size_cache->Lookup(text, font, cache_flags, cache_width, &cached_size)) {
+    *width = cached_size.width();
+    *height = cached_size.height();
+    return;
+  }
+
   string16 adjusted_text = text;
 #if defined(OS_WIN)
   AdjustStringDirection(flags, &adjusted_text);
@@ -235,6 +247,9 @@ void Canvas::SizeStringInt(const string16& text,
       *height = string_size.height();
     }
   }
+
+  size_cache->Insert(text, font, cache_flags, cache_width,
+                     Size(*width, *height));
 }
 
 void Canvas::DrawStringWithShadows(const string16& text,
@@ -4,9 +4,12 @@
 
 #include "gfx/codec/png_codec.h"
 
+#include <algorithm>
+
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/string_util.h"
+#include "gfx/codec/png_row_converters.h"
 #include "gfx/size.h"
 #include "gfx/skia_util.h"
 #include "third_party/libpng/png.h"
@@ -17,59 +20,6 @@
 
 namespace gfx {
 
-namespace {
-
-// Converts BGRA->RGBA and RGBA->BGRA.
-void ConvertBetweenBGRAandRGBA(const unsigned char* input, int pixel_width,
-                               unsigned char* output, bool* is_opaque) {
-  for (int x = 0; x < pixel_width; x++) {
-    const unsigned char* pixel_in = &input[x * 4];
-    unsigned char* pixel_out = &output[x * 4];
-    pixel_out[0] = pixel_in[2];
-    pixel_out[1] = pixel_in[1];
-    pixel_out[2] = pixel_in[0];
-    pixel_out[3] = pixel_in[3];
-  }
-}
-
-void ConvertRGBAtoRGB(const unsigned char* rgba, int pixel_width,
-                      unsigned char* rgb, bool* is_opaque) {
-  for (int x = 0; x < pixel_width; x++) {
-    const unsigned char* pixel_in = &rgba[x * 4];
-    unsigned char* pixel_out = &rgb[x * 3];
-    pixel_out[0] = pixel_in[0];
-    pixel_out[1] = pixel_in[1];
-    pixel_out[2] = pixel_in[2];
-  }
-}
-
-void ConvertSkiatoRGB(const unsigned char* skia, int pixel_width,
-                      unsigned char* rgb, bool* is_opaque) {
-  for (int x = 0; x < pixel_width; x++) {
-    const uint32_t pixel_in = *reinterpret_cast<const uint32_t*>(&skia[x * 4]);
-    unsigned char* pixel_out = &rgb[x * 3];
-
-    int alpha = SkGetPackedA32(pixel_in);
-    if (alpha != 0 && alpha != 255) {
-      SkColor unmultiplied = SkUnPreMultiply::PMColorToColor(pixel_in);
-      pixel_out[0] = SkColorGetR(unmultiplied);
-      pixel_out[1] = SkColorGetG(unmultiplied);
-      pixel_out[2] = SkColorGetB(unmultiplied);
-    } else {
-      pixel_out[0] = SkGetPackedR32(pixel_in);
-      pixel_out[1] = SkGetPackedG32(pixel_in);
-      pixel_out[2] = SkGetPackedB32(pixel_in);
-    }
-  }
-}
-
-void ConvertSkiatoRGBA(const unsigned char* skia, int pixel_width,
-                       unsigned char* rgba, bool* is_opaque) {
-  gfx::ConvertSkiaToRGBA(skia, pixel_width, rgba);
-}
-
-}  // namespace
-
 // Decoder --------------------------------------------------------------------
 //
 // This code is based on WebKit libpng interface (PNGImageDecoder), which is
@@ -89,31 +39,69 @@ class PngDecoderState {
       : output_format(ofmt),
         output_channels(0),
         bitmap(NULL),
+        reuse_bitmap_pixels(false),
         is_opaque(true),
         output(o),
+        delegate(NULL),
+        pixels(NULL),
+        row_bytes(0),
         width(0),
         height(0),
-        done(false) {
+        interlaced(false),
+        decoded_rows(0),
+        done(false),
+        rgba_to_skia(PNGRowConverters::Get().rgba_to_skia) {
   }
 
   // Output is an SkBitmap.
-  explicit PngDecoderState(SkBitmap* skbitmap)
+  PngDecoderState(SkBitmap* skbitmap, bool reuse_pixels)
       : output_format(PNGCodec::FORMAT_SkBitmap),
         output_channels(0),
         bitmap(skbitmap),
+        reuse_bitmap_pixels(reuse_pixels),
         is_opaque(true),
         output(NULL),
+        delegate(NULL),
+        pixels(NULL),
+        row_bytes(0),
         width(0),
         height(0),
-        done(false) {
+        interlaced(false),
+        decoded_rows(0),
+        done(false),
+        rgba_to_skia(PNGRowConverters::Get().rgba_to_skia) {
+  }
+
+  // Output is the buffer of a PNGIncrementalDecoder::Delegate.
+  PngDecoderState(PNGCodec::ColorFormat ofmt,
+                  PNGIncrementalDecoder::Delegate* d)
+      : output_format(ofmt),
+        output_channels(0),
+        bitmap(NULL),
+        reuse_bitmap_pixels(false),
+        is_opaque(true),
+        output(NULL),
+        delegate(d),
+        pixels(NULL),
+        row_bytes(0),
+        width(0),
+        height(0),
+        interlaced(false),
+        decoded_rows(0),
+        done(false),
+        rgba_to_skia(PNGRowConverters::Get().rgba_to_skia) {
   }
 
   PNGCodec::ColorFormat output_format;
   int output_channels;
 
-  // An incoming SkBitmap to write to. If NULL, we write to output instead.
+  // An incoming SkBitmap to write to. If NULL, we write to output or to the
+  // buffer of the delegate instead.
   SkBitmap* bitmap;
 
+  // Whether to decode into the pixels |bitmap| already has, if they fit.
+  bool reuse_bitmap_pixels;
+
   // Used during the reading of an SkBitmap. Defaults to true until we see a
   // pixel with anything other than an alpha of 255.
   bool is_opaque;
@@ -122,13 +110,31 @@ class PngDecoderState {
   // instead of directly to an SkBitmap.
   std::vector<unsigned char>* output;
 
+  // Provides the buffer to write to, if not NULL.
+  PNGIncrementalDecoder::Delegate* delegate;
+
+  // The first row of the output, and the distance between rows. Set in the
+  // info callback.
+  unsigned char* pixels;
+  int row_bytes;
+
   // Size of the image, set in the info callback.
   int width;
   int height;
 
+  // Whether the image is interlaced, set in the info callback.
+  bool interlaced;
+
+  // The number of rows decoded from the top, in the current pass for
+  // interlaced images.
+  int decoded_rows;
+
   // Set to true when we've found the end of the data.
   bool done;
 
+  // Converts the rows decoded by libpng to Skia format.
+  PNGRowConverters::Converter rgba_to_skia;
+
  private:
   DISALLOW_COPY_AND_ASSIGN(PngDecoderState);
 };
@@ -146,17 +152,8 @@ void ConvertRGBARowToSkia(png_structp png_ptr,
       static_cast<PngDecoderState*>(png_get_user_transform_ptr(png_ptr));
   DCHECK(state) << "LibPNG user transform pointer is NULL";
 
-  unsigned char* const end = data + row_info->rowbytes;
-  for (unsigned char* p = data; p < end; p += channels) {
-    uint32_t* sk_pixel = reinterpret_cast<uint32_t*>(p);
-    const unsigned char alpha = p[channels - 1];
-    if (alpha != 255) {
-      state->is_opaque = false;
-      *sk_pixel = SkPreMultiplyARGB(alpha, p[0], p[1], p[2]);
-    } else {
-      *sk_pixel = SkPackARGB32(alpha, p[0], p[1], p[2]);
-    }
-  }
+  state->rgba_to_skia(data, static_cast<int>(row_info->rowbytes / channels),
+                      data, &state->is_opaque);
 }
 
 // Called when the png header has been read. This code is based on the WebKit
@@ -276,14 +273,34 @@ void DecodeInfoCallback(png_struct* png_ptr, png_info* info_ptr) {
 
   png_read_update_info(png_ptr, info_ptr);
 
+  state->interlaced = interlace_type == PNG_INTERLACE_ADAM7;
   if (state->bitmap) {
-    state->bitmap->setConfig(SkBitmap::kARGB_8888_Config,
-                             state->width, state->height);
-    state->bitmap->allocPixels();
+    SkBitmap* bitmap = state->bitmap;
+    if (!state->reuse_bitmap_pixels ||
+        bitmap->config() != SkBitmap::kARGB_8888_Config ||
+        bitmap->width() != state->width ||
+        bitmap->height() != state->height ||
+        !bitmap->getPixels()) {
+      bitmap->setConfig(SkBitmap::kARGB_8888_Config,
+                        state->width, state->height);
+      bitmap->allocPixels();
+    }
+    state->pixels = static_cast<unsigned char*>(bitmap->getPixels());
+    state->row_bytes = static_cast<int>(bitmap->rowBytes());
   } else if (state->output) {
     state->output->resize(
         state->width * state->output_channels * state->height);
-  }
+    state->pixels = &state->output->front();
+    state->row_bytes = state->width * state->output_channels;
+  } else if (state->delegate) {
+    state->pixels = state->delegate->GetPixelBuffer(
+        Size(state->width, state->height), &state->row_bytes);
+    if (!state->pixels ||
+        state->row_bytes < state->width * state->output_channels)
+      longjmp(png_jmpbuf(png_ptr), 1);
+  }
+  if (!state->pixels)
+    longjmp(png_jmpbuf(png_ptr), 1);
 }
 
 void DecodeRowCallback(png_struct* png_ptr, png_byte* new_row,
@@ -294,19 +311,14 @@ void DecodeRowCallback(png_struct* png_ptr, png_byte* new_row,
   PngDecoderState* state = static_cast<PngDecoderState*>(
       png_get_progressive_ptr(png_ptr));
 
-  if (static_cast<int>(row_num) > state->height) {
+  if (static_cast<int>(row_num) >= state->height) {
     NOTREACHED() << "Invalid row";
     return;
   }
 
-  unsigned char* base = NULL;
-  if (state->bitmap)
-    base = reinterpret_cast<unsigned char*>(state->bitmap->getAddr32(0, 0));
-  else if (state->output)
-    base = &state->output->front();
-
-  unsigned char* dest = &base[state->width * state->output_channels * row_num];
+  unsigned char* dest = &state->pixels[state->row_bytes * row_num];
   png_progressive_combine_row(png_ptr, dest, new_row);
+  state->decoded_rows = static_cast<int>(row_num) + 1;
 }
 
 void DecodeEndCallback(png_struct* png_ptr, png_info* info) {
@@ -452,7 +464,7 @@ bool PNGCodec::Decode(const unsigned char* input, size_t input_size,
     return false;
   }
 
-  PngDecoderState state(bitmap);
+  PngDecoderState state(bitmap, false);
 
   png_set_progressive_read_fn(png_ptr, &state, &DecodeInfoCallback,
                               &DecodeRowCallback, &DecodeEndCallback);
@@ -496,6 +508,136 @@ SkBitmap* PNGCodec::CreateSkBitmapFromBGRAFormat(
   return bitmap;
 }
 
+// PNGIncrementalDecoder -------------------------------------------------------
+
+struct PNGIncrementalDecoder::State {
+  State(PNGCodec::ColorFormat format, Delegate* delegate)
+      : png_ptr(NULL),
+        info_ptr(NULL),
+        decoder_state(format, delegate),
+        read_signature(0) {
+  }
+
+  explicit State(SkBitmap* bitmap)
+      : png_ptr(NULL),
+        info_ptr(NULL),
+        decoder_state(bitmap, true),
+        read_signature(0) {
+  }
+
+  ~State() {
+    if (png_ptr)
+      png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+  }
+
+  png_struct* png_ptr;
+  png_info* info_ptr;
+  PngDecoderState decoder_state;
+
+  // The first bytes of the data, until there are enough to check the PNG
+  // signature and create the libpng structs.
+  unsigned char signature[8];
+  size_t read_signature;
+};
+
+namespace {
+
+// Feeds |size| bytes to the progressive reader of |png_ptr|. Returns false on
+// a decode error. Kept apart from the caller because of the setjmp().
+bool ProcessPNGData(png_struct* png_ptr, png_info* info_ptr,
+                    unsigned char* data, size_t size) {
+  if (setjmp(png_jmpbuf(png_ptr)))
+    return false;
+  png_process_data(png_ptr, info_ptr, data, size);
+  return true;
+}
+
+}  // namespace
+
+PNGIncrementalDecoder::PNGIncrementalDecoder(PNGCodec::ColorFormat format,
+                                             Delegate* delegate)
+    : state_(new State(format, delegate)),
+      failed_(false) {
+  DCHECK(delegate);
+}
+
+PNGIncrementalDecoder::PNGIncrementalDecoder(SkBitmap* bitmap)
+    : state_(new State(bitmap)),
+      failed_(false) {
+  DCHECK(bitmap);
+}
+
+PNGIncrementalDecoder::~PNGIncrementalDecoder() {
+}
+
+bool PNGIncrementalDecoder::AppendData(const unsigned char* data,
+                                       size_t size) {
+  if (failed_)
+    return false;
+  if (is_complete())
+    return true;
+
+  if (!state_->png_ptr) {
+    // BuildPNGStruct() checks the signature, so wait for all of it.
+    const size_t signature_size = sizeof(state_->signature);
+    const size_t copied =
+        std::min(size, signature_size - state_->read_signature);
+    memcpy(&state_->signature[state_->read_signature], data, copied);
+    state_->read_signature += copied;
+    data += copied;
+    size -= copied;
+    if (state_->read_signature < signature_size)
+      return true;
+
+    if (!BuildPNGStruct(state_->signature, signature_size,
+                        &state_->png_ptr, &state_->info_ptr)) {
+      failed_ = true;
+      return false;
+    }
+    png_set_error_fn(state_->png_ptr, NULL, LogLibPNGDecodeError,
+                     LogLibPNGDecodeWarning);
+    png_set_progressive_read_fn(state_->png_ptr, &state_->decoder_state,
+                                &DecodeInfoCallback, &DecodeRowCallback,
+                                &DecodeEndCallback);
+    if (!ProcessPNGData(state_->png_ptr, state_->info_ptr,
+                        state_->signature, signature_size)) {
+      failed_ = true;
+      return false;
+    }
+  }
+
+  if (size && !ProcessPNGData(state_->png_ptr, state_->info_ptr,
+                              const_cast<unsigned char*>(data), size)) {
+    failed_ = true;
+    return false;
+  }
+
+  const PngDecoderState& decoder_state = state_->decoder_state;
+  if (decoder_state.done && decoder_state.bitmap)
+    decoder_state.bitmap->setIsOpaque(decoder_state.is_opaque);
+  return true;
+}
+
+bool PNGIncrementalDecoder::has_size() const {
+  return state_->decoder_state.pixels != NULL;
+}
+
+Size PNGIncrementalDecoder::size() const {
+  return Size(state_->decoder_state.width, state_->decoder_state.height);
+}
+
+int PNGIncrementalDecoder::decoded_rows() const {
+  return state_->decoder_state.decoded_rows;
+}
+
+bool PNGIncrementalDecoder::is_interlaced() const {
+  return state_->decoder_state.interlaced;
+}
+
+bool PNGIncrementalDecoder::is_complete() const {
+  return state_->decoder_state.done;
+}
+
 // Encoder --------------------------------------------------------------------
 //
 // This section of the code is based on nsPNGEncoder.cpp in Mozilla
@@ -525,17 +667,6 @@ void FakeFlushCallback(png_structp png) {
   // we're required to provide this function by libpng.
 }
 
-void ConvertBGRAtoRGB(const unsigned char* bgra, int pixel_width,
-                      unsigned char* rgb, bool* is_opaque) {
-  for (int x = 0; x < pixel_width; x++) {
-    const unsigned char* pixel_in = &bgra[x * 4];
-    unsigned char* pixel_out = &rgb[x * 3];
-    pixel_out[0] = pixel_in[2];
-    pixel_out[1] = pixel_in[1];
-    pixel_out[2] = pixel_in[0];
-  }
-}
-
 #ifdef PNG_TEXT_SUPPORTED
 class CommentWriter {
  public:
@@ -589,8 +720,7 @@ class CommentWriter {
 #endif  // PNG_TEXT_SUPPORTED
 
 // The type of functions usable for converting between pixel formats.
-typedef void (*FormatConverter)(const unsigned char* in, int w,
-                                unsigned char* out, bool* is_opaque);
+typedef PNGRowConverters::Converter FormatConverter;
 
 // libpng uses a wacky setjmp-based API, which makes the compiler nervous.
 // We constrain all of the calls we make to libpng where the setjmp() is in
@@ -675,6 +805,7 @@ bool PNGCodec::EncodeWithCompressionLevel(const unsigned char* input,
   // Run to convert an input row into the output row format, NULL means no
   // conversion is necessary.
   FormatConverter converter = NULL;
+  const PNGRowConverters& converters = PNGRowConverters::Get();
 
   int input_color_components, output_color_components;
   int png_output_color_type;
@@ -690,7 +821,7 @@ bool PNGCodec::EncodeWithCompressionLevel(const unsigned char* input,
       if (discard_transparency) {
         output_color_components = 3;
         png_output_color_type = PNG_COLOR_TYPE_RGB;
-        converter = ConvertRGBAtoRGB;
+        converter = converters.rgba_to_rgb;
       } else {
         output_color_components = 4;
         png_output_color_type = PNG_COLOR_TYPE_RGB_ALPHA;
@@ -703,11 +834,11 @@ bool PNGCodec::EncodeWithCompressionLevel(const unsigned char* input,
       if (discard_transparency) {
         output_color_components = 3;
         png_output_color_type = PNG_COLOR_TYPE_RGB;
-        converter = ConvertBGRAtoRGB;
+        converter = converters.bgra_to_rgb;
       } else {
         output_color_components = 4;
         png_output_color_type = PNG_COLOR_TYPE_RGB_ALPHA;
-        converter = ConvertBetweenBGRAandRGBA;
+        converter = converters.bgra_to_rgba;
       }
       break;
 
@@ -716,11 +847,11 @@ bool PNGCodec::EncodeWithCompressionLevel(const unsigned char* input,
       if (discard_transparency) {
         output_color_components = 3;
         png_output_color_type = PNG_COLOR_TYPE_RGB;
-        converter = ConvertSkiatoRGB;
+        converter = converters.skia_to_rgb;
       } else {
         output_color_components = 4;
         png_output_color_type = PNG_COLOR_TYPE_RGB_ALPHA;
-        converter = ConvertSkiatoRGBA;
+        converter = converters.skia_to_rgba;
       }
       break;
 
@@ -9,14 +9,14 @@
 #include <vector>
 
 #include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
+#include "gfx/size.h"
 #include "uibase/ui_export.h"
 
 class SkBitmap;
 
 namespace gfx {
 
-class Size;
-
 // Interface for encoding and decoding PNG data. This is a wrapper around
 // libpng, which has an inconvenient interface for callers. This is currently
 // designed for use in tests only (where we control the files), so the handling
@@ -129,6 +129,74 @@ class UI_EXPORT PNGCodec {
   DISALLOW_COPY_AND_ASSIGN(PNGCodec);
 };
 
+// Decodes a PNG as its data arrives, for example while it is read from disk,
+// without holding the encoded image in memory. The rows are written straight
+// into a buffer the caller provides, or into an SkBitmap, and the part of the
+// image decoded so far can be shown before the data is complete.
+//
+//   SkBitmap bitmap;
+//   PNGIncrementalDecoder decoder(&bitmap);
+//   while (!decoder.is_complete() && (read = ReadChunk(buffer)) > 0) {
+//     if (!decoder.AppendData(buffer, read))
+//       return false;
+//   }
+//   return decoder.is_complete();
+class UI_EXPORT PNGIncrementalDecoder {
+ public:
+  // Provides the buffer the pixels are decoded into.
+  class Delegate {
+   public:
+    // Called once the header has been read. Returns a buffer for
+    // |size.height()| rows of |size.width()| pixels in the decoder's format,
+    // and sets |*row_bytes| to the distance between its rows, or returns NULL
+    // to fail the decode. The buffer must outlive the decoder.
+    virtual unsigned char* GetPixelBuffer(const Size& size,
+                                          int* row_bytes) = 0;
+
+   protected:
+    virtual ~Delegate() {}
+  };
+
+  // Decodes into the buffer |delegate| provides, in |format|.
+  PNGIncrementalDecoder(PNGCodec::ColorFormat format, Delegate* delegate);
+
+  // Decodes into |bitmap|, in premultiplied kARGB_8888_Config. The pixels of
+  // |bitmap| are reused if they are 32 bit and of the size of the image, so
+  // that a caller can decode into pooled bitmaps; they are allocated
+  // otherwise. The opaqueness of |bitmap| is set once the image is complete.
+  explicit PNGIncrementalDecoder(SkBitmap* bitmap);
+
+  ~PNGIncrementalDecoder();
+
+  // Decodes the next |size| bytes of the PNG. Returns false if the data is
+  // not a valid PNG, after which the decoder ignores any more data.
+  bool AppendData(const unsigned char* data, size_t size);
+
+  // Whether the header has been read and size() is known.
+  bool has_size() const;
+  Size size() const;
+
+  // The number of rows at the top of the image that have been decoded. An
+  // interlaced image is decoded in passes: after the first pass the whole
+  // image holds a coarse version, and the count restarts with each pass.
+  int decoded_rows() const;
+  bool is_interlaced() const;
+
+  // Whether the whole image has been decoded.
+  bool is_complete() const;
+
+  // Whether AppendData() failed.
+  bool failed() const { return failed_; }
+
+ private:
+  struct State;
+
+  scoped_ptr<State> state_;
+  bool failed_;
+
+  DISALLOW_COPY_AND_ASSIGN(PNGIncrementalDecoder);
+};
+
 }  // namespace gfx
 
 #endif  // UI_GFX_CODEC_PNG_CODEC_H_
@@ -0,0 +1,156 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// This small program measures the pixel conversions of PNGCodec on images of
+// the sizes of icons, screenshots and large clipboard images. Each image is
+// mostly opaque, like a screenshot, with a translucent band like a window
+// shadow. For each size it prints the time of encoding the image from an
+// SkBitmap and of decoding it back, and the time the row conversions take
+// in each with the C, SSE2 and SSSE3 PNGRowConverters (the levels the CPU
+// does not support are measured as the highest one it does).
+
+#include <stdio.h>
+
+#include <vector>
+
+#include "base/at_exit.h"
+#include "base/basictypes.h"
+#include "base/command_line.h"
+#include "base/string_number_conversions.h"
+#include "base/time.h"
+#include "gfx/codec/png_codec.h"
+#include "gfx/codec/png_row_converters.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkColorPriv.h"
+
+namespace {
+
+const int kDefaultIterations = 10;
+
+// Names of the PNGRowConverters levels.
+const char* const kLevelNames[] = { "C", "SSE2", "SSSE3" };
+
+struct ImageSize {
+  const char* name;
+  int width;
+  int height;
+};
+
+const ImageSize kImageSizes[] = {
+  { "icon", 256, 256 },
+  { "1366x768", 1366, 768 },
+  { "1920x1080", 1920, 1080 },
+  { "2560x1600", 2560, 1600 },
+};
+
+// Fills |bitmap| with gradients, and with a translucent band across the
+// middle eighth of its rows.
+void FillBitmap(SkBitmap* bitmap, int width, int height) {
+  bitmap->setConfig(SkBitmap::kARGB_8888_Config, width, height);
+  bitmap->allocPixels();
+  for (int y = 0; y < height; ++y) {
+    uint32_t* row = bitmap->getAddr32(0, y);
+    const bool translucent = y >= height * 7 / 16 && y < height * 9 / 16;
+    for (int x = 0; x < width; ++x) {
+      const U8CPU alpha = translucent ? (x + y) % 256 : 255;
+      row[x] = SkPreMultiplyARGB(alpha, x % 256, y % 256, (x ^ y) % 256);
+    }
+  }
+  bitmap->setIsOpaque(false);
+}
+
+// Returns the average time in milliseconds of running |converter| over the
+// |height| rows of |input|, |iterations| times.
+double TimeRows(gfx::PNGRowConverters::Converter converter,
+                const unsigned char* input, int width, int height,
+                int iterations) {
+  std::vector<unsigned char> row(width * 4);
+  bool is_opaque = true;
+  const base::TimeTicks start = base::TimeTicks::HighResNow();
+  for (int i = 0; i < iterations; ++i) {
+    for (int y = 0; y < height; ++y)
+      converter(&input[y * width * 4], width, &row[0], &is_opaque);
+  }
+  const base::TimeDelta elapsed = base::TimeTicks::HighResNow() - start;
+  return elapsed.InMillisecondsF() / iterations;
+}
+
+void RunSize(const ImageSize& size, int iterations) {
+  SkBitmap bitmap;
+  FillBitmap(&bitmap, size.width, size.height);
+  SkAutoLockPixels lock(bitmap);
+  const unsigned char* skia =
+      static_cast<const unsigned char*>(bitmap.getPixels());
+
+  // The decoder converts rows of RGBA, which is what skia_to_rgba makes.
+  std::vector<unsigned char> rgba(size.width * size.height * 4);
+  gfx::PNGRowConverters::Get().skia_to_rgba(skia, size.width * size.height,
+                                            &rgba[0], NULL);
+
+  std::vector<unsigned char> png;
+  base::TimeTicks start = base::TimeTicks::HighResNow();
+  for (int i = 0; i < iterations; ++i)
+    gfx::PNGCodec::EncodeBGRASkBitmap(bitmap, false, &png);
+  const double encode_ms =
+      (base::TimeTicks::HighResNow() - start).InMillisecondsF() / iterations;
+
+  SkBitmap decoded;
+  start = base::TimeTicks::HighResNow();
+  for (int i = 0; i < iterations; ++i)
+    gfx::PNGCodec::Decode(&png[0], png.size(), &decoded);
+  const double decode_ms =
+      (base::TimeTicks::HighResNow() - start).InMillisecondsF() / iterations;
+
+  printf("%-10s encode %8.2f ms  decode %8.2f ms\n",
+         size.name, encode_ms, decode_ms);
+  for (int level = gfx::PNGRowConverters::LEVEL_C;
+       level <= gfx::PNGRowConverters::LEVEL_SSSE3; ++level) {
+    const gfx::PNGRowConverters& converters =
+        gfx::PNGRowConverters::GetForLevel(
+            static_cast<gfx::PNGRowConverters::Level>(level));
+    const double skia_to_rgba_ms = TimeRows(
+        converters.skia_to_rgba, skia, size.width, size.height, iterations);
+    const double skia_to_rgb_ms = TimeRows(
+        converters.skia_to_rgb, skia, size.width, size.height, iterations);
+    const double rgba_to_skia_ms = TimeRows(
+        converters.rgba_to_skia, &rgba[0], size.width, size.height,
+        iterations);
+    printf("  %-5s skia_to_rgba %7.2f ms  skia_to_rgb %7.2f ms  "
+           "rgba_to_skia %7.2f ms\n",
+           kLevelNames[level], skia_to_rgba_ms, skia_to_rgb_ms,
+           rgba_to_skia_ms);
+  }
+}
+
+void Usage() {
+  printf("png_codec_bench [-iterations n] [-help]\n"
+         "  -iterations n: encodes, decodes and conversions per measurement "
+         "(default:%d)\n"
+         "  -help: prints this help and exits\n",
+         kDefaultIterations);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  base::AtExitManager exit_manager;
+  CommandLine::Init(argc, argv);
+  const CommandLine* command_line = CommandLine::ForCurrentProcess();
+
+  int iterations = kDefaultIterations;
+  if (command_line->HasSwitch("help") ||
+      (command_line->HasSwitch("iterations") &&
+       !base::StringToInt(command_line->GetSwitchValueASCII("iterations"),
+                          &iterations)) ||
+      iterations <= 0) {
+    Usage();
+    return 1;
+  }
+
+  printf("Encoding and decoding with the %s row converters.\n",
+         kLevelNames[gfx::PNGRowConverters::Get().level]);
+  for (size_t i = 0; i < arraysize(kImageSizes); ++i)
+    RunSize(kImageSizes[i], iterations);
+  return 0;
+}
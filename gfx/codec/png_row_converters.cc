@@ -0,0 +1,454 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gfx/codec/png_row_converters.h"
+
+#include <string.h>
+
+#include "base/build_config.h"
+#include "base/cpu.h"
+#include "base/lazy_instance.h"
+#include "gfx/skia_util.h"
+#include "third_party/skia/include/core/SkColorPriv.h"
+#include "third_party/skia/include/core/SkUnPreMultiply.h"
+
+#if defined(ARCH_CPU_X86_FAMILY)
+// MSVC compiles SSE intrinsics for any target. gcc and clang only do when the
+// target has the instructions.
+#if defined(_MSC_VER) || defined(__SSE2__)
+#include <emmintrin.h>
+#define PNG_ROW_CONVERTERS_SSE2 1
+#endif
+#if defined(_MSC_VER) || defined(__SSSE3__)
+#include <tmmintrin.h>
+#define PNG_ROW_CONVERTERS_SSSE3 1
+#endif
+#endif
+
+// The SIMD Skia converters handle the two byte orders Skia is built with:
+// BGRA (Windows and Linux) and RGBA (Android).
+#if SK_A32_SHIFT == 24 && SK_G32_SHIFT == 8 && \
+    ((SK_R32_SHIFT == 16 && SK_B32_SHIFT == 0) || \
+     (SK_R32_SHIFT == 0 && SK_B32_SHIFT == 16))
+#define PNG_ROW_CONVERTERS_SIMD_SKIA 1
+#endif
+
+namespace gfx {
+
+namespace {
+
+// C ---------------------------------------------------------------------------
+
+void ConvertBetweenBGRAandRGBA_C(const unsigned char* input, int pixel_width,
+                                 unsigned char* output, bool* is_opaque) {
+  for (int x = 0; x < pixel_width; x++) {
+    const unsigned char* pixel_in = &input[x * 4];
+    unsigned char* pixel_out = &output[x * 4];
+    pixel_out[0] = pixel_in[2];
+    pixel_out[1] = pixel_in[1];
+    pixel_out[2] = pixel_in[0];
+    pixel_out[3] = pixel_in[3];
+  }
+}
+
+void ConvertRGBAtoRGB_C(const unsigned char* rgba, int pixel_width,
+                        unsigned char* rgb, bool* is_opaque) {
+  for (int x = 0; x < pixel_width; x++) {
+    const unsigned char* pixel_in = &rgba[x * 4];
+    unsigned char* pixel_out = &rgb[x * 3];
+    pixel_out[0] = pixel_in[0];
+    pixel_out[1] = pixel_in[1];
+    pixel_out[2] = pixel_in[2];
+  }
+}
+
+void ConvertBGRAtoRGB_C(const unsigned char* bgra, int pixel_width,
+                        unsigned char* rgb, bool* is_opaque) {
+  for (int x = 0; x < pixel_width; x++) {
+    const unsigned char* pixel_in = &bgra[x * 4];
+    unsigned char* pixel_out = &rgb[x * 3];
+    pixel_out[0] = pixel_in[2];
+    pixel_out[1] = pixel_in[1];
+    pixel_out[2] = pixel_in[0];
+  }
+}
+
+void ConvertSkiatoRGB_C(const unsigned char* skia, int pixel_width,
+                        unsigned char* rgb, bool* is_opaque) {
+  for (int x = 0; x < pixel_width; x++) {
+    const uint32_t pixel_in = *reinterpret_cast<const uint32_t*>(&skia[x * 4]);
+    unsigned char* pixel_out = &rgb[x * 3];
+
+    int alpha = SkGetPackedA32(pixel_in);
+    if (alpha != 0 && alpha != 255) {
+      SkColor unmultiplied = SkUnPreMultiply::PMColorToColor(pixel_in);
+      pixel_out[0] = SkColorGetR(unmultiplied);
+      pixel_out[1] = SkColorGetG(unmultiplied);
+      pixel_out[2] = SkColorGetB(unmultiplied);
+    } else {
+      pixel_out[0] = SkGetPackedR32(pixel_in);
+      pixel_out[1] = SkGetPackedG32(pixel_in);
+      pixel_out[2] = SkGetPackedB32(pixel_in);
+    }
+  }
+}
+
+void ConvertSkiatoRGBA_C(const unsigned char* skia, int pixel_width,
+                         unsigned char* rgba, bool* is_opaque) {
+  gfx::ConvertSkiaToRGBA(skia, pixel_width, rgba);
+}
+
+void ConvertRGBAtoSkia_C(const unsigned char* rgba, int pixel_width,
+                         unsigned char* skia, bool* is_opaque) {
+  for (int x = 0; x < pixel_width; x++) {
+    const unsigned char* pixel_in = &rgba[x * 4];
+    uint32_t* pixel_out = reinterpret_cast<uint32_t*>(&skia[x * 4]);
+    const unsigned char alpha = pixel_in[3];
+    if (alpha != 255) {
+      *is_opaque = false;
+      *pixel_out = SkPreMultiplyARGB(alpha, pixel_in[0], pixel_in[1],
+                                     pixel_in[2]);
+    } else {
+      *pixel_out = SkPackARGB32(alpha, pixel_in[0], pixel_in[1], pixel_in[2]);
+    }
+  }
+}
+
+// SSE2 ------------------------------------------------------------------------
+
+#if defined(PNG_ROW_CONVERTERS_SSE2)
+
+// Swaps the first and third bytes of each of the four pixels in |pixels|.
+inline __m128i SwapRedAndBlue_SSE2(__m128i pixels) {
+  const __m128i alpha_green = _mm_and_si128(
+      pixels, _mm_set1_epi32(static_cast<int>(0xFF00FF00)));
+  const __m128i red_blue = _mm_and_si128(pixels, _mm_set1_epi32(0x00FF00FF));
+  return _mm_or_si128(alpha_green,
+                      _mm_or_si128(_mm_slli_epi32(red_blue, 16),
+                                   _mm_srli_epi32(red_blue, 16)));
+}
+
+// Returns true if the four pixels of |pixels| are opaque or fully
+// transparent, which need no unpremultiplying.
+inline bool AreOpaqueOrTransparent_SSE2(__m128i pixels) {
+  const __m128i alpha = _mm_srli_epi32(pixels, 24);
+  const __m128i opaque_or_transparent = _mm_or_si128(
+      _mm_cmpeq_epi32(alpha, _mm_set1_epi32(255)),
+      _mm_cmpeq_epi32(alpha, _mm_setzero_si128()));
+  return _mm_movemask_epi8(opaque_or_transparent) == 0xFFFF;
+}
+
+// Returns true if the four RGBA or Skia pixels of |pixels| are opaque.
+inline bool AreOpaque_SSE2(__m128i pixels) {
+  const __m128i alpha = _mm_srli_epi32(pixels, 24);
+  return _mm_movemask_epi8(
+      _mm_cmpeq_epi32(alpha, _mm_set1_epi32(255))) == 0xFFFF;
+}
+
+// Premultiplies the color of the four RGBA pixels of |pixels| by their alpha,
+// rounding like SkMulDiv255Round().
+inline __m128i Premultiply_SSE2(__m128i pixels) {
+  const __m128i zero = _mm_setzero_si128();
+  // Alpha is the fourth 16 bit lane of each pixel.
+  const __m128i alpha_lanes = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+  const __m128i rounding = _mm_set1_epi16(128);
+
+  __m128i lo = _mm_unpacklo_epi8(pixels, zero);
+  __m128i hi = _mm_unpackhi_epi8(pixels, zero);
+  const __m128i lo_alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, 0xFF),
+                                               0xFF);
+  const __m128i hi_alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, 0xFF),
+                                               0xFF);
+  // prod = c * a + 128; result = (prod + (prod >> 8)) >> 8. The products fit
+  // in 16 bits.
+  __m128i lo_prod = _mm_add_epi16(_mm_mullo_epi16(lo, lo_alpha), rounding);
+  __m128i hi_prod = _mm_add_epi16(_mm_mullo_epi16(hi, hi_alpha), rounding);
+  lo_prod = _mm_srli_epi16(_mm_add_epi16(lo_prod, _mm_srli_epi16(lo_prod, 8)),
+                           8);
+  hi_prod = _mm_srli_epi16(_mm_add_epi16(hi_prod, _mm_srli_epi16(hi_prod, 8)),
+                           8);
+  // Keep the alpha itself.
+  lo = _mm_or_si128(_mm_andnot_si128(alpha_lanes, lo_prod),
+                    _mm_and_si128(alpha_lanes, lo));
+  hi = _mm_or_si128(_mm_andnot_si128(alpha_lanes, hi_prod),
+                    _mm_and_si128(alpha_lanes, hi));
+  return _mm_packus_epi16(lo, hi);
+}
+
+void ConvertBetweenBGRAandRGBA_SSE2(const unsigned char* input,
+                                    int pixel_width,
+                                    unsigned char* output,
+                                    bool* is_opaque) {
+  int x = 0;
+  for (; x + 4 <= pixel_width; x += 4) {
+    const __m128i pixels =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(&input[x * 4]));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&output[x * 4]),
+                     SwapRedAndBlue_SSE2(pixels));
+  }
+  ConvertBetweenBGRAandRGBA_C(&input[x * 4], pixel_width - x, &output[x * 4],
+                              is_opaque);
+}
+
+#if defined(PNG_ROW_CONVERTERS_SIMD_SKIA)
+
+void ConvertSkiatoRGBA_SSE2(const unsigned char* skia, int pixel_width,
+                            unsigned char* rgba, bool* is_opaque) {
+  int x = 0;
+  for (; x + 4 <= pixel_width; x += 4) {
+    __m128i pixels =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(&skia[x * 4]));
+    if (!AreOpaqueOrTransparent_SSE2(pixels)) {
+      ConvertSkiatoRGBA_C(&skia[x * 4], 4, &rgba[x * 4], is_opaque);
+      continue;
+    }
+#if SK_R32_SHIFT == 16
+    pixels = SwapRedAndBlue_SSE2(pixels);
+#endif
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&rgba[x * 4]), pixels);
+  }
+  ConvertSkiatoRGBA_C(&skia[x * 4], pixel_width - x, &rgba[x * 4], is_opaque);
+}
+
+void ConvertRGBAtoSkia_SSE2(const unsigned char* rgba, int pixel_width,
+                            unsigned char* skia, bool* is_opaque) {
+  int x = 0;
+  for (; x + 4 <= pixel_width; x += 4) {
+    __m128i pixels =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(&rgba[x * 4]));
+    if (!AreOpaque_SSE2(pixels)) {
+      *is_opaque = false;
+      pixels = Premultiply_SSE2(pixels);
+    }
+#if SK_R32_SHIFT == 16
+    pixels = SwapRedAndBlue_SSE2(pixels);
+#endif
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&skia[x * 4]), pixels);
+  }
+  ConvertRGBAtoSkia_C(&rgba[x * 4], pixel_width - x, &skia[x * 4], is_opaque);
+}
+
+#endif  // defined(PNG_ROW_CONVERTERS_SIMD_SKIA)
+
+#endif  // defined(PNG_ROW_CONVERTERS_SSE2)
+
+// SSSE3 -----------------------------------------------------------------------
+
+#if defined(PNG_ROW_CONVERTERS_SSE2) && defined(PNG_ROW_CONVERTERS_SSSE3)
+
+// Shuffles that swap the first and third bytes of four pixels, and that
+// pack four pixels to RGB with or without swapping those bytes. The packed
+// pixels take the low 12 bytes.
+inline __m128i SwapRedAndBlueShuffle() {
+  return _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+}
+
+inline __m128i PackRGBShuffle() {
+  return _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14,
+                       -1, -1, -1, -1);
+}
+
+inline __m128i PackSwappedRGBShuffle() {
+  return _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12,
+                       -1, -1, -1, -1);
+}
+
+// Stores the low 12 bytes of |rgb| to |output|.
+inline void StoreRGB_SSSE3(__m128i rgb, unsigned char* output) {
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(output), rgb);
+  const int last = _mm_cvtsi128_si32(_mm_srli_si128(rgb, 8));
+  memcpy(&output[8], &last, sizeof(last));
+}
+
+void ConvertBetweenBGRAandRGBA_SSSE3(const unsigned char* input,
+                                     int pixel_width,
+                                     unsigned char* output,
+                                     bool* is_opaque) {
+  const __m128i shuffle = SwapRedAndBlueShuffle();
+  int x = 0;
+  for (; x + 4 <= pixel_width; x += 4) {
+    const __m128i pixels =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(&input[x * 4]));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&output[x * 4]),
+                     _mm_shuffle_epi8(pixels, shuffle));
+  }
+  ConvertBetweenBGRAandRGBA_C(&input[x * 4], pixel_width - x, &output[x * 4],
+                              is_opaque);
+}
+
+void ConvertRGBAtoRGB_SSSE3(const unsigned char* rgba, int pixel_width,
+                            unsigned char* rgb, bool* is_opaque) {
+  const __m128i shuffle = PackRGBShuffle();
+  int x = 0;
+  for (; x + 4 <= pixel_width; x += 4) {
+    const __m128i pixels =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(&rgba[x * 4]));
+    StoreRGB_SSSE3(_mm_shuffle_epi8(pixels, shuffle), &rgb[x * 3]);
+  }
+  ConvertRGBAtoRGB_C(&rgba[x * 4], pixel_width - x, &rgb[x * 3], is_opaque);
+}
+
+void ConvertBGRAtoRGB_SSSE3(const unsigned char* bgra, int pixel_width,
+                            unsigned char* rgb, bool* is_opaque) {
+  const __m128i shuffle = PackSwappedRGBShuffle();
+  int x = 0;
+  for (; x + 4 <= pixel_width; x += 4) {
+    const __m128i pixels =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(&bgra[x * 4]));
+    StoreRGB_SSSE3(_mm_shuffle_epi8(pixels, shuffle), &rgb[x * 3]);
+  }
+  ConvertBGRAtoRGB_C(&bgra[x * 4], pixel_width - x, &rgb[x * 3], is_opaque);
+}
+
+#if defined(PNG_ROW_CONVERTERS_SIMD_SKIA)
+
+#if SK_R32_SHIFT == 16
+#define SKIA_TO_RGBA_SHUFFLE SwapRedAndBlueShuffle
+#define SKIA_TO_RGB_SHUFFLE PackSwappedRGBShuffle
+#else
+#define SKIA_TO_RGB_SHUFFLE PackRGBShuffle
+#endif
+
+void ConvertSkiatoRGBA_SSSE3(const unsigned char* skia, int pixel_width,
+                             unsigned char* rgba, bool* is_opaque) {
+#if defined(SKIA_TO_RGBA_SHUFFLE)
+  const __m128i shuffle = SKIA_TO_RGBA_SHUFFLE();
+#endif
+  int x = 0;
+  for (; x + 4 <= pixel_width; x += 4) {
+    __m128i pixels =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(&skia[x * 4]));
+    if (!AreOpaqueOrTransparent_SSE2(pixels)) {
+      ConvertSkiatoRGBA_C(&skia[x * 4], 4, &rgba[x * 4], is_opaque);
+      continue;
+    }
+#if defined(SKIA_TO_RGBA_SHUFFLE)
+    pixels = _mm_shuffle_epi8(pixels, shuffle);
+#endif
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&rgba[x * 4]), pixels);
+  }
+  ConvertSkiatoRGBA_C(&skia[x * 4], pixel_width - x, &rgba[x * 4], is_opaque);
+}
+
+void ConvertSkiatoRGB_SSSE3(const unsigned char* skia, int pixel_width,
+                            unsigned char* rgb, bool* is_opaque) {
+  const __m128i shuffle = SKIA_TO_RGB_SHUFFLE();
+  int x = 0;
+  for (; x + 4 <= pixel_width; x += 4) {
+    const __m128i pixels =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(&skia[x * 4]));
+    if (!AreOpaqueOrTransparent_SSE2(pixels)) {
+      ConvertSkiatoRGB_C(&skia[x * 4], 4, &rgb[x * 3], is_opaque);
+      continue;
+    }
+    StoreRGB_SSSE3(_mm_shuffle_epi8(pixels, shuffle), &rgb[x * 3]);
+  }
+  ConvertSkiatoRGB_C(&skia[x * 4], pixel_width - x, &rgb[x * 3], is_opaque);
+}
+
+void ConvertRGBAtoSkia_SSSE3(const unsigned char* rgba, int pixel_width,
+                             unsigned char* skia, bool* is_opaque) {
+#if defined(SKIA_TO_RGBA_SHUFFLE)
+  // The shuffle swaps red and blue both ways.
+  const __m128i shuffle = SKIA_TO_RGBA_SHUFFLE();
+#endif
+  int x = 0;
+  for (; x + 4 <= pixel_width; x += 4) {
+    __m128i pixels =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(&rgba[x * 4]));
+    if (!AreOpaque_SSE2(pixels)) {
+      *is_opaque = false;
+      pixels = Premultiply_SSE2(pixels);
+    }
+#if defined(SKIA_TO_RGBA_SHUFFLE)
+    pixels = _mm_shuffle_epi8(pixels, shuffle);
+#endif
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&skia[x * 4]), pixels);
+  }
+  ConvertRGBAtoSkia_C(&rgba[x * 4], pixel_width - x, &skia[x * 4], is_opaque);
+}
+
+#undef SKIA_TO_RGBA_SHUFFLE
+#undef SKIA_TO_RGB_SHUFFLE
+
+#endif  // defined(PNG_ROW_CONVERTERS_SIMD_SKIA)
+
+#endif  // defined(PNG_ROW_CONVERTERS_SSE2) && defined(PNG_ROW_CONVERTERS_SSSE3)
+
+// Tables ----------------------------------------------------------------------
+
+const PNGRowConverters kConverters_C = {
+  PNGRowConverters::LEVEL_C,
+  ConvertBetweenBGRAandRGBA_C,
+  ConvertRGBAtoRGB_C,
+  ConvertBGRAtoRGB_C,
+  ConvertSkiatoRGBA_C,
+  ConvertSkiatoRGB_C,
+  ConvertRGBAtoSkia_C,
+};
+
+#if defined(PNG_ROW_CONVERTERS_SSE2)
+// SSE2 has no byte shuffle, so packing to RGB is left to C.
+const PNGRowConverters kConverters_SSE2 = {
+  PNGRowConverters::LEVEL_SSE2,
+  ConvertBetweenBGRAandRGBA_SSE2,
+  ConvertRGBAtoRGB_C,
+  ConvertBGRAtoRGB_C,
+#if defined(PNG_ROW_CONVERTERS_SIMD_SKIA)
+  ConvertSkiatoRGBA_SSE2,
+  ConvertSkiatoRGB_C,
+  ConvertRGBAtoSkia_SSE2,
+#else
+  ConvertSkiatoRGBA_C,
+  ConvertSkiatoRGB_C,
+  ConvertRGBAtoSkia_C,
+#endif
+};
+#endif  // defined(PNG_ROW_CONVERTERS_SSE2)
+
+#if defined(PNG_ROW_CONVERTERS_SSE2) && defined(PNG_ROW_CONVERTERS_SSSE3)
+const PNGRowConverters kConverters_SSSE3 = {
+  PNGRowConverters::LEVEL_SSSE3,
+  ConvertBetweenBGRAandRGBA_SSSE3,
+  ConvertRGBAtoRGB_SSSE3,
+  ConvertBGRAtoRGB_SSSE3,
+#if defined(PNG_ROW_CONVERTERS_SIMD_SKIA)
+  ConvertSkiatoRGBA_SSSE3,
+  ConvertSkiatoRGB_SSSE3,
+  ConvertRGBAtoSkia_SSSE3,
+#else
+  ConvertSkiatoRGBA_C,
+  ConvertSkiatoRGB_C,
+  ConvertRGBAtoSkia_C,
+#endif
+};
+#endif
+
+#if defined(PNG_ROW_CONVERTERS_SSE2)
+// The CPU is only queried once, not every time converters are looked up.
+base::LazyInstance<base::CPU>::Leaky g_cpu = LAZY_INSTANCE_INITIALIZER;
+#endif
+
+}  // namespace
+
+// static
+const PNGRowConverters& PNGRowConverters::Get() {
+  return GetForLevel(LEVEL_SSSE3);
+}
+
+// static
+const PNGRowConverters& PNGRowConverters::GetForLevel(Level level) {
+#if defined(PNG_ROW_CONVERTERS_SSE2)
+  const base::CPU& cpu = g_cpu.Get();
+#if defined(PNG_ROW_CONVERTERS_SSSE3)
+  if (level >= LEVEL_SSSE3 && cpu.has_ssse3())
+    return kConverters_SSSE3;
+#endif
+  if (level >= LEVEL_SSE2 && cpu.has_sse2())
+    return kConverters_SSE2;
+#endif
+  return kConverters_C;
+}
+
+}  // namespace gfx
@@ -0,0 +1,64 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef UI_GFX_CODEC_PNG_ROW_CONVERTERS_H_
+#define UI_GFX_CODEC_PNG_ROW_CONVERTERS_H_
+
+#include "base/basictypes.h"
+#include "uibase/ui_export.h"
+
+namespace gfx {
+
+// The functions PNGCodec uses to convert rows of pixels between the formats
+// it accepts and the formats libpng reads and writes. There is a plain C
+// version of each, and SSE2 and SSSE3 versions picked at runtime with
+// base::CPU when the build supports them.
+//
+// Premultiplying is done with SIMD for every pixel. Unpremultiplying needs a
+// division per pixel, so the SIMD versions only speed up runs of opaque or
+// fully transparent pixels, which is what screenshots and most clipboard
+// images are made of, and do the other pixels one at a time.
+struct UI_EXPORT PNGRowConverters {
+  enum Level {
+    LEVEL_C,
+    LEVEL_SSE2,
+    LEVEL_SSSE3
+  };
+
+  // Converts |pixel_width| pixels from |input| to |output|. Only
+  // |rgba_to_skia| uses |is_opaque|; it may be NULL for the others.
+  typedef void (*Converter)(const unsigned char* input, int pixel_width,
+                            unsigned char* output, bool* is_opaque);
+
+  // Returns the fastest converters the CPU supports.
+  static const PNGRowConverters& Get();
+
+  // Returns the converters of |level|, or of the highest level below it that
+  // the CPU and the build support. For measuring the levels against each
+  // other.
+  static const PNGRowConverters& GetForLevel(Level level);
+
+  // The level of these converters.
+  Level level;
+
+  // BGRA to RGBA. Also converts RGBA to BGRA.
+  Converter bgra_to_rgba;
+
+  // RGBA and BGRA to packed RGB, dropping the alpha.
+  Converter rgba_to_rgb;
+  Converter bgra_to_rgb;
+
+  // Premultiplied Skia pixels to unpremultiplied RGBA, and to packed RGB
+  // dropping the alpha.
+  Converter skia_to_rgba;
+  Converter skia_to_rgb;
+
+  // Unpremultiplied RGBA to premultiplied Skia pixels, clearing |*is_opaque|
+  // if a pixel is not opaque. |input| and |output| may be the same row.
+  Converter rgba_to_skia;
+};
+
+}  // namespace gfx
+
+#endif  // UI_GFX_CODEC_PNG_ROW_CONVERTERS_H_
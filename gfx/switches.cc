@@ -12,6 +12,10 @@ namespace switches {
 const char kDisableScalingInImageSkiaOperations[] =
     "disable-scaling-in-image-skia-operations";
 
+// Disables the cache of measured text sizes used by Canvas::SizeStringInt(),
+// so that every measurement reshapes the string.
+const char kDisableTextSizeCache[] = "disable-text-size-cache";
+
 // Let text glyphs have X-positions that aren't snapped to the pixel grid in
 // the browser UI.
 const char kEnableBrowserTextSubpixelPositioning[] =
@@ -11,6 +11,7 @@ namespace gfx {
 namespace switches {
 
 UI_EXPORT extern const char kDisableScalingInImageSkiaOperations[];
+UI_EXPORT extern const char kDisableTextSizeCache[];
 UI_EXPORT extern const char kEnableBrowserTextSubpixelPositioning[];
 UI_EXPORT extern const char kEnableWebkitTextSubpixelPositioning[];
 
@@ -0,0 +1,190 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gfx/text_size_cache.h"
+
+#include "base/command_line.h"
+#include "base/memory/singleton.h"
+#include "gfx/font.h"
+#include "gfx/switches.h"
+
+namespace gfx {
+
+TextSizeCache::Key::Key()
+    : font_size(0),
+      font_style(0),
+      flags(0),
+      width(0) {
+}
+
+TextSizeCache::Key::~Key() {
+}
+
+bool TextSizeCache::Key::operator<(const Key& other) const {
+  // Compare the cheap integer fields first so that most misses never touch
+  // the strings.
+  if (font_size != other.font_size)
+    return font_size < other.font_size;
+  if (font_style != other.font_style)
+    return font_style < other.font_style;
+  if (flags != other.flags)
+    return flags < other.flags;
+  if (width != other.width)
+    return width < other.width;
+  if (text.length() != other.text.length())
+    return text.length() < other.text.length();
+  int result = text.compare(other.text);
+  if (result != 0)
+    return result < 0;
+  return font_name < other.font_name;
+}
+
+// static
+TextSizeCache* TextSizeCache::GetInstance() {
+  return Singleton<TextSizeCache>::get();
+}
+
+bool TextSizeCache::Lookup(const string16& text,
+                           const Font& font,
+                           int flags,
+                           int width,
+                           Size* size) {
+  if (text.length() > kMaxCachedTextLength)
+    return false;
+
+  Key key = MakeKey(text, font, flags, width);
+
+  base::AutoLock lock(lock_);
+  if (!enabled_)
+    return false;
+
+  EntryMap::iterator it = index_.find(key);
+  if (it == index_.end()) {
+    ++miss_count_;
+    return false;
+  }
+
+  ++hit_count_;
+  // Move the entry to the front of the recency list.
+  entries_.splice(entries_.begin(), entries_, it->second);
+  *size = it->second->size;
+  return true;
+}
+
+void TextSizeCache::Insert(const string16& text,
+                           const Font& font,
+                           int flags,
+                           int width,
+                           const Size& size) {
+  if (text.length() > kMaxCachedTextLength)
+    return;
+
+  Entry entry;
+  entry.key = MakeKey(text, font, flags, width);
+  entry.size = size;
+
+  base::AutoLock lock(lock_);
+  if (!enabled_ || max_entries_ == 0)
+    return;
+
+  EntryMap::iterator it = index_.find(entry.key);
+  if (it != index_.end()) {
+    // Another thread measured the same string concurrently.
+    it->second->size = size;
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return;
+  }
+
+  entries_.push_front(entry);
+  index_[entry.key] = entries_.begin();
+  EvictIfNeeded();
+}
+
+void TextSizeCache::Clear() {
+  base::AutoLock lock(lock_);
+  index_.clear();
+  entries_.clear();
+}
+
+void TextSizeCache::ResetCounters() {
+  base::AutoLock lock(lock_);
+  hit_count_ = 0;
+  miss_count_ = 0;
+}
+
+bool TextSizeCache::enabled() const {
+  base::AutoLock lock(lock_);
+  return enabled_;
+}
+
+void TextSizeCache::set_enabled(bool enabled) {
+  base::AutoLock lock(lock_);
+  enabled_ = enabled;
+  if (!enabled_) {
+    index_.clear();
+    entries_.clear();
+  }
+}
+
+size_t TextSizeCache::max_entries() const {
+  base::AutoLock lock(lock_);
+  return max_entries_;
+}
+
+void TextSizeCache::set_max_entries(size_t max_entries) {
+  base::AutoLock lock(lock_);
+  max_entries_ = max_entries;
+  EvictIfNeeded();
+}
+
+size_t TextSizeCache::size() const {
+  base::AutoLock lock(lock_);
+  return entries_.size();
+}
+
+size_t TextSizeCache::hit_count() const {
+  base::AutoLock lock(lock_);
+  return hit_count_;
+}
+
+size_t TextSizeCache::miss_count() const {
+  base::AutoLock lock(lock_);
+  return miss_count_;
+}
+
+TextSizeCache::TextSizeCache()
+    : enabled_(!CommandLine::ForCurrentProcess()->HasSwitch(
+          switches::kDisableTextSizeCache)),
+      max_entries_(kDefaultMaxEntries),
+      hit_count_(0),
+      miss_count_(0) {
+}
+
+TextSizeCache::~TextSizeCache() {
+}
+
+// static
+TextSizeCache::Key TextSizeCache::MakeKey(const string16& text,
+                                          const Font& font,
+                                          int flags,
+                                          int width) {
+  Key key;
+  key.text = text;
+  key.font_name = font.GetFontName();
+  key.font_size = font.GetFontSize();
+  key.font_style = font.GetStyle();
+  key.flags = flags;
+  key.width = width;
+  return key;
+}
+
+void TextSizeCache::EvictIfNeeded() {
+  lock_.AssertAcquired();
+  while (entries_.size() > max_entries_) {
+    index_.erase(entries_.back().key);
+    entries_.pop_back();
+  }
+}
+
+}  // namespace gfx
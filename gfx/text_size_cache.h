@@ -0,0 +1,132 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef UI_GFX_TEXT_SIZE_CACHE_H_
+#define UI_GFX_TEXT_SIZE_CACHE_H_
+
+#include <list>
+#include <map>
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/string16.h"
+#include "base/synchronization/lock.h"
+#include "uibase/ui_export.h"
+#include "gfx/size.h"
+
+template <typename T> struct DefaultSingletonTraits;
+
+namespace gfx {
+
+class Font;
+
+// TextSizeCache is a bounded, thread-safe LRU cache of measured text sizes
+// used by Canvas::SizeStringInt(). Shaping a string through RenderText is
+// expensive, and layout code (labels, menus, table columns) measures the same
+// strings with the same fonts over and over, so the result of each
+// measurement is remembered keyed on the text, the font and the Canvas flags.
+//
+// The cache can be turned off with the --disable-text-size-cache switch, or
+// at runtime with set_enabled(false).
+class UI_EXPORT TextSizeCache {
+ public:
+  // Default maximum number of entries kept before the least recently used
+  // entry is evicted.
+  static const size_t kDefaultMaxEntries = 2048;
+
+  // Strings longer than this are never cached; they are rarely re-measured
+  // and would make the cache memory usage unbounded.
+  static const size_t kMaxCachedTextLength = 1024;
+
+  static TextSizeCache* GetInstance();
+
+  // Looks up the size of |text| drawn with |font| and |flags|. |width| is the
+  // available width and is only significant for multi-line measurement.
+  // Returns true and fills |size| on a hit.
+  bool Lookup(const string16& text,
+              const Font& font,
+              int flags,
+              int width,
+              Size* size);
+
+  // Records |size| as the measured size of |text| with |font| and |flags|,
+  // evicting the least recently used entry if the cache is full.
+  void Insert(const string16& text,
+              const Font& font,
+              int flags,
+              int width,
+              const Size& size);
+
+  // Drops every cached entry. Counters are left untouched.
+  void Clear();
+
+  // Resets the hit and miss counters to zero.
+  void ResetCounters();
+
+  bool enabled() const;
+  void set_enabled(bool enabled);
+
+  size_t max_entries() const;
+  void set_max_entries(size_t max_entries);
+
+  size_t size() const;
+  size_t hit_count() const;
+  size_t miss_count() const;
+
+ private:
+  friend struct DefaultSingletonTraits<TextSizeCache>;
+
+  struct Key {
+    Key();
+    ~Key();
+
+    bool operator<(const Key& other) const;
+
+    string16 text;
+    std::string font_name;
+    int font_size;
+    int font_style;
+    int flags;
+    int width;
+  };
+
+  struct Entry {
+    Key key;
+    Size size;
+  };
+
+  typedef std::list<Entry> EntryList;
+  typedef std::map<Key, EntryList::iterator> EntryMap;
+
+  TextSizeCache();
+  ~TextSizeCache();
+
+  static Key MakeKey(const string16& text,
+                     const Font& font,
+                     int flags,
+                     int width);
+
+  // Removes least recently used entries until at most |max_entries_| remain.
+  // |lock_| must be held.
+  void EvictIfNeeded();
+
+  // Guards every member below.
+  mutable base::Lock lock_;
+
+  bool enabled_;
+  size_t max_entries_;
+
+  // Most recently used entries are at the front.
+  EntryList entries_;
+  EntryMap index_;
+
+  size_t hit_count_;
+  size_t miss_count_;
+
+  DISALLOW_COPY_AND_ASSIGN(TextSizeCache);
+};
+
+}  // namespace gfx
+
+#endif  // UI_GFX_TEXT_SIZE_CACHE_H_
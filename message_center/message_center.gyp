@@ -36,6 +36,8 @@
         'message_center_constants.cc',
         'message_center_constants.h',
         'message_center_export.h',
+        'message_list_view.cc',
+        'message_list_view.h',
         'message_popup_bubble.cc',
         'message_popup_bubble.h',
         'message_simple_view.cc',
@@ -68,5 +70,21 @@
         'notification_list_unittest.cc',
       ],
     },
+    {
+      'target_name': 'message_list_view_bench',
+      'type': 'executable',
+      'dependencies': [
+        '../../base/base.gyp:base',
+        '../../skia/skia.gyp:skia',
+        '../ui.gyp:ui',
+        'message_center',
+      ],
+      'include_dirs': [
+        '..',
+      ],
+      'sources': [
+        'message_list_view_bench.cc',
+      ],
+    },
   ],
 }
@@ -8,8 +8,7 @@
 #include "uibase/l10n/l10n_util.h"
 #include "uibase/resource/resource_bundle.h"
 #include "gfx/size.h"
-#include "message_center/message_view.h"
-#include "message_center/message_view_factory.h"
+#include "message_center/message_list_view.h"
 #include "views/controls/button/text_button.h"
 #include "views/controls/label.h"
 #include "views/controls/scroll_view.h"
@@ -135,9 +134,11 @@ class FixedSizedScrollView : public views::ScrollView {
 };
 
 // Container for the messages.
-class ScrollContentView : public views::View {
+class ScrollContentView : public MessageListView {
  public:
-  ScrollContentView() {
+  ScrollContentView(NotificationList::Delegate* list_delegate,
+                    views::ScrollView* scroller)
+      : MessageListView(list_delegate, scroller) {
     views::BoxLayout* layout =
         new views::BoxLayout(views::BoxLayout::kVertical, 0, 0, 1);
     layout->set_spread_blank_space(true);
@@ -165,13 +166,12 @@ class ScrollContentView : public views::View {
 // Message Center contents.
 class MessageCenterContentsView : public views::View {
  public:
-  explicit MessageCenterContentsView(NotificationList::Delegate* list_delegate)
-      : list_delegate_(list_delegate) {
+  explicit MessageCenterContentsView(NotificationList::Delegate* list_delegate) {
     SetLayoutManager(
         new views::BoxLayout(views::BoxLayout::kVertical, 0, 0, 1));
 
-    scroll_content_ = new ScrollContentView;
     scroller_ = new FixedSizedScrollView;
+    scroll_content_ = new ScrollContentView(list_delegate, scroller_);
     scroller_->SetContents(scroll_content_);
     AddChildView(scroller_);
 
@@ -181,34 +181,32 @@ class MessageCenterContentsView : public views::View {
 
     button_view_ = new WebNotificationButtonView(list_delegate);
     AddChildView(button_view_);
+
+    no_message_label_.reset(new views::Label(l10n_util::GetStringUTF16(
+        IDS_MESSAGE_CENTER_NO_MESSAGES)));
+    no_message_label_->set_owned_by_client();
+    no_message_label_->SetFont(no_message_label_->font().DeriveFont(1));
+    no_message_label_->SetEnabledColor(SK_ColorGRAY);
   }
 
   void FocusContents() {
     scroller_->RequestFocus();
   }
 
-  void Update(const NotificationList::Notifications& notifications)  {
-    scroll_content_->RemoveAllChildViews(true);
-    scroll_content_->set_preferred_size(gfx::Size());
-    size_t num_children = 0;
-    for (NotificationList::Notifications::const_iterator iter =
-             notifications.begin(); iter != notifications.end(); ++iter) {
-      MessageView* view =
-          MessageViewFactory::ViewForNotification(*iter, list_delegate_);
-      view->set_scroller(scroller_);
-      view->SetUpView();
-      scroll_content_->AddChildView(view);
-      if (++num_children >=
-          NotificationList::kMaxVisibleMessageCenterNotifications) {
-        break;
-      }
+  void Update(const NotificationList::NotificationPointers& notifications) {
+    // The label isn't one of the list's message views; take it out while
+    // the list updates its children.
+    if (no_message_label_->parent())
+      scroll_content_->RemoveChildView(no_message_label_.get());
+    if (!scroll_content_->Update(notifications) &&
+        scroll_content_->NumMessageViews() > 0) {
+      // Nothing to relayout or repaint.
+      return;
     }
-    if (num_children == 0) {
-      views::Label* label = new views::Label(l10n_util::GetStringUTF16(
-          IDS_MESSAGE_CENTER_NO_MESSAGES));
-      label->SetFont(label->font().DeriveFont(1));
-      label->SetEnabledColor(SK_ColorGRAY);
-      scroll_content_->AddChildView(label);
+
+    scroll_content_->set_preferred_size(gfx::Size());
+    if (scroll_content_->NumMessageViews() == 0) {
+      scroll_content_->AddChildView(no_message_label_.get());
       button_view_->SetCloseAllVisible(false);
     } else {
       button_view_->SetCloseAllVisible(true);
@@ -220,7 +218,7 @@ class MessageCenterContentsView : public views::View {
   }
 
   size_t NumMessageViews() const {
-    return scroll_content_->child_count();
+    return scroll_content_->NumMessageViews();
   }
 
  private:
@@ -241,11 +239,13 @@ class MessageCenterContentsView : public views::View {
     scroll_content_->InvalidateLayout();
   }
 
-  NotificationList::Delegate* list_delegate_;
   FixedSizedScrollView* scroller_;
   ScrollContentView* scroll_content_;
   WebNotificationButtonView* button_view_;
 
+  // Shown in place of the messages when there are none.
+  scoped_ptr<views::Label> no_message_label_;
+
   DISALLOW_COPY_AND_ASSIGN(MessageCenterContentsView);
 };
 
@@ -282,8 +282,9 @@ void MessageCenterBubble::OnBubbleViewDestroyed() {
 void MessageCenterBubble::UpdateBubbleView() {
   if (!bubble_view())
     return;  // Could get called after view is closed
-  NotificationList::Notifications notifications;
-  list_delegate()->GetNotificationList()->GetNotifications(&notifications);
+  NotificationList::NotificationPointers notifications;
+  list_delegate()->GetNotificationList()->GetTopNotifications(
+      NotificationList::kMaxVisibleMessageCenterNotifications, &notifications);
   contents_view_->Update(notifications);
   bubble_view()->Show();
   bubble_view()->UpdateBubble();
@@ -0,0 +1,122 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "message_center/message_list_view.h"
+
+#include "message_center/message_view.h"
+#include "message_center/message_view_factory.h"
+#include "views/layout/box_layout.h"
+
+namespace message_center {
+
+namespace {
+
+bool SameItems(const std::vector<NotificationList::NotificationItem>& a,
+               const std::vector<NotificationList::NotificationItem>& b) {
+  if (a.size() != b.size())
+    return false;
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (a[i].title != b[i].title || a[i].message != b[i].message)
+      return false;
+  }
+  return true;
+}
+
+// Returns true if a view set up for |a| shows the same thing as one set up
+// for |b|.
+bool SameContent(const NotificationList::Notification& a,
+                 const NotificationList::Notification& b) {
+  return a.type == b.type &&
+      a.id == b.id &&
+      a.title == b.title &&
+      a.message == b.message &&
+      a.display_source == b.display_source &&
+      a.extension_id == b.extension_id &&
+      a.priority == b.priority &&
+      a.timestamp == b.timestamp &&
+      a.unread_count == b.unread_count &&
+      a.button_one_title == b.button_one_title &&
+      a.button_two_title == b.button_two_title &&
+      a.expanded_message == b.expanded_message &&
+      SameItems(a.items, b.items) &&
+      a.primary_icon.BackedBySameObjectAs(b.primary_icon) &&
+      a.secondary_icon.BackedBySameObjectAs(b.secondary_icon) &&
+      a.is_read == b.is_read;
+}
+
+}  // namespace
+
+MessageListView::MessageListView(NotificationList::Delegate* list_delegate,
+                                 views::ScrollView* scroller)
+    : list_delegate_(list_delegate),
+      scroller_(scroller) {
+  SetLayoutManager(
+      new views::BoxLayout(views::BoxLayout::kVertical, 0, 0, 1));
+}
+
+MessageListView::~MessageListView() {
+}
+
+bool MessageListView::Update(
+    const NotificationList::NotificationPointers& notifications) {
+  MessageViews old_views;
+  old_views.swap(views_);
+
+  bool changed = false;
+  std::vector<MessageView*> new_views;
+  for (size_t i = 0; i < notifications.size(); ++i) {
+    const NotificationList::Notification& notification = *notifications[i];
+    MessageView* view = NULL;
+    MessageViews::iterator old_view = old_views.find(notification.id);
+    if (old_view != old_views.end()) {
+      view = old_view->second;
+      old_views.erase(old_view);
+      if (!SameContent(view->notification(), notification)) {
+        RemoveChildView(view);
+        delete view;
+        view = NULL;
+        changed = true;
+      }
+    }
+    if (!view)
+      view = CreateView(notification);
+    views_[notification.id] = view;
+    new_views.push_back(view);
+  }
+
+  // Whatever is left in |old_views| is no longer shown.
+  for (MessageViews::iterator iter = old_views.begin();
+       iter != old_views.end(); ++iter) {
+    RemoveChildView(iter->second);
+    delete iter->second;
+    changed = true;
+  }
+
+  for (size_t i = 0; i < new_views.size(); ++i) {
+    MessageView* view = new_views[i];
+    if (i < static_cast<size_t>(child_count()) && child_at(i) == view)
+      continue;
+    if (view->parent() == this)
+      ReorderChildView(view, i);
+    else
+      AddChildViewAt(view, i);
+    changed = true;
+  }
+  DCHECK_EQ(static_cast<size_t>(child_count()), new_views.size());
+
+  if (changed)
+    InvalidateLayout();
+  return changed;
+}
+
+MessageView* MessageListView::CreateView(
+    const NotificationList::Notification& notification) {
+  MessageView* view =
+      MessageViewFactory::ViewForNotification(notification, list_delegate_);
+  view->set_scroller(scroller_);
+  view->SetUpView();
+  return view;
+}
+
+}  // namespace message_center
@@ -0,0 +1,58 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef UI_MESSAGE_CENTER_MESSAGE_LIST_VIEW_H_
+#define UI_MESSAGE_CENTER_MESSAGE_LIST_VIEW_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "message_center/message_center_export.h"
+#include "message_center/notification_list.h"
+#include "views/view.h"
+
+namespace views {
+class ScrollView;
+}
+
+namespace message_center {
+
+class MessageView;
+
+// A vertical list of MessageViews, one per notification. Update() diffs the
+// list against the views it already has: the view of a notification that
+// didn't change is kept, and only new or changed notifications get a new
+// view, so that a burst of notifications doesn't rebuild every row.
+class MESSAGE_CENTER_EXPORT MessageListView : public views::View {
+ public:
+  MessageListView(NotificationList::Delegate* list_delegate,
+                  views::ScrollView* scroller);
+  virtual ~MessageListView();
+
+  // Shows |notifications|, in order. Returns true if any view was added,
+  // removed or moved.
+  bool Update(const NotificationList::NotificationPointers& notifications);
+
+  size_t NumMessageViews() const { return views_.size(); }
+
+ private:
+  typedef std::map<std::string, MessageView*> MessageViews;
+
+  // Creates and sets up a view for |notification|.
+  MessageView* CreateView(
+      const NotificationList::Notification& notification);
+
+  NotificationList::Delegate* list_delegate_;
+  views::ScrollView* scroller_;
+
+  // The views in the list, by notification id.
+  MessageViews views_;
+
+  DISALLOW_COPY_AND_ASSIGN(MessageListView);
+};
+
+}  // namespace message_center
+
+#endif  // UI_MESSAGE_CENTER_MESSAGE_LIST_VIEW_H_
@@ -0,0 +1,187 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// This small program stress tests the message center under a notification
+// storm. It adds a number of notifications one at a time, and after each one
+// does what MessageCenterBubble::UpdateBubbleView() does on the UI thread:
+// gets the notifications from the NotificationList and updates the list of
+// MessageViews, then lays it out. The list is updated once by copying every
+// notification and rebuilding every view the way the bubbles used to, and
+// once with NotificationList::GetTopNotifications() and MessageListView,
+// which keeps the views of the notifications that didn't change. The total
+// UI thread time is printed, split between the NotificationList and the
+// views.
+
+#include <stdio.h>
+
+#include <string>
+
+#include "base/at_exit.h"
+#include "base/basictypes.h"
+#include "base/command_line.h"
+#include "base/file_path.h"
+#include "base/message_loop.h"
+#include "base/path_service.h"
+#include "base/string_number_conversions.h"
+#include "base/time.h"
+#include "base/utf_string_conversions.h"
+#include "message_center/message_list_view.h"
+#include "message_center/message_view.h"
+#include "message_center/message_view_factory.h"
+#include "message_center/notification_list.h"
+#include "notifications/notification_types.h"
+#include "uibase/resource/resource_bundle.h"
+
+namespace {
+
+const int kDefaultNotifications = 10000;
+const int kListWidth = 320;
+
+class BenchDelegate : public message_center::NotificationList::Delegate {
+ public:
+  BenchDelegate() : notification_list_(this) {}
+
+  // Overridden from NotificationList::Delegate.
+  virtual void SendRemoveNotification(const std::string& id) OVERRIDE {}
+  virtual void SendRemoveAllNotifications() OVERRIDE {}
+  virtual void DisableNotificationByExtension(const std::string& id) OVERRIDE {}
+  virtual void DisableNotificationByUrl(const std::string& id) OVERRIDE {}
+  virtual void ShowNotificationSettings(const std::string& id) OVERRIDE {}
+  virtual void OnNotificationClicked(const std::string& id) OVERRIDE {}
+  virtual void OnQuietModeChanged(bool quiet_mode) OVERRIDE {}
+  virtual void OnButtonClicked(const std::string& id,
+                               int button_index) OVERRIDE {}
+  virtual message_center::NotificationList* GetNotificationList() OVERRIDE {
+    return &notification_list_;
+  }
+
+ private:
+  message_center::NotificationList notification_list_;
+
+  DISALLOW_COPY_AND_ASSIGN(BenchDelegate);
+};
+
+// Updates |container| by deleting its views and creating one per
+// notification, the way the bubbles did before MessageListView.
+void RebuildViews(
+    views::View* container,
+    const message_center::NotificationList::Notifications& notifications,
+    message_center::NotificationList::Delegate* delegate) {
+  container->RemoveAllChildViews(true);
+  size_t num_children = 0;
+  for (message_center::NotificationList::Notifications::const_iterator iter =
+           notifications.begin(); iter != notifications.end(); ++iter) {
+    message_center::MessageView* view =
+        message_center::MessageViewFactory::ViewForNotification(*iter,
+                                                                delegate);
+    view->SetUpView();
+    container->AddChildView(view);
+    if (++num_children >= message_center::NotificationList::
+            kMaxVisibleMessageCenterNotifications) {
+      break;
+    }
+  }
+}
+
+// Adds |count| notifications to a new list and updates the views after each
+// one. Prints the time spent in the list and in the views.
+void RunStorm(const char* name, int count, bool recycle) {
+  BenchDelegate delegate;
+  message_center::NotificationList* list = delegate.GetNotificationList();
+  message_center::MessageListView list_view(&delegate, NULL);
+  views::View* container = &list_view;
+  scoped_ptr<views::View> rebuilt_container;
+  if (!recycle) {
+    rebuilt_container.reset(new views::View);
+    container = rebuilt_container.get();
+  }
+
+  base::TimeDelta list_time;
+  base::TimeDelta views_time;
+  for (int i = 0; i < count; ++i) {
+    base::TimeTicks start = base::TimeTicks::HighResNow();
+    list->AddNotification(
+        ui::notifications::NOTIFICATION_TYPE_SIMPLE,
+        "notification" + base::IntToString(i),
+        ASCIIToUTF16("Monitoring alert"),
+        ASCIIToUTF16("Host " + base::IntToString(i % 97) + " is unreachable"),
+        ASCIIToUTF16("monitoring"),
+        std::string(),
+        NULL);
+    message_center::NotificationList::Notifications notifications;
+    message_center::NotificationList::NotificationPointers top_notifications;
+    if (recycle) {
+      list->GetTopNotifications(message_center::NotificationList::
+                                    kMaxVisibleMessageCenterNotifications,
+                                &top_notifications);
+    } else {
+      list->GetNotifications(&notifications);
+    }
+    base::TimeTicks list_done = base::TimeTicks::HighResNow();
+
+    if (recycle)
+      list_view.Update(top_notifications);
+    else
+      RebuildViews(container, notifications, &delegate);
+    container->SetBounds(0, 0, kListWidth,
+                         container->GetHeightForWidth(kListWidth));
+    container->Layout();
+    base::TimeTicks views_done = base::TimeTicks::HighResNow();
+
+    list_time += list_done - start;
+    views_time += views_done - list_done;
+  }
+
+  printf("%-9s %10.1f %10.1f %10.1f %12.3f\n",
+         name,
+         list_time.InMillisecondsF(),
+         views_time.InMillisecondsF(),
+         (list_time + views_time).InMillisecondsF(),
+         (list_time + views_time).InMillisecondsF() / count);
+}
+
+void Usage() {
+  printf("message_list_view_bench [-notifications n] [-resources path] "
+         "[-help]\n"
+         "  -notifications n: notifications to add (default:%d)\n"
+         "  -resources path: resource file (default: default_skin.dll next\n"
+         "      to the executable)\n"
+         "  -help: prints this help and exits\n",
+         kDefaultNotifications);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  base::AtExitManager exit_manager;
+  CommandLine::Init(argc, argv);
+  const CommandLine* command_line = CommandLine::ForCurrentProcess();
+
+  int count = kDefaultNotifications;
+  if (command_line->HasSwitch("help") ||
+      (command_line->HasSwitch("notifications") &&
+       !base::StringToInt(command_line->GetSwitchValueASCII("notifications"),
+                          &count)) ||
+      count <= 0) {
+    Usage();
+    return 1;
+  }
+
+  FilePath res_path = command_line->GetSwitchValuePath("resources");
+  if (res_path.empty()) {
+    PathService::Get(base::DIR_EXE, &res_path);
+    res_path = res_path.AppendASCII("default_skin.dll");
+  }
+  ui::ResourceBundle::InitSharedInstanceWithLocale(res_path.MaybeAsASCII(),
+                                                   NULL);
+  MessageLoop message_loop(MessageLoop::TYPE_UI);
+
+  printf("%-9s %10s %10s %10s %12s\n",
+         "mode", "list(ms)", "views(ms)", "total(ms)", "per-add(ms)");
+  RunStorm("rebuild", count, false);
+  RunStorm("recycle", count, true);
+
+  ui::ResourceBundle::CleanupSharedInstance();
+  return 0;
+}
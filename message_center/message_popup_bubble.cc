@@ -5,8 +5,7 @@
 #include "message_center/message_popup_bubble.h"
 
 #include "base/bind.h"
-#include "message_center/message_view.h"
-#include "message_center/message_view_factory.h"
+#include "message_center/message_list_view.h"
 #include "notifications/notification_types.h"
 #include "views/bubble/tray_bubble_view.h"
 #include "views/layout/box_layout.h"
@@ -41,14 +40,11 @@ std::vector<const NotificationList::Notification*> GetNewNotifications(
 // Popup notifications contents.
 class PopupBubbleContentsView : public views::View {
  public:
-  explicit PopupBubbleContentsView(NotificationList::Delegate* list_delegate)
-      : list_delegate_(list_delegate) {
+  explicit PopupBubbleContentsView(NotificationList::Delegate* list_delegate) {
     SetLayoutManager(
         new views::BoxLayout(views::BoxLayout::kVertical, 0, 0, 1));
 
-    content_ = new views::View;
-    content_->SetLayoutManager(
-        new views::BoxLayout(views::BoxLayout::kVertical, 0, 0, 1));
+    content_ = new MessageListView(list_delegate, NULL);
     AddChildView(content_);
 
     content_->SetPaintToLayer(true);
@@ -57,15 +53,14 @@ class PopupBubbleContentsView : public views::View {
   }
 
   void Update(const NotificationList::Notifications& popup_notifications) {
-    content_->RemoveAllChildViews(true);
+    NotificationList::NotificationPointers notifications;
     for (NotificationList::Notifications::const_iterator iter =
              popup_notifications.begin();
          iter != popup_notifications.end(); ++iter) {
-      MessageView* view =
-          MessageViewFactory::ViewForNotification(*iter, list_delegate_);
-      view->SetUpView();
-      content_->AddChildView(view);
+      notifications.push_back(&(*iter));
     }
+    if (!content_->Update(notifications))
+      return;
     content_->SizeToPreferredSize();
     content_->InvalidateLayout();
     Layout();
@@ -74,12 +69,11 @@ class PopupBubbleContentsView : public views::View {
   }
 
   size_t NumMessageViews() const {
-    return content_->child_count();
+    return content_->NumMessageViews();
   }
 
  private:
-  NotificationList::Delegate* list_delegate_;
-  views::View* content_;
+  MessageListView* content_;
 
   DISALLOW_COPY_AND_ASSIGN(PopupBubbleContentsView);
 };
@@ -39,6 +39,11 @@ class MessageView : public views::SlideOutView,
 
   void set_scroller(views::ScrollView* scroller) { scroller_ = scroller; }
 
+  // The notification the view was created for.
+  const NotificationList::Notification& notification() const {
+    return notification_;
+  }
+
   // Overridden from views::View.
   virtual bool OnMousePressed(const ui::MouseEvent& event) OVERRIDE;
 
@@ -39,14 +39,7 @@ void NotificationList::SetMessageCenterVisible(bool visible) {
     // When the list is hidden, clear the unread count, and mark all
     // notifications as read and shown.
     unread_count_ = 0;
-    for (NotificationMap::iterator mapiter = notifications_.begin();
-         mapiter != notifications_.end(); ++mapiter) {
-      for (Notifications::iterator iter = mapiter->second.begin();
-           iter != mapiter->second.end(); ++iter) {
-        iter->is_read = true;
-        iter->shown_as_popup = true;
-      }
-    }
+    MarkAllAsReadAndShown();
   }
 }
 
@@ -145,6 +138,10 @@ bool NotificationList::RemoveNotification(const std::string& id) {
 
 void NotificationList::RemoveAllNotifications() {
   notifications_.clear();
+  notifications_by_id_.clear();
+  ids_by_source_.clear();
+  ids_by_extension_.clear();
+  unseen_ids_.clear();
   unread_count_ = 0;
 }
 
@@ -153,16 +150,11 @@ void NotificationList::SendRemoveNotificationsBySource(
   Notifications::iterator source_iter;
   if (!GetNotification(id, &source_iter))
     return;
-  string16 display_source = source_iter->display_source;
-  for (NotificationMap::iterator mapiter = notifications_.begin();
-       mapiter != notifications_.end(); ++mapiter) {
-    for (Notifications::iterator loopiter = mapiter->second.begin();
-         loopiter != mapiter->second.end(); ) {
-      Notifications::iterator curiter = loopiter++;
-      if (curiter->display_source == display_source)
-        delegate_->SendRemoveNotification(curiter->id);
-    }
-  }
+  SourceMap::const_iterator ids = ids_by_source_.find(
+      source_iter->display_source);
+  DCHECK(ids != ids_by_source_.end());
+  // The delegate may remove the notifications, so iterate over a copy.
+  SendRemoveNotifications(IdSet(ids->second));
 }
 
 void NotificationList::SendRemoveNotificationsByExtension(
@@ -170,16 +162,11 @@ void NotificationList::SendRemoveNotificationsByExtension(
   Notifications::iterator source_iter;
   if (!GetNotification(id, &source_iter))
     return;
-  std::string extension_id = source_iter->extension_id;
-  for (NotificationMap::iterator mapiter = notifications_.begin();
-       mapiter != notifications_.end(); ++mapiter) {
-    for (Notifications::iterator loopiter = mapiter->second.begin();
-         loopiter != mapiter->second.end(); ) {
-      Notifications::iterator curiter = loopiter++;
-      if (curiter->extension_id == extension_id)
-        delegate_->SendRemoveNotification(curiter->id);
-    }
-  }
+  ExtensionMap::const_iterator ids = ids_by_extension_.find(
+      source_iter->extension_id);
+  DCHECK(ids != ids_by_extension_.end());
+  // The delegate may remove the notifications, so iterate over a copy.
+  SendRemoveNotifications(IdSet(ids->second));
 }
 
 bool NotificationList::SetNotificationPrimaryIcon(const std::string& id,
@@ -209,9 +196,11 @@ bool NotificationList::HasNotification(const std::string& id) {
 bool NotificationList::HasPopupNotifications() {
   for (int i = ui::notifications::DEFAULT_PRIORITY;
        i <= ui::notifications::MAX_PRIORITY; ++i) {
-    Notifications notifications = notifications_[i];
-    if (!notifications.empty() && !notifications.front().shown_as_popup)
+    NotificationMap::const_iterator mapiter = notifications_.find(i);
+    if (mapiter != notifications_.end() && !mapiter->second.empty() &&
+        !mapiter->second.front().shown_as_popup) {
       return true;
+    }
   }
   return false;
 }
@@ -285,44 +274,60 @@ void NotificationList::GetNotifications(
   }
 }
 
-size_t NotificationList::NotificationCount() const {
-  size_t result = 0;
-  for (NotificationMap::const_iterator mapiter = notifications_.begin();
-       mapiter != notifications_.end(); ++mapiter) {
-    result += mapiter->second.size();
+void NotificationList::GetTopNotifications(
+    size_t max_count,
+    NotificationPointers* notifications) const {
+  DCHECK(notifications);
+  notifications->clear();
+  // Higher priority should come earlier.
+  for (NotificationMap::const_reverse_iterator mapiter =
+           notifications_.rbegin();
+       mapiter != notifications_.rend(); ++mapiter) {
+    for (Notifications::const_iterator iter = mapiter->second.begin();
+         iter != mapiter->second.end(); ++iter) {
+      if (notifications->size() >= max_count)
+        return;
+      notifications->push_back(&(*iter));
+    }
   }
-  return result;
+}
+
+size_t NotificationList::NotificationCount() const {
+  return notifications_by_id_.size();
 }
 
 void NotificationList::SetQuietModeInternal(bool quiet_mode) {
   quiet_mode_ = quiet_mode;
   if (quiet_mode_) {
-    for (NotificationMap::iterator mapiter = notifications_.begin();
-         mapiter != notifications_.end(); ++mapiter) {
-      for (Notifications::iterator iter = mapiter->second.begin();
-           iter != mapiter->second.end(); ++iter) {
-        iter->is_read = true;
-        iter->shown_as_popup = true;
-      }
-    }
+    MarkAllAsReadAndShown();
     unread_count_ = 0;
   }
   delegate_->OnQuietModeChanged(quiet_mode);
 }
 
+void NotificationList::MarkAllAsReadAndShown() {
+  for (base::hash_set<std::string>::const_iterator id = unseen_ids_.begin();
+       id != unseen_ids_.end(); ++id) {
+    IdMap::iterator iter = notifications_by_id_.find(*id);
+    DCHECK(iter != notifications_by_id_.end());
+    iter->second->is_read = true;
+    iter->second->shown_as_popup = true;
+  }
+  unseen_ids_.clear();
+}
+
+void NotificationList::SendRemoveNotifications(const IdSet& ids) {
+  for (IdSet::const_iterator id = ids.begin(); id != ids.end(); ++id)
+    delegate_->SendRemoveNotification(*id);
+}
+
 bool NotificationList::GetNotification(
     const std::string& id, Notifications::iterator* iter) {
-  for (NotificationMap::iterator mapiter = notifications_.begin();
-       mapiter != notifications_.end(); ++mapiter) {
-    for (Notifications::iterator curiter = mapiter->second.begin();
-         curiter != mapiter->second.end(); ++curiter) {
-      if (curiter->id == id) {
-        *iter = curiter;
-        return true;
-      }
-    }
-  }
-  return false;
+  IdMap::iterator found = notifications_by_id_.find(id);
+  if (found == notifications_by_id_.end())
+    return false;
+  *iter = found->second;
+  return true;
 }
 
 void NotificationList::EraseNotification(Notifications::iterator iter) {
@@ -330,6 +335,17 @@ void NotificationList::EraseNotification(Notifications::iterator iter) {
       iter->priority > ui::notifications::MIN_PRIORITY) {
     --unread_count_;
   }
+  notifications_by_id_.erase(iter->id);
+  SourceMap::iterator source = ids_by_source_.find(iter->display_source);
+  source->second.erase(iter->id);
+  if (source->second.empty())
+    ids_by_source_.erase(source);
+  ExtensionMap::iterator extension =
+      ids_by_extension_.find(iter->extension_id);
+  extension->second.erase(iter->id);
+  if (extension->second.empty())
+    ids_by_extension_.erase(extension);
+  unseen_ids_.erase(iter->id);
   notifications_[iter->priority].erase(iter);
 }
 
@@ -354,7 +370,13 @@ void NotificationList::PushNotification(Notification& notification) {
       notification.shown_as_popup = false;
     }
   }
-  notifications_[notification.priority].push_front(notification);
+  Notifications& notifications = notifications_[notification.priority];
+  notifications.push_front(notification);
+  notifications_by_id_[notification.id] = notifications.begin();
+  ids_by_source_[notification.display_source].insert(notification.id);
+  ids_by_extension_[notification.extension_id].insert(notification.id);
+  if (!notification.is_read || !notification.shown_as_popup)
+    unseen_ids_.insert(notification.id);
 }
 
 void NotificationList::GetPopupIterators(int priority,
@@ -7,8 +7,11 @@
 
 #include <list>
 #include <map>
+#include <set>
 #include <string>
+#include <vector>
 
+#include "base/hash_tables.h"
 #include "base/string16.h"
 #include "base/time.h"
 #include "base/timer.h"
@@ -64,6 +67,10 @@ class MESSAGE_CENTER_EXPORT NotificationList {
 
   typedef std::list<Notification> Notifications;
 
+  // Notifications owned by the list. The pointers are invalidated by the next
+  // change to the list.
+  typedef std::vector<const Notification*> NotificationPointers;
+
   class MESSAGE_CENTER_EXPORT Delegate {
    public:
     Delegate() {}
@@ -155,7 +162,15 @@ class MESSAGE_CENTER_EXPORT NotificationList {
   // specified time-delta from now.
   void EnterQuietModeWithExpire(const base::TimeDelta& expires_in);
 
+  // Copies all notifications to |notifications|, higher priority first and
+  // most recent first within a priority.
   void GetNotifications(Notifications* notifications) const;
+
+  // Like GetNotifications(), but returns at most |max_count| notifications,
+  // without copying them.
+  void GetTopNotifications(size_t max_count,
+                           NotificationPointers* notifications) const;
+
   size_t NotificationCount() const;
   size_t unread_count() const { return unread_count_; }
 
@@ -164,11 +179,16 @@ class MESSAGE_CENTER_EXPORT NotificationList {
 
  private:
   typedef std::map<int, Notifications> NotificationMap;
+  typedef base::hash_map<std::string, Notifications::iterator> IdMap;
+  typedef std::set<std::string> IdSet;
+  typedef base::hash_map<string16, IdSet> SourceMap;
+  typedef base::hash_map<std::string, IdSet> ExtensionMap;
 
-  // Iterates through the list and stores the first notification matching |id|
-  // (should always be unique) to |iter|. Returns true if it's found.
+  // Stores the notification matching |id| (should always be unique) to
+  // |iter|. Returns true if it's found.
   bool GetNotification(const std::string& id, Notifications::iterator* iter);
 
+  // Removes the notification from the list and from the indexes.
   void EraseNotification(Notifications::iterator iter);
 
   void PushNotification(Notification& notification);
@@ -190,8 +210,25 @@ class MESSAGE_CENTER_EXPORT NotificationList {
   // Sets the current quiet mode status to |quiet_mode|.
   void SetQuietModeInternal(bool quiet_mode);
 
+  // Marks all notifications as read and shown as a popup.
+  void MarkAllAsReadAndShown();
+
+  // Calls SendRemoveNotification() on the delegate for each id in |ids|.
+  void SendRemoveNotifications(const IdSet& ids);
+
   Delegate* delegate_;
   NotificationMap notifications_;
+
+  // Indexes of |notifications_|: by id, by display source and by extension
+  // id.
+  IdMap notifications_by_id_;
+  SourceMap ids_by_source_;
+  ExtensionMap ids_by_extension_;
+
+  // Ids of the notifications that may be unread or not shown as a popup, so
+  // that marking them all doesn't visit every notification.
+  base::hash_set<std::string> unseen_ids_;
+
   bool message_center_visible_;
   size_t unread_count_;
   bool quiet_mode_;
@@ -3,8 +3,17 @@
 // found in the LICENSE file.
 
 #include <algorithm>
-
+#include <deque>
+#include <vector>
+
+#include "base/compiler_specific.h"
+#include "base/lazy_instance.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/synchronization/condition_variable.h"
+#include "base/synchronization/lock.h"
+#include "base/threading/platform_thread.h"
 #include "skia/ext/convolver.h"
+#include "skia/ext/convolver_avx2.h"
 #include "third_party/skia/include/core/SkTypes.h"
 
 #if defined(SIMD_SSE2)
@@ -15,6 +24,15 @@ namespace skia {
 
 namespace {
 
+// The most threads, counting the calling one, BGRAConvolve2DParallel() uses.
+const int kMaxConvolveThreads = 8;
+
+// The fewest output rows and pixels worth convolving on another thread. Each
+// band also redoes the horizontal pass of the source rows it shares with its
+// neighbors, so bands must be large enough for that to be small.
+const int kMinBandRows = 32;
+const int kMinBandPixels = 128 * 1024;
+
 // Converts the argument to an 8-bit unsigned value by clamping to the range
 // 0-255.
 inline unsigned char ClampTo8(int a) {
@@ -650,95 +668,61 @@ void ConvolveVertically_SSE2(const ConvolutionFilter1D::Fixed* filter_values,
 #endif
 }
 
-}  // namespace
-
-// ConvolutionFilter1D ---------------------------------------------------------
-
-ConvolutionFilter1D::ConvolutionFilter1D()
-    : max_filter_(0) {
-}
-
-ConvolutionFilter1D::~ConvolutionFilter1D() {
-}
-
-void ConvolutionFilter1D::AddFilter(int filter_offset,
-                                    const float* filter_values,
-                                    int filter_length) {
-  SkASSERT(filter_length > 0);
-
-  std::vector<Fixed> fixed_values;
-  fixed_values.reserve(filter_length);
-
-  for (int i = 0; i < filter_length; ++i)
-    fixed_values.push_back(FloatToFixed(filter_values[i]));
-
-  AddFilter(filter_offset, &fixed_values[0], filter_length);
-}
-
-void ConvolutionFilter1D::AddFilter(int filter_offset,
-                                    const Fixed* filter_values,
-                                    int filter_length) {
-  // It is common for leading/trailing filter values to be zeros. In such
-  // cases it is beneficial to only store the central factors.
-  // For a scaling to 1/4th in each dimension using a Lanczos-2 filter on
-  // a 1080p image this optimization gives a ~10% speed improvement.
-  int first_non_zero = 0;
-  while (first_non_zero < filter_length && filter_values[first_non_zero] == 0)
-    first_non_zero++;
-
-  if (first_non_zero < filter_length) {
-    // Here we have at least one non-zero factor.
-    int last_non_zero = filter_length - 1;
-    while (last_non_zero >= 0 && filter_values[last_non_zero] == 0)
-      last_non_zero--;
-
-    filter_offset += first_non_zero;
-    filter_length = last_non_zero + 1 - first_non_zero;
-    SkASSERT(filter_length > 0);
-
-    for (int i = first_non_zero; i <= last_non_zero; i++)
-      filter_values_.push_back(filter_values[i]);
-  } else {
-    // Here all the factors were zeroes.
-    filter_length = 0;
+// The filters of a horizontal ConvolutionFilter1D, one entry per output
+// pixel. The AVX2 pass takes them in this form since code built with -mavx2
+// must not call the inline accessors of ConvolutionFilter1D.
+struct FilterTable {
+  explicit FilterTable(const ConvolutionFilter1D& filter)
+      : offsets(filter.num_values()),
+        lengths(filter.num_values()),
+        values(filter.num_values()) {
+    for (int i = 0; i < filter.num_values(); ++i)
+      values[i] = filter.FilterForValue(i, &offsets[i], &lengths[i]);
   }
 
-  FilterInstance instance;
-
-  // We pushed filter_length elements onto filter_values_
-  instance.data_location = (static_cast<int>(filter_values_.size()) -
-                            filter_length);
-  instance.offset = filter_offset;
-  instance.length = filter_length;
-  filters_.push_back(instance);
+  std::vector<int> offsets;
+  std::vector<int> lengths;
+  std::vector<const ConvolutionFilter1D::Fixed*> values;
+};
 
-  max_filter_ = std::max(max_filter_, filter_length);
-}
+// The arguments of a BGRAConvolve2DParallel() call, shared by its bands.
+struct ConvolveArgs {
+  const unsigned char* source_data;
+  int source_byte_row_stride;
+  bool source_has_alpha;
+  const ConvolutionFilter1D* filter_x;
+  const ConvolutionFilter1D* filter_y;
+  int output_byte_row_stride;
+  unsigned char* output;
+  ConvolveInstructionSet instruction_set;
+  // |filter_x| as a FilterTable, only set for CONVOLVE_AVX2.
+  const FilterTable* filter_table_x;
+};
 
-void BGRAConvolve2D(const unsigned char* source_data,
-                    int source_byte_row_stride,
-                    bool source_has_alpha,
-                    const ConvolutionFilter1D& filter_x,
-                    const ConvolutionFilter1D& filter_y,
-                    int output_byte_row_stride,
-                    unsigned char* output,
-                    bool use_sse2) {
-#if !defined(SIMD_SSE2)
-  // Even we have runtime support for SSE2 instructions, since the binary
-  // was not built with SSE2 support, we had to fallback to C version.
-  use_sse2 = false;
-#endif
+// Convolves the output rows from |begin_row| up to but not including
+// |end_row|. The horizontal pass is run on every source row the vertical
+// filters of these rows need, so the bands of a parallel convolution do not
+// depend on each other.
+void ConvolveRows(const ConvolveArgs& args, int begin_row, int end_row) {
+  const ConvolutionFilter1D& filter_x = *args.filter_x;
+  const ConvolutionFilter1D& filter_y = *args.filter_y;
+  const unsigned char* source_data = args.source_data;
+  int source_byte_row_stride = args.source_byte_row_stride;
+  bool source_has_alpha = args.source_has_alpha;
+  bool use_sse2 = args.instruction_set == CONVOLVE_SSE2;
+  bool use_avx2 = args.instruction_set == CONVOLVE_AVX2;
 
   int max_y_filter_size = filter_y.max_filter();
 
   // The next row in the input that we will generate a horizontally
   // convolved row for. If the filter doesn't start at the beginning of the
-  // image (this is the case when we are only resizing a subset), then we
-  // don't want to generate any output rows before that. Compute the starting
-  // row for convolution as the first pixel for the first vertical filter.
+  // image (this is the case when we are only resizing a subset, or when this
+  // is not the first band), then we don't want to generate any output rows
+  // before that. Compute the starting row for convolution as the first pixel
+  // for the first vertical filter.
   int filter_offset, filter_length;
   const ConvolutionFilter1D::Fixed* filter_values =
-      filter_y.FilterForValue(0, &filter_offset, &filter_length);
+      filter_y.FilterForValue(begin_row, &filter_offset, &filter_length);
   int next_x_row = filter_offset;
 
   // We loop over each row in the input doing a horizontal convolution. This
@@ -757,18 +741,18 @@ void BGRAConvolve2D(const unsigned char* source_data,
                                row_buffer_height,
                                filter_offset);
 
-  // Loop over every possible output row, processing just enough horizontal
-  // convolutions to run each subsequent vertical convolution.
-  SkASSERT(output_byte_row_stride >= filter_x.num_values() * 4);
+  // Loop over every output row of the band, processing just enough
+  // horizontal convolutions to run each subsequent vertical convolution.
   int num_output_rows = filter_y.num_values();
 
   // We need to check which is the last line to convolve before we advance 4
-  // lines in one iteration.
+  // lines in one iteration. This is the last line of the image, not of the
+  // band, since the lines past the band can be read too.
   int last_filter_offset, last_filter_length;
   filter_y.FilterForValue(num_output_rows - 1, &last_filter_offset,
                           &last_filter_length);
 
-  for (int out_y = 0; out_y < num_output_rows; out_y++) {
+  for (int out_y = begin_row; out_y < end_row; out_y++) {
     filter_values = filter_y.FilterForValue(out_y,
                                             &filter_offset, &filter_length);
 
@@ -805,6 +789,17 @@ void BGRAConvolve2D(const unsigned char* source_data,
           next_x_row++;
         }
       }
+    } else if (use_avx2) {
+      // The AVX2 version only reads the pixels of the filters, so it is used
+      // for the last row too.
+      const FilterTable& table = *args.filter_table_x;
+      while (next_x_row < filter_offset + filter_length) {
+        ConvolveHorizontally_AVX2(
+            &source_data[next_x_row * source_byte_row_stride],
+            &table.offsets[0], &table.lengths[0], &table.values[0],
+            filter_x.num_values(), row_buffer.AdvanceRow(), source_has_alpha);
+        next_x_row++;
+      }
     } else {
       while (next_x_row < filter_offset + filter_length) {
         if (source_has_alpha) {
@@ -821,7 +816,8 @@ void BGRAConvolve2D(const unsigned char* source_data,
     }
 
     // Compute where in the output image this row of final data will go.
-    unsigned char* cur_output_row = &output[out_y * output_byte_row_stride];
+    unsigned char* cur_output_row =
+        &args.output[out_y * args.output_byte_row_stride];
 
     // Get the list of rows that the circular buffer has, in order.
     int first_row_in_circular_buffer;
@@ -833,7 +829,11 @@ void BGRAConvolve2D(const unsigned char* source_data,
     unsigned char* const* first_row_for_filter =
         &rows_to_convolve[filter_offset - first_row_in_circular_buffer];
 
-    if (source_has_alpha) {
+    if (use_avx2) {
+      ConvolveVertically_AVX2(filter_values, filter_length,
+                              first_row_for_filter, filter_x.num_values(),
+                              cur_output_row, source_has_alpha);
+    } else if (source_has_alpha) {
       if (use_sse2) {
         ConvolveVertically_SSE2<true>(filter_values, filter_length,
                                       first_row_for_filter,
@@ -857,4 +857,243 @@ void BGRAConvolve2D(const unsigned char* source_data,
   }
 }
 
+// A BGRAConvolve2DParallel() call whose output rows are split into
+// |num_bands| bands. The band counts are guarded by the lock of the
+// ConvolveWorkerPool running it.
+struct ConvolveJob {
+  ConvolveJob(const ConvolveArgs& args, int num_rows, int num_bands)
+      : args(args),
+        num_rows(num_rows),
+        num_bands(num_bands),
+        next_band(0),
+        finished_bands(0) {
+  }
+
+  const ConvolveArgs& args;
+  int num_rows;
+  int num_bands;
+
+  // The next band to be taken by a thread, and the number of bands done.
+  int next_band;
+  int finished_bands;
+};
+
+// Convolves the bands of BGRAConvolve2DParallel() calls on threads that live
+// as long as the process, so that a resize does not pay for starting threads.
+// The calling thread convolves bands too, so a call only waits for the bands
+// the workers took. Threads are started the first time a call asks for them.
+class ConvolveWorkerPool : public base::PlatformThread::Delegate {
+ public:
+  ConvolveWorkerPool()
+      : work_available_(&lock_),
+        job_finished_(&lock_),
+        num_threads_(0) {
+  }
+
+  // Convolves all the bands of |job| on the calling thread and on up to
+  // |num_workers| workers, and returns when they are done.
+  void Run(ConvolveJob* job, int num_workers) {
+    base::AutoLock lock(lock_);
+    while (num_threads_ < num_workers &&
+           base::PlatformThread::CreateNonJoinable(0, this)) {
+      num_threads_++;
+    }
+
+    jobs_.push_back(job);
+    work_available_.Broadcast();
+    while (job->next_band < job->num_bands)
+      RunNextBand(job);
+    while (job->finished_bands < job->num_bands)
+      job_finished_.Wait();
+  }
+
+  // base::PlatformThread::Delegate implementation.
+  virtual void ThreadMain() OVERRIDE {
+    base::PlatformThread::SetName("ConvolveWorker");
+    base::AutoLock lock(lock_);
+    while (true) {
+      if (jobs_.empty())
+        work_available_.Wait();
+      else
+        RunNextBand(jobs_.front());
+    }
+  }
+
+ private:
+  // Takes the next band of |job| and convolves it with |lock_| released.
+  // |job| leaves |jobs_| when its last band is taken.
+  void RunNextBand(ConvolveJob* job) {
+    lock_.AssertAcquired();
+    int band = job->next_band++;
+    if (job->next_band == job->num_bands)
+      jobs_.erase(std::find(jobs_.begin(), jobs_.end(), job));
+
+    {
+      base::AutoUnlock unlock(lock_);
+      ConvolveRows(job->args,
+                   job->num_rows * band / job->num_bands,
+                   job->num_rows * (band + 1) / job->num_bands);
+    }
+
+    if (++job->finished_bands == job->num_bands)
+      job_finished_.Broadcast();
+  }
+
+  base::Lock lock_;
+
+  // Signaled when a job is added to |jobs_|.
+  base::ConditionVariable work_available_;
+
+  // Signaled when the last band of a job is done.
+  base::ConditionVariable job_finished_;
+
+  // The jobs with bands no thread has taken yet.
+  std::deque<ConvolveJob*> jobs_;
+
+  int num_threads_;
+
+  DISALLOW_COPY_AND_ASSIGN(ConvolveWorkerPool);
+};
+
+base::LazyInstance<ConvolveWorkerPool>::Leaky g_convolve_worker_pool =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+// ConvolutionFilter1D ---------------------------------------------------------
+
+ConvolutionFilter1D::ConvolutionFilter1D()
+    : max_filter_(0) {
+}
+
+ConvolutionFilter1D::~ConvolutionFilter1D() {
+}
+
+void ConvolutionFilter1D::AddFilter(int filter_offset,
+                                    const float* filter_values,
+                                    int filter_length) {
+  SkASSERT(filter_length > 0);
+
+  std::vector<Fixed> fixed_values;
+  fixed_values.reserve(filter_length);
+
+  for (int i = 0; i < filter_length; ++i)
+    fixed_values.push_back(FloatToFixed(filter_values[i]));
+
+  AddFilter(filter_offset, &fixed_values[0], filter_length);
+}
+
+void ConvolutionFilter1D::AddFilter(int filter_offset,
+                                    const Fixed* filter_values,
+                                    int filter_length) {
+  // It is common for leading/trailing filter values to be zeros. In such
+  // cases it is beneficial to only store the central factors.
+  // For a scaling to 1/4th in each dimension using a Lanczos-2 filter on
+  // a 1080p image this optimization gives a ~10% speed improvement.
+  int first_non_zero = 0;
+  while (first_non_zero < filter_length && filter_values[first_non_zero] == 0)
+    first_non_zero++;
+
+  if (first_non_zero < filter_length) {
+    // Here we have at least one non-zero factor.
+    int last_non_zero = filter_length - 1;
+    while (last_non_zero >= 0 && filter_values[last_non_zero] == 0)
+      last_non_zero--;
+
+    filter_offset += first_non_zero;
+    filter_length = last_non_zero + 1 - first_non_zero;
+    SkASSERT(filter_length > 0);
+
+    for (int i = first_non_zero; i <= last_non_zero; i++)
+      filter_values_.push_back(filter_values[i]);
+  } else {
+    // Here all the factors were zeroes.
+    filter_length = 0;
+  }
+
+  FilterInstance instance;
+
+  // We pushed filter_length elements onto filter_values_
+  instance.data_location = (static_cast<int>(filter_values_.size()) -
+                            filter_length);
+  instance.offset = filter_offset;
+  instance.length = filter_length;
+  filters_.push_back(instance);
+
+  max_filter_ = std::max(max_filter_, filter_length);
+}
+
+ConvolveInstructionSet GetConvolveInstructionSet(const base::CPU& cpu) {
+  if (cpu.has_avx2() && ConvolveAVX2Built())
+    return CONVOLVE_AVX2;
+#if defined(SIMD_SSE2)
+  if (cpu.has_sse2())
+    return CONVOLVE_SSE2;
+#endif
+  return CONVOLVE_C;
+}
+
+void BGRAConvolve2D(const unsigned char* source_data,
+                    int source_byte_row_stride,
+                    bool source_has_alpha,
+                    const ConvolutionFilter1D& filter_x,
+                    const ConvolutionFilter1D& filter_y,
+                    int output_byte_row_stride,
+                    unsigned char* output,
+                    bool use_sse2) {
+  BGRAConvolve2DParallel(source_data, source_byte_row_stride,
+                         source_has_alpha, filter_x, filter_y,
+                         output_byte_row_stride, output,
+                         use_sse2 ? CONVOLVE_SSE2 : CONVOLVE_C, 1);
+}
+
+void BGRAConvolve2DParallel(const unsigned char* source_data,
+                            int source_byte_row_stride,
+                            bool source_has_alpha,
+                            const ConvolutionFilter1D& filter_x,
+                            const ConvolutionFilter1D& filter_y,
+                            int output_byte_row_stride,
+                            unsigned char* output,
+                            ConvolveInstructionSet instruction_set,
+                            int max_threads) {
+#if !defined(SIMD_SSE2)
+  // Even we have runtime support for SSE2 instructions, since the binary
+  // was not built with SSE2 support, we had to fallback to C version.
+  if (instruction_set == CONVOLVE_SSE2)
+    instruction_set = CONVOLVE_C;
+#endif
+  if (instruction_set == CONVOLVE_AVX2 && !ConvolveAVX2Built())
+    instruction_set = CONVOLVE_C;
+
+  SkASSERT(output_byte_row_stride >= filter_x.num_values() * 4);
+  if (filter_x.num_values() == 0 || filter_y.num_values() == 0)
+    return;  // Nothing to output.
+
+  scoped_ptr<FilterTable> filter_table_x;
+  if (instruction_set == CONVOLVE_AVX2)
+    filter_table_x.reset(new FilterTable(filter_x));
+  ConvolveArgs args = {
+    source_data, source_byte_row_stride, source_has_alpha, &filter_x,
+    &filter_y, output_byte_row_stride, output, instruction_set,
+    filter_table_x.get()
+  };
+  int num_output_rows = filter_y.num_values();
+
+  // Only use as many bands as have enough rows and pixels to be worth
+  // handing to another thread.
+  int64 num_output_pixels =
+      static_cast<int64>(num_output_rows) * filter_x.num_values();
+  int num_bands = std::min(max_threads, kMaxConvolveThreads);
+  num_bands = std::min(num_bands, num_output_rows / kMinBandRows);
+  num_bands = static_cast<int>(
+      std::min<int64>(num_bands, num_output_pixels / kMinBandPixels));
+  if (num_bands <= 1) {
+    ConvolveRows(args, 0, num_output_rows);
+    return;
+  }
+
+  ConvolveJob job(args, num_output_rows, num_bands);
+  g_convolve_worker_pool.Get().Run(&job, num_bands - 1);
+}
+
 }  // namespace skia
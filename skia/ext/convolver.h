@@ -168,6 +168,36 @@ SK_API void BGRAConvolve2D(const unsigned char* source_data,
                            int output_byte_row_stride,
                            unsigned char* output,
                            bool use_sse2);
+
+// The instruction sets the convolutions can be done with.
+enum ConvolveInstructionSet {
+  CONVOLVE_C,
+  CONVOLVE_SSE2,
+  CONVOLVE_AVX2
+};
+
+// Returns the fastest instruction set that both |cpu| and the build support.
+SK_API ConvolveInstructionSet GetConvolveInstructionSet(const base::CPU& cpu);
+
+// Same as BGRAConvolve2D(), but done with |instruction_set| (falling back to
+// C if the build does not support it), and with the output rows split into
+// bands convolved in parallel on up to |max_threads| threads, counting the
+// calling one. The other threads are kept for later calls.
+//
+// Each band runs the horizontal pass on all the source rows its vertical
+// filters touch, so the few rows shared by neighboring bands are convolved
+// horizontally twice. Outputs that are too small for this to pay off are
+// split into fewer bands, down to one on the calling thread.
+SK_API void BGRAConvolve2DParallel(const unsigned char* source_data,
+                                   int source_byte_row_stride,
+                                   bool source_has_alpha,
+                                   const ConvolutionFilter1D& xfilter,
+                                   const ConvolutionFilter1D& yfilter,
+                                   int output_byte_row_stride,
+                                   unsigned char* output,
+                                   ConvolveInstructionSet instruction_set,
+                                   int max_threads);
+
 }  // namespace skia
 
 #endif  // SKIA_EXT_CONVOLVER_H_
@@ -0,0 +1,254 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "skia/ext/convolver_avx2.h"
+
+#include <string.h>
+
+#include "third_party/skia/include/core/SkTypes.h"
+
+#if defined(__AVX2__) || (defined(_MSC_VER) && _MSC_VER >= 1800)
+#define SIMD_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace skia {
+
+#if defined(SIMD_AVX2)
+
+namespace {
+
+// Returns a mask selecting the first |count| of the eight 32-bit elements,
+// for the masked loads and stores of the last pixels.
+inline __m256i MaskFirstPixels(int count) {
+  return _mm256_cmpgt_epi32(_mm256_set1_epi32(count),
+                            _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+// Multiplies the eight pixels of |src8| by the eight coefficients of
+// |coeff8|, and returns the sum of the products of pixels 0-3 in the low lane
+// and of pixels 4-7 in the high lane. 32 bits per RGBA channel.
+inline __m256i MultiplyEightPixels(__m256i src8, __m128i coeff8) {
+  __m256i zero = _mm256_setzero_si256();
+
+  // The unpacks below work within each 128-bit lane, so the low lane needs
+  // coefficients 0-3 and the high lane 4-7.
+  // [16] c7 c6 c5 c4 c7 c6 c5 c4 | c3 c2 c1 c0 c3 c2 c1 c0
+  __m256i coeff = _mm256_permute4x64_epi64(_mm256_castsi128_si256(coeff8),
+                                           _MM_SHUFFLE(1, 1, 0, 0));
+
+  // [16] c5 c5 c5 c5 c4 c4 c4 c4 | c1 c1 c1 c1 c0 c0 c0 c0
+  __m256i coeff16 = _mm256_shufflelo_epi16(coeff, _MM_SHUFFLE(1, 1, 0, 0));
+  coeff16 = _mm256_unpacklo_epi16(coeff16, coeff16);
+  // [16] a5 b5 g5 r5 a4 b4 g4 r4 | a1 b1 g1 r1 a0 b0 g0 r0
+  __m256i src16 = _mm256_unpacklo_epi8(src8, zero);
+  __m256i mul_hi = _mm256_mulhi_epi16(src16, coeff16);
+  __m256i mul_lo = _mm256_mullo_epi16(src16, coeff16);
+  // [32] a4 b4 g4 r4 | a0 b0 g0 r0, then pixels 5 and 1.
+  __m256i sum = _mm256_add_epi32(_mm256_unpacklo_epi16(mul_lo, mul_hi),
+                                 _mm256_unpackhi_epi16(mul_lo, mul_hi));
+
+  // The same for pixels 2, 3, 6 and 7.
+  coeff16 = _mm256_shufflelo_epi16(coeff, _MM_SHUFFLE(3, 3, 2, 2));
+  coeff16 = _mm256_unpacklo_epi16(coeff16, coeff16);
+  src16 = _mm256_unpackhi_epi8(src8, zero);
+  mul_hi = _mm256_mulhi_epi16(src16, coeff16);
+  mul_lo = _mm256_mullo_epi16(src16, coeff16);
+  sum = _mm256_add_epi32(sum, _mm256_unpacklo_epi16(mul_lo, mul_hi));
+  return _mm256_add_epi32(sum, _mm256_unpackhi_epi16(mul_lo, mul_hi));
+}
+
+void ConvolveHorizontallyImpl(
+    const unsigned char* src_data,
+    const int* filter_offsets,
+    const int* filter_lengths,
+    const ConvolutionFilter1D::Fixed* const* all_filter_values,
+    int num_values,
+    unsigned char* out_row) {
+  for (int out_x = 0; out_x < num_values; out_x++) {
+    int filter_length = filter_lengths[out_x];
+    const ConvolutionFilter1D::Fixed* filter_values = all_filter_values[out_x];
+    const unsigned char* row_to_filter = &src_data[filter_offsets[out_x] * 4];
+
+    // Apply eight filter taps per iteration.
+    __m256i accum = _mm256_setzero_si256();
+    int filter_x = 0;
+    for (; filter_x + 8 <= filter_length; filter_x += 8) {
+      __m128i coeff8 = _mm_loadu_si128(
+          reinterpret_cast<const __m128i*>(&filter_values[filter_x]));
+      __m256i src8 = _mm256_loadu_si256(
+          reinterpret_cast<const __m256i*>(&row_to_filter[filter_x * 4]));
+      accum = _mm256_add_epi32(accum, MultiplyEightPixels(src8, coeff8));
+    }
+
+    // Apply the last taps, loading only the pixels and coefficients that
+    // belong to the filter.
+    int remaining = filter_length - filter_x;
+    if (remaining > 0) {
+      ConvolutionFilter1D::Fixed coeffs[8] = { 0 };
+      memcpy(coeffs, &filter_values[filter_x], remaining * sizeof(coeffs[0]));
+      __m128i coeff8 = _mm_loadu_si128(reinterpret_cast<__m128i*>(coeffs));
+      __m256i src8 = _mm256_maskload_epi32(
+          reinterpret_cast<const int*>(&row_to_filter[filter_x * 4]),
+          MaskFirstPixels(remaining));
+      accum = _mm256_add_epi32(accum, MultiplyEightPixels(src8, coeff8));
+    }
+
+    // Add the two lanes, shift right for fixed point implementation and pack
+    // to 8 bits per channel with saturation.
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(accum),
+                                _mm256_extracti128_si256(accum, 1));
+    sum = _mm_srai_epi32(sum, ConvolutionFilter1D::kShiftBits);
+    sum = _mm_packs_epi32(sum, sum);
+    sum = _mm_packus_epi16(sum, sum);
+
+    // The alpha of an opaque image is ignored by the vertical pass, so it is
+    // stored either way.
+    *reinterpret_cast<int*>(&out_row[out_x * 4]) = _mm_cvtsi128_si32(sum);
+  }
+}
+
+template<bool has_alpha>
+void ConvolveVerticallyImpl(const ConvolutionFilter1D::Fixed* filter_values,
+                            int filter_length,
+                            unsigned char* const* source_data_rows,
+                            int pixel_width,
+                            unsigned char* out_row) {
+  __m256i zero = _mm256_setzero_si256();
+
+  // Output eight pixels per iteration (32 bytes).
+  for (int out_x = 0; out_x < pixel_width; out_x += 8) {
+    bool partial = pixel_width - out_x < 8;
+    __m256i mask = MaskFirstPixels(pixel_width - out_x);
+
+    // Accumulated result for each pixel. 32 bits per RGBA channel. Since the
+    // unpacks work within each 128-bit lane, |accum0| holds pixels 0 and 4,
+    // |accum1| pixels 1 and 5 and so on.
+    __m256i accum0 = _mm256_setzero_si256();
+    __m256i accum1 = _mm256_setzero_si256();
+    __m256i accum2 = _mm256_setzero_si256();
+    __m256i accum3 = _mm256_setzero_si256();
+
+    // Convolve with one filter coefficient per iteration.
+    for (int filter_y = 0; filter_y < filter_length; filter_y++) {
+      __m256i coeff16 = _mm256_set1_epi16(filter_values[filter_y]);
+      const unsigned char* src = &source_data_rows[filter_y][out_x * 4];
+      __m256i src8 = partial ?
+          _mm256_maskload_epi32(reinterpret_cast<const int*>(src), mask) :
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+
+      // [16] a5 b5 g5 r5 a4 b4 g4 r4 | a1 b1 g1 r1 a0 b0 g0 r0
+      __m256i src16 = _mm256_unpacklo_epi8(src8, zero);
+      __m256i mul_hi = _mm256_mulhi_epi16(src16, coeff16);
+      __m256i mul_lo = _mm256_mullo_epi16(src16, coeff16);
+      accum0 = _mm256_add_epi32(accum0, _mm256_unpacklo_epi16(mul_lo, mul_hi));
+      accum1 = _mm256_add_epi32(accum1, _mm256_unpackhi_epi16(mul_lo, mul_hi));
+
+      // [16] a7 b7 g7 r7 a6 b6 g6 r6 | a3 b3 g3 r3 a2 b2 g2 r2
+      src16 = _mm256_unpackhi_epi8(src8, zero);
+      mul_hi = _mm256_mulhi_epi16(src16, coeff16);
+      mul_lo = _mm256_mullo_epi16(src16, coeff16);
+      accum2 = _mm256_add_epi32(accum2, _mm256_unpacklo_epi16(mul_lo, mul_hi));
+      accum3 = _mm256_add_epi32(accum3, _mm256_unpackhi_epi16(mul_lo, mul_hi));
+    }
+
+    // Shift right for fixed point implementation.
+    accum0 = _mm256_srai_epi32(accum0, ConvolutionFilter1D::kShiftBits);
+    accum1 = _mm256_srai_epi32(accum1, ConvolutionFilter1D::kShiftBits);
+    accum2 = _mm256_srai_epi32(accum2, ConvolutionFilter1D::kShiftBits);
+    accum3 = _mm256_srai_epi32(accum3, ConvolutionFilter1D::kShiftBits);
+
+    // Pack to 16 and then 8 bits per channel with saturation. Within each
+    // lane this puts the pixels back in order.
+    // [16] p5 p4 | p1 p0 and p7 p6 | p3 p2
+    accum0 = _mm256_packs_epi32(accum0, accum1);
+    accum2 = _mm256_packs_epi32(accum2, accum3);
+    // [8] p7 p6 p5 p4 | p3 p2 p1 p0
+    accum0 = _mm256_packus_epi16(accum0, accum2);
+
+    if (has_alpha) {
+      // Make sure the alpha channel doesn't come out smaller than any of the
+      // color channels, as in ConvolveVertically().
+      // [8] xx xx max(a,r) max(r,g) and xx xx xx max(b,g) in the low byte.
+      __m256i max_color = _mm256_max_epu8(_mm256_srli_epi32(accum0, 8),
+                                          accum0);
+      max_color = _mm256_max_epu8(_mm256_srli_epi32(accum0, 16), max_color);
+      // [8] max 00 00 00 for each pixel.
+      max_color = _mm256_slli_epi32(max_color, 24);
+      accum0 = _mm256_max_epu8(max_color, accum0);
+    } else {
+      // No alpha channel, the image is opaque.
+      accum0 = _mm256_or_si256(accum0, _mm256_set1_epi32(0xff000000));
+    }
+
+    unsigned char* out = &out_row[out_x * 4];
+    if (partial)
+      _mm256_maskstore_epi32(reinterpret_cast<int*>(out), mask, accum0);
+    else
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), accum0);
+  }
+}
+
+}  // namespace
+
+bool ConvolveAVX2Built() {
+  return true;
+}
+
+void ConvolveHorizontally_AVX2(
+    const unsigned char* src_data,
+    const int* filter_offsets,
+    const int* filter_lengths,
+    const ConvolutionFilter1D::Fixed* const* filter_values,
+    int num_values,
+    unsigned char* out_row,
+    bool has_alpha) {
+  ConvolveHorizontallyImpl(src_data, filter_offsets, filter_lengths,
+                           filter_values, num_values, out_row);
+}
+
+void ConvolveVertically_AVX2(const ConvolutionFilter1D::Fixed* filter_values,
+                             int filter_length,
+                             unsigned char* const* source_data_rows,
+                             int pixel_width,
+                             unsigned char* out_row,
+                             bool has_alpha) {
+  if (has_alpha) {
+    ConvolveVerticallyImpl<true>(filter_values, filter_length,
+                                 source_data_rows, pixel_width, out_row);
+  } else {
+    ConvolveVerticallyImpl<false>(filter_values, filter_length,
+                                  source_data_rows, pixel_width, out_row);
+  }
+}
+
+#else  // !defined(SIMD_AVX2)
+
+bool ConvolveAVX2Built() {
+  return false;
+}
+
+void ConvolveHorizontally_AVX2(
+    const unsigned char* src_data,
+    const int* filter_offsets,
+    const int* filter_lengths,
+    const ConvolutionFilter1D::Fixed* const* filter_values,
+    int num_values,
+    unsigned char* out_row,
+    bool has_alpha) {
+  SkASSERT(false);
+}
+
+void ConvolveVertically_AVX2(const ConvolutionFilter1D::Fixed* filter_values,
+                             int filter_length,
+                             unsigned char* const* source_data_rows,
+                             int pixel_width,
+                             unsigned char* out_row,
+                             bool has_alpha) {
+  SkASSERT(false);
+}
+
+#endif  // defined(SIMD_AVX2)
+
+}  // namespace skia
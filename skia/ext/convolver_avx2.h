@@ -0,0 +1,52 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKIA_EXT_CONVOLVER_AVX2_H_
+#define SKIA_EXT_CONVOLVER_AVX2_H_
+
+#include "skia/ext/convolver.h"
+
+// The AVX2 passes of BGRAConvolve2DParallel(). They are built in their own
+// target so that gcc can be given -mavx2 for this file only; with that flag
+// it may use AVX2 in any code, which must not happen in the rest of the
+// convolver since it also runs on older CPUs. For the same reason the AVX2
+// file must not call inline code shared with other files, such as the
+// accessors of ConvolutionFilter1D or std::vector, since the linker may keep
+// its AVX2 copy. Only the types and constants of convolver.h are used.
+
+namespace skia {
+
+// Returns true if the compiler supported AVX2 when this file was built. The
+// functions below must only be called when it did and base::CPU::has_avx2()
+// is true.
+bool ConvolveAVX2Built();
+
+// Convolves horizontally along a single row, like ConvolveHorizontally().
+// Output pixel |i| of the |num_values| ones is filtered from the
+// |filter_lengths[i]| source pixels starting at |filter_offsets[i]|, with the
+// coefficients at |filter_values[i]|. Eight filter taps are applied per
+// iteration, and the last ones with masked loads, so no pixel past the end of
+// the filter is read.
+void ConvolveHorizontally_AVX2(
+    const unsigned char* src_data,
+    const int* filter_offsets,
+    const int* filter_lengths,
+    const ConvolutionFilter1D::Fixed* const* filter_values,
+    int num_values,
+    unsigned char* out_row,
+    bool has_alpha);
+
+// Does vertical convolution to produce one output row, like
+// ConvolveVertically(). Eight pixels are produced per iteration, and the last
+// ones with masked loads and stores.
+void ConvolveVertically_AVX2(const ConvolutionFilter1D::Fixed* filter_values,
+                             int filter_length,
+                             unsigned char* const* source_data_rows,
+                             int pixel_width,
+                             unsigned char* out_row,
+                             bool has_alpha);
+
+}  // namespace skia
+
+#endif  // SKIA_EXT_CONVOLVER_AVX2_H_
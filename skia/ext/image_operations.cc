@@ -26,6 +26,10 @@ namespace skia {
 
 namespace {
 
+// The limits set by ImageOperations::SetResizeLimits().
+ConvolveInstructionSet g_max_instruction_set = CONVOLVE_AVX2;
+int g_max_resize_threads = 1;
+
 // Returns the ceiling/floor as an integer.
 inline int CeilInt(float val) {
   return static_cast<int>(ceil(val));
@@ -515,11 +519,14 @@ SkBitmap ImageOperations::ResizeBasic(const SkBitmap& source,
   if (!result.readyToDraw())
     return SkBitmap();
 
-  BGRAConvolve2D(source_subset, static_cast<int>(source.rowBytes()),
-                 !source.isOpaque(), filter.x_filter(), filter.y_filter(),
-                 static_cast<int>(result.rowBytes()),
-                 static_cast<unsigned char*>(result.getPixels()),
-                 cpu.has_sse2());
+  ConvolveInstructionSet instruction_set =
+      std::min(GetConvolveInstructionSet(cpu), g_max_instruction_set);
+  BGRAConvolve2DParallel(source_subset, static_cast<int>(source.rowBytes()),
+                         !source.isOpaque(), filter.x_filter(),
+                         filter.y_filter(),
+                         static_cast<int>(result.rowBytes()),
+                         static_cast<unsigned char*>(result.getPixels()),
+                         instruction_set, g_max_resize_threads);
 
   // Preserve the "opaque" flag for use as an optimization later.
   result.setIsOpaque(source.isOpaque());
@@ -538,4 +545,13 @@ SkBitmap ImageOperations::Resize(const SkBitmap& source,
   return Resize(source, method, dest_width, dest_height, dest_subset);
 }
 
+// static
+void ImageOperations::SetResizeLimits(
+    ConvolveInstructionSet max_instruction_set,
+    int max_threads) {
+  DCHECK_GE(max_threads, 1);
+  g_max_instruction_set = max_instruction_set;
+  g_max_resize_threads = max_threads;
+}
+
 }  // namespace skia
@@ -5,6 +5,7 @@
 #ifndef SKIA_EXT_IMAGE_OPERATIONS_H_
 #define SKIA_EXT_IMAGE_OPERATIONS_H_
 
+#include "skia/ext/convolver.h"
 #include "third_party/skia/include/core/SkTypes.h"
 
 class SkBitmap;
@@ -109,6 +110,14 @@ class SK_API ImageOperations {
                          ResizeMethod method,
                          int dest_width, int dest_height);
 
+  // Limits the instruction set and the number of threads later calls to
+  // Resize() use, on every thread. By default the fastest instruction set of
+  // the CPU is used, on the calling thread only. With more threads, large
+  // resizes are split into bands of rows convolved in parallel; see
+  // BGRAConvolve2DParallel(). Call this before other threads resize.
+  static void SetResizeLimits(ConvolveInstructionSet max_instruction_set,
+                              int max_threads);
+
  private:
   ImageOperations();  // Class for scoping only.
 
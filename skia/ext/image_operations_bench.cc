@@ -13,11 +13,14 @@
 // source surface + destination surface and dividing by the elapsed time.
 // This number is somewhat reasonable way to measure this, given our current
 // implementation which somewhat scales this way.
+// The resize is measured with each instruction set the CPU and the build
+// support, on one thread and on the number of threads given with -threads.
 
 #include <stdio.h>
 
 #include "base/basictypes.h"
 #include "base/command_line.h"
+#include "base/cpu.h"
 #include "base/format_macros.h"
 #include "base/string_number_conversions.h"
 #include "base/string_split.h"
@@ -68,6 +71,9 @@ const char* MethodToString(skia::ImageOperations::ResizeMethod method) {
   return "unknown";
 }
 
+// Names of the skia::ConvolveInstructionSet values.
+const char* const kInstructionSetNames[] = { "C", "SSE2", "AVX2" };
+
 // Prints all supported resize methods
 void PrintMethods() {
   bool print_comma = false;
@@ -138,10 +144,12 @@ class Benchmark {
  public:
   static const int kDefaultNumberIterations;
   static const skia::ImageOperations::ResizeMethod kDefaultResizeMethod;
+  static const int kDefaultNumberThreads;
 
   Benchmark()
       : num_iterations_(kDefaultNumberIterations),
-        method_(kDefaultResizeMethod) {}
+        method_(kDefaultResizeMethod),
+        num_threads_(kDefaultNumberThreads) {}
 
   // Returns true if command line parsing was successful, false otherwise.
   bool ParseArgs(const CommandLine* command_line);
@@ -151,8 +159,15 @@ class Benchmark {
 
   static void Usage();
  private:
+  // Resizes with |instruction_set| on up to |num_threads| threads and prints
+  // the throughput.
+  void RunMode(const SkBitmap& source,
+               skia::ConvolveInstructionSet instruction_set,
+               int num_threads) const;
+
   int num_iterations_;
   skia::ImageOperations::ResizeMethod method_;
+  int num_threads_;
   Dimensions source_;
   Dimensions dest_;
 };
@@ -161,16 +176,19 @@ class Benchmark {
 const int Benchmark::kDefaultNumberIterations = 1024;
 const skia::ImageOperations::ResizeMethod Benchmark::kDefaultResizeMethod =
       skia::ImageOperations::RESIZE_LANCZOS3;
+const int Benchmark::kDefaultNumberThreads = 4;
 
 // argument management
 void Benchmark::Usage() {
   printf("image_operations_bench -source wxh -destination wxh "
-         "[-iterations i] [-method m] [-help]\n"
+         "[-iterations i] [-method m] [-threads t] [-help]\n"
          "  -source wxh: specify source width and height\n"
          "  -destination wxh: specify destination width and height\n"
          "  -iter i: perform i iterations (default:%d)\n"
+         "  -threads t: also measure with up to t threads (default:%d)\n"
          "  -method m: use method m (default:%s), which can be:",
          Benchmark::kDefaultNumberIterations,
+         Benchmark::kDefaultNumberThreads,
          MethodToString(Benchmark::kDefaultResizeMethod));
   PrintMethods();
   printf("\n  -help: prints this help and exits\n");
@@ -198,6 +216,10 @@ bool Benchmark::ParseArgs(const CommandLine* command_line) {
       if (base::StringToInt(value, &num_iterations_) == false) {
         fNeedHelp = true;
       }
+    } else if (s == "threads") {
+      if (base::StringToInt(value, &num_threads_) == false) {
+        fNeedHelp = true;
+      }
     } else if (s == "method") {
       if (!StringToMethod(value, &method_)) {
         printf("Invalid method '%s' specified\n", value.c_str());
@@ -212,6 +234,10 @@ bool Benchmark::ParseArgs(const CommandLine* command_line) {
     printf("Invalid number of iterations: %d\n", num_iterations_);
     fNeedHelp = true;
   }
+  if (num_threads_ <= 0) {
+    printf("Invalid number of threads: %d\n", num_threads_);
+    fNeedHelp = true;
+  }
   if (!source_.IsValid()) {
     printf("Invalid source dimensions specified\n");
     fNeedHelp = true;
@@ -234,6 +260,31 @@ bool Benchmark::Run() const {
   source.allocPixels();
   source.eraseARGB(0, 0, 0, 0);
 
+  base::CPU cpu;
+  const skia::ConvolveInstructionSet best =
+      skia::GetConvolveInstructionSet(cpu);
+  for (int i = skia::CONVOLVE_C; i <= best; ++i) {
+    const skia::ConvolveInstructionSet instruction_set =
+        static_cast<skia::ConvolveInstructionSet>(i);
+#if !defined(SIMD_SSE2)
+    // Without SSE2 in the build this would measure C again.
+    if (instruction_set == skia::CONVOLVE_SSE2)
+      continue;
+#else
+    if (instruction_set == skia::CONVOLVE_SSE2 && !cpu.has_sse2())
+      continue;
+#endif
+    RunMode(source, instruction_set, 1);
+    if (num_threads_ > 1)
+      RunMode(source, instruction_set, num_threads_);
+  }
+  return true;
+}
+
+void Benchmark::RunMode(const SkBitmap& source,
+                        skia::ConvolveInstructionSet instruction_set,
+                        int num_threads) const {
+  skia::ImageOperations::SetResizeLimits(instruction_set, num_threads);
   SkBitmap dest;
 
   const base::TimeTicks start = base::TimeTicks::Now();
@@ -249,12 +300,12 @@ bool Benchmark::Run() const {
   const uint64 num_bytes = static_cast<uint64>(num_iterations_) *
       (GetBitmapSize(&source) + GetBitmapSize(&dest));
 
-  printf("%"PRIu64" MB/s,\telapsed = %"PRIu64" source=%d dest=%d\n",
+  printf("%-4s %d thread(s): %"PRIu64" MB/s,\telapsed = %"PRIu64
+         " source=%d dest=%d\n",
+         kInstructionSetNames[instruction_set], num_threads,
          static_cast<uint64>(elapsed_us == 0 ? 0 : num_bytes / elapsed_us),
          static_cast<uint64>(elapsed_us),
          GetBitmapSize(&source), GetBitmapSize(&dest));
-
-  return true;
 }
 
 // A small class to automatically call Reset on the global command line to
@@ -162,6 +162,7 @@
         'ext/bitmap_platform_device_win.h',
         'ext/convolver.cc',
         'ext/convolver.h',
+        'ext/convolver_avx2.h',
         'ext/google_logging.cc',
         'ext/image_operations.cc',
         'ext/image_operations.h',
@@ -539,6 +540,7 @@
       ],
       'dependencies': [
         'skia_opts',
+        'skia_ext_avx2',
         '../base/third_party/dynamic_annotations/dynamic_annotations.gyp:dynamic_annotations',
         '../third_party/sfntly/sfntly.gyp:sfntly',
         '../third_party/zlib/zlib.gyp:zlib',
@@ -794,6 +796,40 @@
         }],
       ],
     },
+    # The AVX2 convolutions of skia/ext get their own target for the same
+    # reason as skia_opts_ssse3: only that file may be compiled with -mavx2.
+    # Compilers without AVX2 build it without the convolutions, and the
+    # convolver then does not use them.
+    {
+      'target_name': 'skia_ext_avx2',
+      'type': 'static_library',
+      'variables': {
+        'optimize': 'max',
+      },
+      'include_dirs': [
+        '..',
+        'config',
+        '../third_party/skia/include/config',
+        '../third_party/skia/include/core',
+      ],
+      'conditions': [
+        [ 'OS in ["linux", "freebsd", "openbsd", "solaris"] and \
+           target_arch != "arm" and target_arch != "mipsel"', {
+          'cflags': [
+            '-mavx2',
+          ],
+        }],
+        [ 'OS == "win"', {
+          'include_dirs': [
+            'config/win',
+          ],
+        }],
+      ],
+      'sources': [
+        'ext/convolver_avx2.cc',
+        'ext/convolver_avx2.h',
+      ],
+    },
     {
       'target_name': 'image_operations_bench',
       'type': 'executable',
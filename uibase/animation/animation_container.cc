@@ -4,6 +4,10 @@
 
 #include "uibase/animation/animation_container.h"
 
+#include <algorithm>
+#include <vector>
+
+#include "base/lazy_instance.h"
 #include "uibase/animation/animation_container_element.h"
 #include "uibase/animation/animation_container_observer.h"
 
@@ -12,6 +16,86 @@ using base::TimeTicks;
 
 namespace ui {
 
+// Ticks the running containers at each display frame while vsync parameters
+// are set. Lives on the UI thread.
+class FrameClock {
+ public:
+  FrameClock() {}
+
+  bool is_active() const { return interval_ > TimeDelta(); }
+
+  void SetParameters(TimeTicks timebase, TimeDelta interval) {
+    const bool was_active = is_active();
+    timebase_ = timebase;
+    interval_ = interval;
+    timer_.Stop();
+    if (is_active() != was_active) {
+      // Move the running containers between their timers and the clock.
+      Containers containers(containers_);
+      for (Containers::const_iterator i = containers.begin();
+           i != containers.end(); ++i) {
+        (*i)->RestartTimer();
+      }
+    }
+    ScheduleNextFrame();
+  }
+
+  // Called when |container| starts and stops running.
+  void AddContainer(AnimationContainer* container) {
+    containers_.insert(container);
+    if (!timer_.IsRunning())
+      ScheduleNextFrame();
+  }
+  void RemoveContainer(AnimationContainer* container) {
+    containers_.erase(container);
+    if (containers_.empty())
+      timer_.Stop();
+  }
+
+ private:
+  typedef std::set<AnimationContainer*> Containers;
+
+  void ScheduleNextFrame() {
+    if (!is_active() || containers_.empty())
+      return;
+    const TimeTicks now = TimeTicks::Now();
+    int64 frames = (now - timebase_) / interval_;
+    if (now >= timebase_)
+      ++frames;
+    next_frame_time_ = timebase_ + interval_ * frames;
+    timer_.Start(FROM_HERE, next_frame_time_ - now, this, &FrameClock::Run);
+  }
+
+  void Run() {
+    // Stepping may stop, start or delete containers. Keep the ones we're
+    // about to tick alive, and skip the ones that stop before their turn.
+    std::vector<scoped_refptr<AnimationContainer> > containers(
+        containers_.begin(), containers_.end());
+    for (size_t i = 0; i < containers.size(); ++i) {
+      if (containers_.count(containers[i].get()))
+        containers[i]->OnFrame(next_frame_time_, interval_);
+    }
+    ScheduleNextFrame();
+  }
+
+  TimeTicks timebase_;
+  TimeDelta interval_;
+  TimeTicks next_frame_time_;
+
+  // The running containers.
+  Containers containers_;
+
+  base::OneShotTimer<FrameClock> timer_;
+
+  DISALLOW_COPY_AND_ASSIGN(FrameClock);
+};
+
+namespace {
+
+base::LazyInstance<FrameClock> g_frame_clock = LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
 AnimationContainer::AnimationContainer()
     : last_tick_time_(TimeTicks::Now()),
       observer_(NULL) {
@@ -29,6 +113,7 @@ void AnimationContainer::Start(AnimationContainerElement* element) {
 
   if (elements_.empty()) {
     last_tick_time_ = TimeTicks::Now();
+    g_frame_clock.Get().AddContainer(this);
     SetMinTimerInterval(element->GetTimerInterval());
   } else if (element->GetTimerInterval() < min_timer_interval_) {
     SetMinTimerInterval(element->GetTimerInterval());
@@ -45,6 +130,7 @@ void AnimationContainer::Stop(AnimationContainerElement* element) {
 
   if (elements_.empty()) {
     timer_.Stop();
+    g_frame_clock.Get().RemoveContainer(this);
     if (observer_)
       observer_->AnimationContainerEmpty(this);
   } else {
@@ -54,15 +140,33 @@ void AnimationContainer::Stop(AnimationContainerElement* element) {
   }
 }
 
+// static
+void AnimationContainer::SetVSyncParameters(TimeTicks timebase,
+                                            TimeDelta interval) {
+  g_frame_clock.Get().SetParameters(timebase, interval);
+}
+
 void AnimationContainer::Run() {
+  Tick(TimeTicks::Now());
+}
+
+void AnimationContainer::OnFrame(TimeTicks frame_time,
+                                 TimeDelta frame_interval) {
+  // Containers with slow animations don't need every frame; step them at the
+  // first frame at which their interval has nearly elapsed.
+  if (frame_time - last_tick_time_ < min_timer_interval_ - frame_interval / 2)
+    return;
+  // An animation may have started after the frame began.
+  Tick(std::max(frame_time, last_tick_time_));
+}
+
+void AnimationContainer::Tick(TimeTicks current_time) {
   // We notify the observer after updating all the elements. If all the elements
   // are deleted as a result of updating then our ref count would go to zero and
   // we would be deleted before we notify our observer. We add a reference to
   // ourself here to make sure we're still valid after running all the elements.
   scoped_refptr<AnimationContainer> this_ref(this);
 
-  TimeTicks current_time = TimeTicks::Now();
-
   last_tick_time_ = current_time;
 
   // Make a copy of the elements to iterate over so that if any elements are
@@ -81,10 +185,16 @@ void AnimationContainer::Run() {
 }
 
 void AnimationContainer::SetMinTimerInterval(base::TimeDelta delta) {
+  min_timer_interval_ = delta;
+  RestartTimer();
+}
+
+void AnimationContainer::RestartTimer() {
   // This doesn't take into account how far along the current element is, but
   // that shouldn't be a problem for uses of Animation/AnimationContainer.
   timer_.Stop();
-  min_timer_interval_ = delta;
+  if (g_frame_clock.Get().is_active())
+    return;
   timer_.Start(FROM_HERE, min_timer_interval_, this, &AnimationContainer::Run);
 }
 
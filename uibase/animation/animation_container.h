@@ -51,8 +51,17 @@ class UI_EXPORT AnimationContainer
   // Are there any timers running?
   bool is_running() const { return !elements_.empty(); }
 
+  // Makes every running container step its animations once per display
+  // frame instead of on its own timer, all with the same frame time and from
+  // a single wakeup. Frames start at |timebase| plus a multiple of
+  // |interval|, as reported by the compositor's vsync signal. A zero
+  // |interval| goes back to timers. Nothing wakes up while no animation runs.
+  static void SetVSyncParameters(base::TimeTicks timebase,
+                                 base::TimeDelta interval);
+
  private:
   friend class base::RefCounted<AnimationContainer>;
+  friend class FrameClock;
 
   typedef std::set<AnimationContainerElement*> Elements;
 
@@ -61,9 +70,19 @@ class UI_EXPORT AnimationContainer
   // Timer callback method.
   void Run();
 
+  // Called by the FrameClock at each frame while frame ticks are on.
+  // |frame_interval| is the duration of a frame.
+  void OnFrame(base::TimeTicks frame_time, base::TimeDelta frame_interval);
+
+  // Steps the elements to |time|.
+  void Tick(base::TimeTicks time);
+
   // Sets min_timer_interval_ and restarts the timer.
   void SetMinTimerInterval(base::TimeDelta delta);
 
+  // Starts the timer, unless the FrameClock ticks the container.
+  void RestartTimer();
+
   // Returns the min timer interval of all the timers.
   base::TimeDelta GetMinInterval();
 
@@ -11,6 +11,13 @@
 
 namespace ui {
 
+namespace {
+
+// Used for sorting. Created on first use and reset by ClearCollator().
+icu::Collator* g_collator = NULL;
+
+}  // namespace
+
 // TableColumn -----------------------------------------------------------------
 
 TableColumn::TableColumn()
@@ -68,11 +75,47 @@ int TableModel::GetGroupID(int row) {
 int TableModel::CompareValues(int row1, int row2, int column_id) {
   DCHECK(row1 >= 0 && row1 < RowCount() &&
          row2 >= 0 && row2 < RowCount());
-  string16 value1 = GetText(row1, column_id);
-  string16 value2 = GetText(row2, column_id);
+  return GetSortKey(row1, column_id).compare(GetSortKey(row2, column_id));
+}
 
-  NOTREACHED();
-  return 0;
+std::string TableModel::GetSortKey(int row, int column_id) {
+  icu::Collator* collator = GetCollator();
+  if (!collator)
+    return std::string();
+
+  string16 text = GetText(row, column_id);
+  // The first call returns the size of the key, including its terminating
+  // zero byte.
+  int32_t key_size = collator->getSortKey(text.c_str(), text.length(),
+                                          NULL, 0);
+  if (key_size <= 1)
+    return std::string();
+  std::string key(key_size, '\0');
+  collator->getSortKey(text.c_str(), text.length(),
+                       reinterpret_cast<uint8_t*>(&key[0]), key_size);
+  key.resize(key_size - 1);
+  return key;
+}
+
+bool TableModel::HasSortKeys() {
+  return false;
+}
+
+void TableModel::ClearCollator() {
+  delete g_collator;
+  g_collator = NULL;
+}
+
+icu::Collator* TableModel::GetCollator() {
+  if (!g_collator) {
+    UErrorCode create_status = U_ZERO_ERROR;
+    g_collator = icu::Collator::createInstance(create_status);
+    if (!U_SUCCESS(create_status)) {
+      g_collator = NULL;
+      NOTREACHED();
+    }
+  }
+  return g_collator;
 }
 
 }  // namespace ui
@@ -5,10 +5,12 @@
 #ifndef UI_BASE_MODELS_TABLE_MODEL_H_
 #define UI_BASE_MODELS_TABLE_MODEL_H_
 
+#include <string>
 #include <vector>
 
 #include "base/string16.h"
 #include "uibase/ui_export.h"
+#include "unicode/coll.h"
 
 namespace gfx {
 class ImageSkia;
@@ -75,15 +77,31 @@ class UI_EXPORT TableModel {
   // Returns a value < 0, == 0 or > 0 as to whether the first value is
   // <, == or > the second value.
   //
-  // This implementation does a case insensitive locale specific string
-  // comparison.
+  // This implementation compares the values returned by GetSortKey(), which
+  // gives the locale specific collation order of the cell text.
   virtual int CompareValues(int row1, int row2, int column_id);
 
+  // Returns a key for the value in column |column_id| of |row|. Comparing the
+  // keys of two rows byte by byte gives the same order as CompareValues(),
+  // which lets TableView compute the key once per row instead of once per
+  // comparison. The default returns the collation sort key of the cell text.
+  virtual std::string GetSortKey(int row, int column_id);
+
+  // Returns true if the rows can be ordered by comparing GetSortKey(). The
+  // default returns false, and TableView calls CompareValues() for every
+  // comparison. Models opt in by overriding both this and GetSortKey(), or
+  // this alone if they keep the default CompareValues().
+  virtual bool HasSortKeys();
+
   // Reset the collator.
   void ClearCollator();
 
  protected:
   virtual ~TableModel() {}
+
+  // Returns the collator used by GetSortKey(), or NULL if none could be
+  // created.
+  icu::Collator* GetCollator();
 };
 
 // TableColumn specifies the title, alignment and size of a particular column.
@@ -6,6 +6,13 @@
 
 #include <errno.h>
 
+#if defined(OS_POSIX)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+
 #include "base/file_util.h"
 #include "base/logging.h"
 #include "base/memory/ref_counted_memory.h"
@@ -18,8 +25,18 @@
 namespace {
 
 static const uint32 kFileFormatVersion = 4;
+// Version 5 stores the length of every resource after the index, so that the
+// resource data no longer has to be laid out in id order, and records the
+// length of the hot range at the front of the data.
+static const uint32 kHotOrderedFileFormatVersion = 5;
 // Length of file header: version, entry count and text encoding type.
 static const size_t kHeaderLength = 2 * sizeof(uint32) + sizeof(uint8);
+// Version 5 appends the length of the hot range to the header.
+static const size_t kHotOrderedHeaderLength = kHeaderLength + sizeof(uint32);
+
+#if defined(OS_WIN)
+static const size_t kPageSize = 4096;
+#endif
 
 #pragma pack(push,2)
 struct DataPackEntry {
@@ -43,6 +60,22 @@ struct DataPackEntry {
 
 COMPILE_ASSERT(sizeof(DataPackEntry) == 6, size_of_entry_must_be_six);
 
+// Reads a uint32 from |data|, which doesn't have to be aligned.
+uint32 ReadUint32(const uint8* data) {
+  uint32 value;
+  memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+// Writes |size| bytes at |data| to |file|, logging |what| on failure.
+bool WriteToFile(FILE* file, const void* data, size_t size, const char* what) {
+  if (size && fwrite(data, size, 1, file) != 1) {
+    LOG(ERROR) << "Failed to write " << what;
+    return false;
+  }
+  return true;
+}
+
 // We're crashing when trying to load a pak file on Windows.  Add some error
 // codes for logging.
 // http://crbug.com/58056
@@ -63,9 +96,15 @@ enum LoadErrors {
 namespace ui {
 
 DataPack::DataPack(ui::ScaleFactor scale_factor)
-    : resource_count_(0),
+    : version_(0),
+      resource_count_(0),
+      index_offset_(0),
+      lengths_offset_(0),
+      hot_data_offset_(0),
+      hot_data_length_(0),
       text_encoding_type_(BINARY),
-      scale_factor_(scale_factor) {
+      scale_factor_(scale_factor),
+      recording_accesses_(0) {
 }
 
 DataPack::~DataPack() {
@@ -108,10 +147,12 @@ bool DataPack::LoadImpl() {
   // Parse the header of the file.
   // First uint32: version; second: resource count;
   const uint32* ptr = reinterpret_cast<const uint32*>(mmap_->data());
-  uint32 version = ptr[0];
-  if (version != kFileFormatVersion) {
-    LOG(ERROR) << "Bad data pack version: got " << version << ", expected "
-               << kFileFormatVersion;
+  version_ = ptr[0];
+  if (version_ != kFileFormatVersion &&
+      version_ != kHotOrderedFileFormatVersion) {
+    LOG(ERROR) << "Bad data pack version: got " << version_ << ", expected "
+               << kFileFormatVersion << " or "
+               << kHotOrderedFileFormatVersion;
     UMA_HISTOGRAM_ENUMERATION("DataPack.Load", BAD_VERSION,
                               LOAD_ERRORS_COUNT);
     mmap_.reset();
@@ -119,6 +160,22 @@ bool DataPack::LoadImpl() {
   }
   resource_count_ = ptr[1];
 
+  index_offset_ = kHeaderLength;
+  lengths_offset_ = 0;
+  hot_data_offset_ = 0;
+  hot_data_length_ = 0;
+  if (version_ == kHotOrderedFileFormatVersion) {
+    if (kHotOrderedHeaderLength > mmap_->length()) {
+      DLOG(ERROR) << "Data pack file corruption: incomplete file header.";
+      UMA_HISTOGRAM_ENUMERATION("DataPack.Load", HEADER_TRUNCATED,
+                                LOAD_ERRORS_COUNT);
+      mmap_.reset();
+      return false;
+    }
+    index_offset_ = kHotOrderedHeaderLength;
+    hot_data_length_ = ReadUint32(mmap_->data() + kHeaderLength);
+  }
+
   // third: text encoding.
   const uint8* ptr_encoding = reinterpret_cast<const uint8*>(ptr + 2);
   text_encoding_type_ = static_cast<TextEncodingType>(*ptr_encoding);
@@ -134,7 +191,7 @@ bool DataPack::LoadImpl() {
 
   // Sanity check the file.
   // 1) Check we have enough entries.
-  if (kHeaderLength + resource_count_ * sizeof(DataPackEntry) >
+  if (index_offset_ + (resource_count_ + 1) * sizeof(DataPackEntry) >
       mmap_->length()) {
     LOG(ERROR) << "Data pack file corruption: too short for number of "
                   "entries specified.";
@@ -147,7 +204,7 @@ bool DataPack::LoadImpl() {
   // entry after the last item which gives us the length of the last item.
   for (size_t i = 0; i < resource_count_ + 1; ++i) {
     const DataPackEntry* entry = reinterpret_cast<const DataPackEntry*>(
-        mmap_->data() + kHeaderLength + (i * sizeof(DataPackEntry)));
+        mmap_->data() + index_offset_ + (i * sizeof(DataPackEntry)));
     if (entry->file_offset > mmap_->length()) {
       LOG(ERROR) << "Entry #" << i << " in data pack points off end of file. "
                  << "Was the file corrupted?";
@@ -158,11 +215,42 @@ bool DataPack::LoadImpl() {
     }
   }
 
+  if (version_ == kHotOrderedFileFormatVersion) {
+    // 3) Verify the length table and that every resource, as well as the hot
+    // range that follows the table, ends within the file.
+    lengths_offset_ =
+        index_offset_ + (resource_count_ + 1) * sizeof(DataPackEntry);
+    hot_data_offset_ = lengths_offset_ + resource_count_ * sizeof(uint32);
+    if (hot_data_offset_ > mmap_->length() ||
+        hot_data_length_ > mmap_->length() - hot_data_offset_) {
+      LOG(ERROR) << "Data pack file corruption: too short for the length "
+                    "table and hot range.";
+      UMA_HISTOGRAM_ENUMERATION("DataPack.Load", INDEX_TRUNCATED,
+                                LOAD_ERRORS_COUNT);
+      mmap_.reset();
+      return false;
+    }
+    for (size_t i = 0; i < resource_count_; ++i) {
+      const DataPackEntry* entry = reinterpret_cast<const DataPackEntry*>(
+          mmap_->data() + index_offset_ + (i * sizeof(DataPackEntry)));
+      uint32 length =
+          ReadUint32(mmap_->data() + lengths_offset_ + i * sizeof(uint32));
+      if (length > mmap_->length() - entry->file_offset) {
+        LOG(ERROR) << "Entry #" << i << " in data pack extends past the end "
+                   << "of the file. Was the file corrupted?";
+        UMA_HISTOGRAM_ENUMERATION("DataPack.Load", ENTRY_NOT_FOUND,
+                                  LOAD_ERRORS_COUNT);
+        mmap_.reset();
+        return false;
+      }
+    }
+  }
+
   return true;
 }
 
 bool DataPack::HasResource(uint16 resource_id) const {
-  return !!bsearch(&resource_id, mmap_->data() + kHeaderLength, resource_count_,
+  return !!bsearch(&resource_id, mmap_->data() + index_offset_, resource_count_,
                    sizeof(DataPackEntry), DataPackEntry::CompareById);
 }
 
@@ -179,16 +267,25 @@ bool DataPack::GetStringPiece(uint16 resource_id,
   #error DataPack assumes little endian
 #endif
 
+  const DataPackEntry* index = reinterpret_cast<const DataPackEntry*>(
+      mmap_->data() + index_offset_);
   const DataPackEntry* target = reinterpret_cast<const DataPackEntry*>(
-      bsearch(&resource_id, mmap_->data() + kHeaderLength, resource_count_,
+      bsearch(&resource_id, index, resource_count_,
               sizeof(DataPackEntry), DataPackEntry::CompareById));
   if (!target) {
     return false;
   }
 
-  const DataPackEntry* next_entry = target + 1;
-  size_t length = next_entry->file_offset - target->file_offset;
+  size_t length = 0;
+  if (lengths_offset_) {
+    length = ReadUint32(mmap_->data() + lengths_offset_ +
+                        (target - index) * sizeof(uint32));
+  } else {
+    const DataPackEntry* next_entry = target + 1;
+    length = next_entry->file_offset - target->file_offset;
+  }
 
+  RecordAccess(resource_id);
   data->set(mmap_->data() + target->file_offset, length);
   return true;
 }
@@ -211,95 +308,165 @@ ui::ScaleFactor DataPack::GetScaleFactor() const {
   return scale_factor_;
 }
 
+void DataPack::StartRecordingAccesses() {
+  base::AutoLock lock_scope(recording_lock_);
+  recorded_ids_.clear();
+  recorded_accesses_.clear();
+  base::subtle::NoBarrier_Store(&recording_accesses_, 1);
+}
+
+std::vector<uint16> DataPack::StopRecordingAccesses() {
+  base::AutoLock lock_scope(recording_lock_);
+  base::subtle::NoBarrier_Store(&recording_accesses_, 0);
+  recorded_ids_.clear();
+  std::vector<uint16> accesses;
+  accesses.swap(recorded_accesses_);
+  return accesses;
+}
+
+void DataPack::PrefetchHotResources() const {
+  if (!mmap_.get() || !hot_data_length_)
+    return;
+
+  const uint8* start = mmap_->data() + hot_data_offset_;
+#if defined(OS_POSIX)
+  // madvise() wants a page aligned start address.
+  const uintptr_t page_size = sysconf(_SC_PAGESIZE);
+  const uintptr_t aligned_start =
+      reinterpret_cast<uintptr_t>(start) & ~(page_size - 1);
+  const size_t length =
+      hot_data_length_ + (reinterpret_cast<uintptr_t>(start) - aligned_start);
+  if (madvise(reinterpret_cast<void*>(aligned_start), length,
+              MADV_WILLNEED) != 0) {
+    DPLOG(WARNING) << "madvise failed on data pack hot range";
+  }
+#else
+  // There is no portable read-ahead hint on Windows XP; fault the range in
+  // sequentially instead, which lets the cache manager read ahead.
+  volatile uint8 sink = 0;
+  for (size_t offset = 0; offset < hot_data_length_; offset += kPageSize)
+    sink ^= start[offset];
+#endif
+}
+
+void DataPack::RecordAccess(uint16 resource_id) const {
+  if (!base::subtle::NoBarrier_Load(&recording_accesses_))
+    return;
+  base::AutoLock lock_scope(recording_lock_);
+  if (base::subtle::NoBarrier_Load(&recording_accesses_) &&
+      recorded_ids_.insert(resource_id).second) {
+    recorded_accesses_.push_back(resource_id);
+  }
+}
+
 // static
 bool DataPack::WritePack(const FilePath& path,
                          const std::map<uint16, base::StringPiece>& resources,
                          TextEncodingType textEncodingType) {
-  FILE* file = file_util::OpenFile(path, "wb");
-  if (!file)
-    return false;
-
-  if (fwrite(&kFileFormatVersion, sizeof(kFileFormatVersion), 1, file) != 1) {
-    LOG(ERROR) << "Failed to write file version";
-    file_util::CloseFile(file);
-    return false;
-  }
+  return WritePack(path, resources, textEncodingType, std::vector<uint16>());
+}
 
-  // Note: the python version of this function explicitly sorted keys, but
-  // std::map is a sorted associative container, we shouldn't have to do that.
-  uint32 entry_count = resources.size();
-  if (fwrite(&entry_count, sizeof(entry_count), 1, file) != 1) {
-    LOG(ERROR) << "Failed to write entry count";
-    file_util::CloseFile(file);
-    return false;
-  }
+// static
+bool DataPack::WritePack(const FilePath& path,
+                         const std::map<uint16, base::StringPiece>& resources,
+                         TextEncodingType textEncodingType,
+                         const std::vector<uint16>& hot_resource_ids) {
+  typedef std::map<uint16, base::StringPiece> ResourceMap;
 
   if (textEncodingType != UTF8 && textEncodingType != UTF16 &&
       textEncodingType != BINARY) {
     LOG(ERROR) << "Invalid text encoding type, got " << textEncodingType
                << ", expected between " << BINARY << " and " << UTF16;
-    file_util::CloseFile(file);
     return false;
   }
 
-  uint8 write_buffer = textEncodingType;
-  if (fwrite(&write_buffer, sizeof(uint8), 1, file) != 1) {
-    LOG(ERROR) << "Failed to write file text resources encoding";
-    file_util::CloseFile(file);
-    return false;
+  // Decide the order of the resource data: hot resources first, in the order
+  // given, then the remaining ones in id order.
+  std::vector<ResourceMap::const_iterator> layout;
+  std::set<uint16> placed;
+  for (size_t i = 0; i < hot_resource_ids.size(); ++i) {
+    ResourceMap::const_iterator it = resources.find(hot_resource_ids[i]);
+    if (it != resources.end() && placed.insert(it->first).second)
+      layout.push_back(it);
+  }
+  const size_t hot_count = layout.size();
+  for (ResourceMap::const_iterator it = resources.begin();
+       it != resources.end(); ++it) {
+    if (!placed.count(it->first))
+      layout.push_back(it);
   }
 
+  // Without hot resources, the data is in id order and the original format
+  // is written so that older readers can still load the pack.
+  const bool hot_ordered = hot_count > 0;
+  const uint32 version =
+      hot_ordered ? kHotOrderedFileFormatVersion : kFileFormatVersion;
+
+  // Note: the python version of this function explicitly sorted keys, but
+  // std::map is a sorted associative container, we shouldn't have to do that.
+  uint32 entry_count = resources.size();
+
   // Each entry is a uint16 + a uint32. We have an extra entry after the last
   // item so we can compute the size of the list item.
   uint32 index_length = (entry_count + 1) * sizeof(DataPackEntry);
   uint32 data_offset = kHeaderLength + index_length;
-  for (std::map<uint16, base::StringPiece>::const_iterator it =
-           resources.begin();
-       it != resources.end(); ++it) {
-    uint16 resource_id = it->first;
-    if (fwrite(&resource_id, sizeof(resource_id), 1, file) != 1) {
-      LOG(ERROR) << "Failed to write id for " << resource_id;
-      file_util::CloseFile(file);
-      return false;
-    }
+  if (hot_ordered)
+    data_offset += sizeof(uint32) + entry_count * sizeof(uint32);
+
+  std::map<uint16, uint32> offsets;
+  uint32 hot_length = 0;
+  for (size_t i = 0; i < layout.size(); ++i) {
+    offsets[layout[i]->first] = data_offset;
+    data_offset += layout[i]->second.length();
+    if (i < hot_count)
+      hot_length += layout[i]->second.length();
+  }
 
-    if (fwrite(&data_offset, sizeof(data_offset), 1, file) != 1) {
-      LOG(ERROR) << "Failed to write offset for " << resource_id;
-      file_util::CloseFile(file);
-      return false;
-    }
+  FILE* file = file_util::OpenFile(path, "wb");
+  if (!file)
+    return false;
 
-    data_offset += it->second.length();
+  uint8 write_buffer = textEncodingType;
+  bool ok =
+      WriteToFile(file, &version, sizeof(version), "file version") &&
+      WriteToFile(file, &entry_count, sizeof(entry_count), "entry count") &&
+      WriteToFile(file, &write_buffer, sizeof(uint8),
+                  "file text resources encoding");
+  if (ok && hot_ordered)
+    ok = WriteToFile(file, &hot_length, sizeof(hot_length), "hot length");
+
+  // The index stays sorted by id so that lookups can binary search it.
+  for (ResourceMap::const_iterator it = resources.begin();
+       ok && it != resources.end(); ++it) {
+    uint16 resource_id = it->first;
+    uint32 offset = offsets[resource_id];
+    ok = WriteToFile(file, &resource_id, sizeof(resource_id), "resource id") &&
+         WriteToFile(file, &offset, sizeof(offset), "resource offset");
   }
 
   // We place an extra entry after the last item that allows us to read the
   // size of the last item.
   uint16 resource_id = 0;
-  if (fwrite(&resource_id, sizeof(resource_id), 1, file) != 1) {
-    LOG(ERROR) << "Failed to write extra resource id.";
-    file_util::CloseFile(file);
-    return false;
-  }
-
-  if (fwrite(&data_offset, sizeof(data_offset), 1, file) != 1) {
-    LOG(ERROR) << "Failed to write extra offset.";
-    file_util::CloseFile(file);
-    return false;
+  ok = ok &&
+       WriteToFile(file, &resource_id, sizeof(resource_id),
+                   "extra resource id") &&
+       WriteToFile(file, &data_offset, sizeof(data_offset), "extra offset");
+
+  if (hot_ordered) {
+    for (ResourceMap::const_iterator it = resources.begin();
+         ok && it != resources.end(); ++it) {
+      uint32 length = it->second.length();
+      ok = WriteToFile(file, &length, sizeof(length), "resource length");
+    }
   }
 
-  for (std::map<uint16, base::StringPiece>::const_iterator it =
-           resources.begin();
-       it != resources.end(); ++it) {
-    if (fwrite(it->second.data(), it->second.length(), 1, file) != 1) {
-      LOG(ERROR) << "Failed to write data for " << it->first;
-      file_util::CloseFile(file);
-      return false;
-    }
+  for (size_t i = 0; ok && i < layout.size(); ++i) {
+    ok = WriteToFile(file, layout[i]->second.data(),
+                     layout[i]->second.length(), "resource data");
   }
 
   file_util::CloseFile(file);
-
-  return true;
+  return ok;
 }
 
 }  // namespace ui
@@ -10,11 +10,15 @@
 #define UI_BASE_RESOURCE_DATA_PACK_H_
 
 #include <map>
+#include <set>
+#include <vector>
 
+#include "base/atomicops.h"
 #include "base/basictypes.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/platform_file.h"
 #include "base/string_piece.h"
+#include "base/synchronization/lock.h"
 #include "uibase/layout.h"
 #include "uibase/resource/resource_handle.h"
 #include "uibase/ui_export.h"
@@ -50,6 +54,30 @@ class UI_EXPORT DataPack : public ResourceHandle {
                         const std::map<uint16, base::StringPiece>& resources,
                         TextEncodingType textEncodingType);
 
+  // Same as above, but places the resources in |hot_resource_ids| first in
+  // the file, in that order, followed by the rest in id order. Typically
+  // |hot_resource_ids| is an access order recorded with
+  // StartRecordingAccesses() during a previous startup, so that a cold start
+  // touches one contiguous range of the file instead of pages all over it.
+  // Ids in |hot_resource_ids| that aren't in |resources| are ignored. If no
+  // hot resources remain, this writes the same file as the overload above.
+  static bool WritePack(const FilePath& path,
+                        const std::map<uint16, base::StringPiece>& resources,
+                        TextEncodingType textEncodingType,
+                        const std::vector<uint16>& hot_resource_ids);
+
+  // Starts recording the order in which resources are first read from this
+  // pack through GetStringPiece().
+  void StartRecordingAccesses();
+
+  // Stops recording and returns the ids read since StartRecordingAccesses(),
+  // in first-access order.
+  std::vector<uint16> StopRecordingAccesses();
+
+  // Asks the OS to read the hot range written by the hot-ordered WritePack()
+  // into memory ahead of use. Does nothing for packs without a hot range.
+  void PrefetchHotResources() const;
+
   // ResourceHandle implementation:
   virtual bool HasResource(uint16 resource_id) const OVERRIDE;
   virtual bool GetStringPiece(uint16 resource_id,
@@ -63,12 +91,29 @@ class UI_EXPORT DataPack : public ResourceHandle {
   // Does the actual loading of a pack file. Called by Load and LoadFromFile.
   bool LoadImpl();
 
+  // Records |resource_id| as accessed if recording is on.
+  void RecordAccess(uint16 resource_id) const;
+
   // The memory-mapped data.
   scoped_ptr<file_util::MemoryMappedFile> mmap_;
 
+  // File format version of the loaded pack.
+  uint32 version_;
+
   // Number of resources in the data.
   size_t resource_count_;
 
+  // Offset of the index in the file.
+  size_t index_offset_;
+
+  // Offset of the per-resource length table, or 0 if lengths are derived
+  // from the offset of the next index entry (older packs).
+  size_t lengths_offset_;
+
+  // Range of the file holding the hot resources, empty for older packs.
+  size_t hot_data_offset_;
+  size_t hot_data_length_;
+
   // Type of encoding for text resources.
   TextEncodingType text_encoding_type_;
 
@@ -76,6 +121,15 @@ class UI_EXPORT DataPack : public ResourceHandle {
   // resource pak.
   ui::ScaleFactor scale_factor_;
 
+  // Non-zero while accesses are recorded. Read without |recording_lock_| so
+  // that lookups don't pay for recording when it's off.
+  mutable base::subtle::Atomic32 recording_accesses_;
+
+  // Protects the recorded accesses below.
+  mutable base::Lock recording_lock_;
+  mutable std::set<uint16> recorded_ids_;
+  mutable std::vector<uint16> recorded_accesses_;
+
   DISALLOW_COPY_AND_ASSIGN(DataPack);
 };
 
@@ -0,0 +1,151 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "uibase/resource/image_preloader.h"
+
+#include <algorithm>
+#include <string>
+
+#include "base/file_path.h"
+#include "base/file_util.h"
+#include "base/logging.h"
+#include "base/string_number_conversions.h"
+#include "base/string_split.h"
+#include "base/string_util.h"
+#include "uibase/resource/resource_bundle.h"
+
+namespace ui {
+
+class ImagePreloader::Worker : public base::PlatformThread::Delegate {
+ public:
+  explicit Worker(ImagePreloader* preloader) : preloader_(preloader) {}
+  virtual ~Worker() {}
+
+  // base::PlatformThread::Delegate implementation:
+  virtual void ThreadMain() OVERRIDE {
+    base::PlatformThread::SetName("ImagePreloader");
+    preloader_->RunWorker();
+  }
+
+ private:
+  ImagePreloader* preloader_;
+
+  DISALLOW_COPY_AND_ASSIGN(Worker);
+};
+
+ImagePreloader::Stats::Stats()
+    : images_requested(0),
+      images_decoded(0),
+      images_failed(0) {
+}
+
+ImagePreloader::ImagePreloader(ResourceBundle* resource_bundle)
+    : resource_bundle_(resource_bundle),
+      next_index_(0) {
+}
+
+ImagePreloader::~ImagePreloader() {
+  Wait();
+}
+
+void ImagePreloader::Start(const std::vector<int>& resource_ids,
+                           int num_threads) {
+  DCHECK(workers_.empty()) << "Start called twice";
+  DCHECK_GT(num_threads, 0);
+
+  {
+    base::AutoLock lock_scope(lock_);
+    resource_ids_ = resource_ids;
+    stats_.images_requested = resource_ids.size();
+  }
+  start_time_ = base::TimeTicks::Now();
+
+  // No point in starting more threads than there are images.
+  num_threads = std::min(num_threads, static_cast<int>(resource_ids.size()));
+  for (int i = 0; i < num_threads; ++i) {
+    Worker* worker = new Worker(this);
+    base::PlatformThreadHandle handle;
+    if (!base::PlatformThread::Create(0, worker, &handle)) {
+      LOG(WARNING) << "Unable to start image preloading thread";
+      delete worker;
+      break;
+    }
+    workers_.push_back(worker);
+    thread_handles_.push_back(handle);
+  }
+}
+
+void ImagePreloader::Wait() {
+  for (size_t i = 0; i < thread_handles_.size(); ++i)
+    base::PlatformThread::Join(thread_handles_[i]);
+  thread_handles_.clear();
+  workers_.clear();
+}
+
+ImagePreloader::Stats ImagePreloader::stats() const {
+  base::AutoLock lock_scope(lock_);
+  return stats_;
+}
+
+// static
+bool ImagePreloader::ReadProfile(const FilePath& path,
+                                 std::vector<int>* resource_ids) {
+  std::string contents;
+  if (!file_util::ReadFileToString(path, &contents))
+    return false;
+
+  std::vector<std::string> lines;
+  base::SplitString(contents, '\n', &lines);
+  resource_ids->clear();
+  for (size_t i = 0; i < lines.size(); ++i) {
+    std::string line;
+    TrimWhitespaceASCII(lines[i], TRIM_ALL, &line);
+    int resource_id = 0;
+    if (base::StringToInt(line, &resource_id))
+      resource_ids->push_back(resource_id);
+  }
+  return true;
+}
+
+// static
+bool ImagePreloader::WriteProfile(const FilePath& path,
+                                  const std::vector<int>& resource_ids) {
+  std::string contents;
+  for (size_t i = 0; i < resource_ids.size(); ++i) {
+    contents += base::IntToString(resource_ids[i]);
+    contents += '\n';
+  }
+  int size = static_cast<int>(contents.size());
+  return file_util::WriteFile(path, contents.data(), size) == size;
+}
+
+void ImagePreloader::RunWorker() {
+  for (;;) {
+    int resource_id = 0;
+    {
+      base::AutoLock lock_scope(lock_);
+      if (next_index_ >= resource_ids_.size())
+        return;
+      resource_id = resource_ids_[next_index_++];
+    }
+
+    const base::TimeTicks decode_start = base::TimeTicks::Now();
+    bool decoded = false;
+    bool found = resource_bundle_->LoadAndCacheImage(resource_id, &decoded) !=
+        NULL;
+    const base::TimeTicks decode_end = base::TimeTicks::Now();
+
+    base::AutoLock lock_scope(lock_);
+    if (!found) {
+      ++stats_.images_failed;
+    } else if (decoded) {
+      ++stats_.images_decoded;
+      stats_.decode_time += decode_end - decode_start;
+    }
+    stats_.elapsed_time = std::max(stats_.elapsed_time,
+                                   decode_end - start_time_);
+  }
+}
+
+}  // namespace ui
@@ -0,0 +1,103 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef UI_BASE_RESOURCE_IMAGE_PRELOADER_H_
+#define UI_BASE_RESOURCE_IMAGE_PRELOADER_H_
+
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/memory/scoped_vector.h"
+#include "base/synchronization/lock.h"
+#include "base/threading/platform_thread.h"
+#include "base/time.h"
+#include "uibase/ui_export.h"
+
+class FilePath;
+
+namespace ui {
+
+class ResourceBundle;
+
+// Decodes a list of image resources on a small pool of background threads
+// and publishes them into the ResourceBundle image cache. Used through
+// ResourceBundle::PreloadImages() to take PNG decoding off the first paint
+// of the first window.
+class UI_EXPORT ImagePreloader {
+ public:
+  struct UI_EXPORT Stats {
+    Stats();
+
+    // Number of ids passed to Start().
+    size_t images_requested;
+
+    // Number of images decoded by the preloading threads. Images that were
+    // already cached, or that another thread was already decoding, are not
+    // counted.
+    size_t images_decoded;
+
+    // Number of ids that could not be loaded.
+    size_t images_failed;
+
+    // Decode time spent on the preloading threads. This is the decode work
+    // that no longer happens on the thread that first asks for the images.
+    base::TimeDelta decode_time;
+
+    // Wall time from Start() until the last image was decoded.
+    base::TimeDelta elapsed_time;
+  };
+
+  explicit ImagePreloader(ResourceBundle* resource_bundle);
+
+  // Waits for the preloading threads to finish.
+  ~ImagePreloader();
+
+  // Starts |num_threads| threads decoding |resource_ids| in list order.
+  void Start(const std::vector<int>& resource_ids, int num_threads);
+
+  // Blocks until every id passed to Start() has been processed.
+  void Wait();
+
+  // Returns the current statistics. Only final after Wait().
+  Stats stats() const;
+
+  // Reads a profile of image ids written by WriteProfile() from |path| into
+  // |resource_ids|. Returns false if the file can't be read.
+  static bool ReadProfile(const FilePath& path,
+                          std::vector<int>* resource_ids);
+
+  // Writes |resource_ids|, e.g. from
+  // ResourceBundle::StopRecordingImageLoads(), to |path|, one id per line.
+  static bool WriteProfile(const FilePath& path,
+                           const std::vector<int>& resource_ids);
+
+ private:
+  class Worker;
+
+  // Runs on the preloading threads: decodes ids until the list is exhausted.
+  void RunWorker();
+
+  ResourceBundle* resource_bundle_;
+
+  ScopedVector<Worker> workers_;
+  std::vector<base::PlatformThreadHandle> thread_handles_;
+
+  base::TimeTicks start_time_;
+
+  // Protects the members below.
+  mutable base::Lock lock_;
+
+  std::vector<int> resource_ids_;
+
+  // Index in |resource_ids_| of the next id to decode.
+  size_t next_index_;
+
+  Stats stats_;
+
+  DISALLOW_COPY_AND_ASSIGN(ImagePreloader);
+};
+
+}  // namespace ui
+
+#endif  // UI_BASE_RESOURCE_IMAGE_PRELOADER_H_
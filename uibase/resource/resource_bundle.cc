@@ -6,6 +6,7 @@
 
 #include <vector>
 
+#include "base/atomicops.h"
 #include "base/command_line.h"
 #include "base/file_util.h"
 #include "base/logging.h"
@@ -360,52 +361,21 @@ gfx::ImageSkia* ResourceBundle::GetImageSkiaNamed(int resource_id) {
 }
 
 gfx::Image& ResourceBundle::GetImageNamed(int resource_id) {
-  // Check to see if the image is already in the cache.
-  {
-    base::AutoLock lock_scope(*images_and_fonts_lock_);
-    if (images_.count(resource_id))
-      return images_[resource_id];
+  if (base::subtle::NoBarrier_Load(&recording_image_loads_)) {
+    base::AutoLock lock_scope(*image_load_recording_lock_);
+    if (base::subtle::NoBarrier_Load(&recording_image_loads_) &&
+        recorded_image_ids_.insert(resource_id).second)
+      recorded_image_loads_.push_back(resource_id);
   }
 
-  gfx::Image image;
-  if (delegate_)
-    image = delegate_->GetImageNamed(resource_id);
-
-  if (image.IsEmpty()) {
-    DCHECK(!delegate_ && !data_packs_.empty()) <<
-        "Missing call to SetResourcesDataDLL?";
-
-    // TODO(oshima): Consider reading the image size from png IHDR chunk and
-    // skip decoding here and remove #ifdef below.
-    // ResourceBundle::GetSharedInstance() is destroyed after the
-    // BrowserMainLoop has finished running. |image_skia| is guaranteed to be
-    // destroyed before the resource bundle is destroyed.
-#if defined(OS_CHROMEOS)
-    ui::ScaleFactor scale_factor_to_load = ui::GetMaxScaleFactor();
-#else
-    ui::ScaleFactor scale_factor_to_load = ui::SCALE_FACTOR_100P;
-#endif
-    gfx::ImageSkia image_skia(new ResourceBundleImageSource(this, resource_id),
-                              scale_factor_to_load);
-    if (image_skia.isNull()) {
-      LOG(WARNING) << "Unable to load image with id " << resource_id;
-      NOTREACHED();  // Want to assert in debug mode.
-      // The load failed to retrieve the image; show a debugging red square.
-      return GetEmptyImage();
-    }
-    image_skia.SetReadOnly();
-    image = gfx::Image(image_skia);
+  gfx::Image* image = LoadAndCacheImage(resource_id, NULL);
+  if (!image) {
+    LOG(WARNING) << "Unable to load image with id " << resource_id;
+    NOTREACHED();  // Want to assert in debug mode.
+    // The load failed to retrieve the image; show a debugging red square.
+    return GetEmptyImage();
   }
-
-  // The load was successful, so cache the image.
-  base::AutoLock lock_scope(*images_and_fonts_lock_);
-
-  // Another thread raced the load and has already cached the image.
-  if (images_.count(resource_id))
-    return images_[resource_id];
-
-  images_[resource_id] = image;
-  return images_[resource_id];
+  return *image;
 }
 
 gfx::Image& ResourceBundle::GetNativeImageNamed(int resource_id) {
@@ -540,20 +510,76 @@ void ResourceBundle::ReloadFonts() {
   LoadFontsIfNecessary();
 }
 
+void ResourceBundle::PreloadImages(const std::vector<int>& resource_ids,
+                                   int num_threads) {
+  DCHECK(!image_preloader_.get()) << "PreloadImages called twice";
+  // Delegates are only called on the UI thread, and may supply any image
+  // themselves, so their images are left to be loaded on first use.
+  if (delegate_)
+    return;
+  image_preloader_.reset(new ImagePreloader(this));
+  image_preloader_->Start(resource_ids, num_threads);
+}
+
+ImagePreloader::Stats ResourceBundle::WaitForPreloadedImages() {
+  if (!image_preloader_.get())
+    return ImagePreloader::Stats();
+  image_preloader_->Wait();
+  return image_preloader_->stats();
+}
+
+void ResourceBundle::StartRecordingImageLoads() {
+  base::AutoLock lock_scope(*image_load_recording_lock_);
+  recorded_image_ids_.clear();
+  recorded_image_loads_.clear();
+  base::subtle::NoBarrier_Store(&recording_image_loads_, 1);
+}
+
+std::vector<int> ResourceBundle::StopRecordingImageLoads() {
+  base::AutoLock lock_scope(*image_load_recording_lock_);
+  base::subtle::NoBarrier_Store(&recording_image_loads_, 0);
+  recorded_image_ids_.clear();
+  std::vector<int> image_loads;
+  image_loads.swap(recorded_image_loads_);
+  return image_loads;
+}
+
+void ResourceBundle::StartRecordingResourceAccesses() {
+  for (size_t i = 0; i < pak_files_.size(); ++i)
+    pak_files_[i]->StartRecordingAccesses();
+}
+
+std::vector<uint16> ResourceBundle::StopRecordingResourceAccesses(
+    ScaleFactor scale_factor) {
+  std::vector<uint16> accesses;
+  for (size_t i = 0; i < pak_files_.size(); ++i) {
+    std::vector<uint16> pack_accesses = pak_files_[i]->StopRecordingAccesses();
+    if (pak_files_[i]->GetScaleFactor() == scale_factor) {
+      accesses.insert(accesses.end(), pack_accesses.begin(),
+                      pack_accesses.end());
+    }
+  }
+  return accesses;
+}
+
 ResourceBundle::ResourceBundle(Delegate* delegate)
     : delegate_(delegate),
       images_and_fonts_lock_(new base::Lock),
       locale_resources_data_lock_(new base::Lock),
+      image_load_recording_lock_(new base::Lock),
+      recording_image_loads_(0),
       max_scale_factor_(SCALE_FACTOR_100P) {
 }
 
 ResourceBundle::~ResourceBundle() {
+  // Preloading threads decode into |images_|; stop them before freeing it.
+  image_preloader_.reset();
   FreeImages();
   UnloadLocaleResources();
 }
 
 void ResourceBundle::FreeImages() {
-  images_.clear();
+  images_.Clear();
 }
 
 void ResourceBundle::AddDataPackFromPathInternal(const FilePath& path,
@@ -583,6 +609,12 @@ void ResourceBundle::AddDataPackFromPathInternal(const FilePath& path,
 
 void ResourceBundle::AddDataPack(DataPack* data_pack) {
   data_packs_.push_back(data_pack);
+  pak_files_.push_back(data_pack);
+
+  if (CommandLine::ForCurrentProcess()->HasSwitch(
+          switches::kPrefetchHotResources)) {
+    data_pack->PrefetchHotResources();
+  }
 
   if (GetScaleFactorScale(data_pack->GetScaleFactor()) >
       GetScaleFactorScale(max_scale_factor_))
@@ -649,6 +681,51 @@ void ResourceBundle::LoadFontsIfNecessary() {
   }
 }
 
+gfx::Image* ResourceBundle::LoadAndCacheImage(int resource_id,
+                                              bool* loaded) {
+  if (loaded)
+    *loaded = false;
+
+  // Check to see if the image is already in the cache. If another thread is
+  // loading the same image, this waits for it rather than decoding it twice.
+  gfx::Image* cached_image = NULL;
+  if (!images_.BeginLoad(resource_id, &cached_image))
+    return cached_image;
+
+  gfx::Image image;
+  if (delegate_)
+    image = delegate_->GetImageNamed(resource_id);
+
+  if (image.IsEmpty()) {
+    DCHECK(!delegate_ && !data_packs_.empty()) <<
+        "Missing call to SetResourcesDataDLL?";
+
+    // TODO(oshima): Consider reading the image size from png IHDR chunk and
+    // skip decoding here and remove #ifdef below.
+    // ResourceBundle::GetSharedInstance() is destroyed after the
+    // BrowserMainLoop has finished running. |image_skia| is guaranteed to be
+    // destroyed before the resource bundle is destroyed.
+#if defined(OS_CHROMEOS)
+    ui::ScaleFactor scale_factor_to_load = ui::GetMaxScaleFactor();
+#else
+    ui::ScaleFactor scale_factor_to_load = ui::SCALE_FACTOR_100P;
+#endif
+    gfx::ImageSkia image_skia(new ResourceBundleImageSource(this, resource_id),
+                              scale_factor_to_load);
+    if (image_skia.isNull()) {
+      images_.AbortLoad(resource_id);
+      return NULL;
+    }
+    image_skia.SetReadOnly();
+    image = gfx::Image(image_skia);
+  }
+
+  // The load was successful, so cache the image.
+  if (loaded)
+    *loaded = true;
+  return &images_.FinishLoad(resource_id, image);
+}
+
 bool ResourceBundle::LoadBitmap(const ResourceHandle& data_handle,
                                 int resource_id,
                                 SkBitmap* bitmap,
@@ -8,8 +8,11 @@
 #include "base/build_config.h"
 
 #include <map>
+#include <set>
 #include <string>
+#include <vector>
 
+#include "base/atomicops.h"
 #include "base/basictypes.h"
 #include "base/file_path.h"
 #include "base/memory/scoped_ptr.h"
@@ -18,6 +21,8 @@
 #include "base/string16.h"
 #include "base/string_piece.h"
 #include "uibase/layout.h"
+#include "uibase/resource/image_preloader.h"
+#include "uibase/resource/resource_image_cache.h"
 #include "uibase/ui_export.h"
 #include "gfx/font.h"
 #include "gfx/image/image.h"
@@ -202,6 +207,39 @@ class UI_EXPORT ResourceBundle {
   // Same as GetNativeImageNamed() except that RTL is not enabled.
   gfx::Image& GetNativeImageNamed(int resource_id);
 
+  // Starts decoding the images in |resource_ids| on |num_threads| background
+  // threads and publishing them into the image cache, so that the first
+  // GetImageNamed() for them doesn't have to decode. Ids are decoded in list
+  // order, so put the images needed first at the front. A thread that asks
+  // for an image being preloaded waits for that decode instead of repeating
+  // it. Does nothing if a delegate is installed, since delegates are only
+  // called on the UI thread. May be called only once.
+  void PreloadImages(const std::vector<int>& resource_ids, int num_threads);
+
+  // Blocks until the preloading started by PreloadImages() is done and
+  // returns its statistics. Returns empty statistics if nothing was
+  // preloaded.
+  ImagePreloader::Stats WaitForPreloadedImages();
+
+  // Starts recording the order in which image resources are first requested
+  // through GetImageNamed(). The result can be saved with
+  // ImagePreloader::WriteProfile() and fed to PreloadImages() on the next
+  // run.
+  void StartRecordingImageLoads();
+
+  // Stops recording and returns the ids recorded since
+  // StartRecordingImageLoads(), in first-request order.
+  std::vector<int> StopRecordingImageLoads();
+
+  // Starts recording, in every resource pack loaded so far, the order in
+  // which resources are first read. See DataPack::StartRecordingAccesses().
+  void StartRecordingResourceAccesses();
+
+  // Stops recording and returns the ids read from the packs of
+  // |scale_factor|, in first-access order. Pass the result to
+  // DataPack::WritePack() to lay those packs out in access order.
+  std::vector<uint16> StopRecordingResourceAccesses(ScaleFactor scale_factor);
+
   // Loads the raw bytes of a scale independent data resource.
   base::RefCountedStaticMemory* LoadDataResourceBytes(int resource_id) const;
 
@@ -256,6 +294,7 @@ class UI_EXPORT ResourceBundle {
  private:
   class ResourceBundleImageSource;
   friend class ResourceBundleImageSource;
+  friend class ImagePreloader;
 
   // Ctor/dtor are private, since we're a singleton.
   explicit ResourceBundle(Delegate* delegate);
@@ -311,6 +350,11 @@ class UI_EXPORT ResourceBundle {
                   SkBitmap* bitmap,
                   bool* fell_back_to_1x) const;
 
+  // Returns the cached image for |resource_id|, decoding and caching it first
+  // if needed. Returns NULL if the image could not be loaded. If |loaded| is
+  // non-NULL, it is set to whether this call loaded the image.
+  gfx::Image* LoadAndCacheImage(int resource_id, bool* loaded);
+
   // Returns an empty image for when a resource cannot be loaded. This is a
   // bright red bitmap.
   gfx::Image& GetEmptyImage();
@@ -321,23 +365,38 @@ class UI_EXPORT ResourceBundle {
   // be NULL.
   Delegate* delegate_;
 
-  // Protects |images_| and font-related members.
+  // Protects |empty_image_| and font-related members. |images_| does its own
+  // locking.
   scoped_ptr<base::Lock> images_and_fonts_lock_;
 
   // Protects |locale_resources_data_|.
   scoped_ptr<base::Lock> locale_resources_data_lock_;
 
+  // Protects |recorded_image_ids_| and |recorded_image_loads_|.
+  scoped_ptr<base::Lock> image_load_recording_lock_;
+
+  // Non-zero while GetImageNamed() records the ids it is asked for. Read
+  // without the lock so that lookups don't pay for recording when it's off.
+  base::subtle::Atomic32 recording_image_loads_;
+  std::set<int> recorded_image_ids_;
+  std::vector<int> recorded_image_loads_;
+
+  // Background decoding started by PreloadImages(), if any.
+  scoped_ptr<ImagePreloader> image_preloader_;
+
   // Handles for data sources.
   scoped_ptr<ResourceHandle> locale_resources_data_;
   ScopedVector<ResourceHandle> data_packs_;
 
+  // The entries of |data_packs_| that are resource packs. Not owned.
+  std::vector<DataPack*> pak_files_;
+
   // The maximum scale factor currently loaded.
   ScaleFactor max_scale_factor_;
 
   // Cached images. The ResourceBundle caches all retrieved images and keeps
   // ownership of the pointers.
-  typedef std::map<int, gfx::Image> ImageMap;
-  ImageMap images_;
+  ResourceImageCache images_;
 
   gfx::Image empty_image_;
 
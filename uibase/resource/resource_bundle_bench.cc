@@ -0,0 +1,160 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// This small program measures contention in ResourceBundle::GetImageNamed().
+// It loads the given .pak file and starts N threads that all request the
+// image resources in [first_id, last_id], each thread starting at a
+// different offset so that the threads overlap on the same resources. The
+// first pass over the ids is cold (images are decoded); the remaining
+// iterations only hit the cache. Elapsed wall time is printed for both
+// phases.
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "base/at_exit.h"
+#include "base/basictypes.h"
+#include "base/command_line.h"
+#include "base/file_path.h"
+#include "base/format_macros.h"
+#include "base/string_number_conversions.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/threading/platform_thread.h"
+#include "base/time.h"
+#include "uibase/resource/resource_bundle.h"
+
+namespace {
+
+const int kDefaultThreads = 4;
+const int kDefaultIterations = 1000;
+
+class LookupThread : public base::PlatformThread::Delegate {
+ public:
+  LookupThread(int first_id, int last_id, int offset, int iterations,
+               base::WaitableEvent* start_event)
+      : first_id_(first_id),
+        last_id_(last_id),
+        offset_(offset),
+        iterations_(iterations),
+        start_event_(start_event) {
+  }
+  virtual ~LookupThread() {}
+
+  // base::PlatformThread::Delegate implementation:
+  virtual void ThreadMain() OVERRIDE {
+    start_event_->Wait();
+    ResourceBundle& rb = ResourceBundle::GetSharedInstance();
+    const int count = last_id_ - first_id_ + 1;
+
+    base::TimeTicks start = base::TimeTicks::Now();
+    for (int i = 0; i < count; ++i)
+      rb.GetImageNamed(first_id_ + (offset_ + i) % count);
+    cold_time_ = base::TimeTicks::Now() - start;
+
+    start = base::TimeTicks::Now();
+    for (int n = 1; n < iterations_; ++n) {
+      for (int i = 0; i < count; ++i)
+        rb.GetImageNamed(first_id_ + (offset_ + i) % count);
+    }
+    hot_time_ = base::TimeTicks::Now() - start;
+  }
+
+  base::TimeDelta cold_time() const { return cold_time_; }
+  base::TimeDelta hot_time() const { return hot_time_; }
+
+ private:
+  const int first_id_;
+  const int last_id_;
+  const int offset_;
+  const int iterations_;
+  base::WaitableEvent* start_event_;
+  base::TimeDelta cold_time_;
+  base::TimeDelta hot_time_;
+
+  DISALLOW_COPY_AND_ASSIGN(LookupThread);
+};
+
+void Usage() {
+  printf("resource_bundle_bench -pak file -first_id a -last_id b "
+         "[-threads n] [-iterations i] [-help]\n"
+         "  -pak file: resource pack to load images from\n"
+         "  -first_id a, -last_id b: range of image resource ids to request\n"
+         "  -threads n: number of requesting threads (default:%d)\n"
+         "  -iterations i: passes over the id range (default:%d)\n"
+         "  -help: prints this help and exits\n",
+         kDefaultThreads, kDefaultIterations);
+}
+
+bool GetIntSwitch(const CommandLine* command_line,
+                  const char* name,
+                  int* value) {
+  if (!command_line->HasSwitch(name))
+    return true;
+  return base::StringToInt(command_line->GetSwitchValueASCII(name), value);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  base::AtExitManager exit_manager;
+  CommandLine::Init(argc, argv);
+  const CommandLine* command_line = CommandLine::ForCurrentProcess();
+
+  int first_id = -1;
+  int last_id = -1;
+  int num_threads = kDefaultThreads;
+  int iterations = kDefaultIterations;
+  const FilePath pak_path = command_line->GetSwitchValuePath("pak");
+  if (command_line->HasSwitch("help") || pak_path.empty() ||
+      !GetIntSwitch(command_line, "first_id", &first_id) ||
+      !GetIntSwitch(command_line, "last_id", &last_id) ||
+      !GetIntSwitch(command_line, "threads", &num_threads) ||
+      !GetIntSwitch(command_line, "iterations", &iterations) ||
+      first_id < 0 || last_id < first_id || num_threads <= 0 ||
+      iterations <= 0) {
+    Usage();
+    return 1;
+  }
+
+  ResourceBundle::InitSharedInstanceWithPakPath(pak_path);
+
+  base::WaitableEvent start_event(true, false);
+  std::vector<LookupThread*> threads;
+  std::vector<base::PlatformThreadHandle> handles(num_threads);
+  const int count = last_id - first_id + 1;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.push_back(new LookupThread(first_id, last_id,
+                                       i * count / num_threads, iterations,
+                                       &start_event));
+    if (!base::PlatformThread::Create(0, threads[i], &handles[i])) {
+      printf("Failed to create thread %d\n", i);
+      return 1;
+    }
+  }
+
+  const base::TimeTicks start = base::TimeTicks::Now();
+  start_event.Signal();
+  base::TimeDelta max_cold_time;
+  base::TimeDelta max_hot_time;
+  for (int i = 0; i < num_threads; ++i) {
+    base::PlatformThread::Join(handles[i]);
+    max_cold_time = std::max(max_cold_time, threads[i]->cold_time());
+    max_hot_time = std::max(max_hot_time, threads[i]->hot_time());
+    delete threads[i];
+  }
+  const int64 elapsed_us = (base::TimeTicks::Now() - start).InMicroseconds();
+
+  const uint64 hot_lookups =
+      static_cast<uint64>(num_threads) * count * (iterations - 1);
+  const int64 hot_us = max_hot_time.InMicroseconds();
+  printf("threads=%d ids=%d elapsed=%"PRId64"us cold=%"PRId64"us "
+         "hot=%"PRId64"us (%"PRIu64" lookups/ms)\n",
+         num_threads, count, elapsed_us, max_cold_time.InMicroseconds(),
+         hot_us, hot_us == 0 ? 0 : hot_lookups * 1000 / hot_us);
+
+  ResourceBundle::CleanupSharedInstance();
+  return 0;
+}
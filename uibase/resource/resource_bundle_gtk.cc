@@ -77,11 +77,9 @@ gfx::Image& ResourceBundle::GetNativeImageNamed(int resource_id, ImageRTL rtl) {
   int key = rtl == RTL_ENABLED ? -resource_id : resource_id;
 
   // Check to see if the image is already in the cache.
-  {
-    base::AutoLock lock_scope(*images_and_fonts_lock_);
-    if (images_.count(key))
-      return images_[key];
-  }
+  gfx::Image* cached_image = images_.Lookup(key);
+  if (cached_image)
+    return *cached_image;
 
   gfx::Image image;
   if (delegate_)
@@ -101,14 +99,7 @@ gfx::Image& ResourceBundle::GetNativeImageNamed(int resource_id, ImageRTL rtl) {
     image = gfx::Image(pixbuf);  // Takes ownership.
   }
 
-  base::AutoLock lock_scope(*images_and_fonts_lock_);
-
-  // Another thread raced the load and has already cached the image.
-  if (images_.count(key))
-    return images_[key];
-
-  images_[key] = image;
-  return images_[key];
+  return images_.Insert(key, image);
 }
 
 }  // namespace ui
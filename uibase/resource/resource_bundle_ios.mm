@@ -91,13 +91,9 @@ gfx::Image& ResourceBundle::GetNativeImageNamed(int resource_id, ImageRTL rtl) {
   DCHECK_EQ(rtl, RTL_DISABLED);
 
   // Check to see if the image is already in the cache.
-  {
-    base::AutoLock lock(*images_and_fonts_lock_);
-    ImageMap::iterator found = images_.find(resource_id);
-    if (found != images_.end()) {
-      return found->second;
-    }
-  }
+  gfx::Image* cached_image = images_.Lookup(resource_id);
+  if (cached_image)
+    return *cached_image;
 
   gfx::Image image;
   if (delegate_)
@@ -130,14 +126,7 @@ gfx::Image& ResourceBundle::GetNativeImageNamed(int resource_id, ImageRTL rtl) {
     image = gfx::Image(ui_image.release());
   }
 
-  base::AutoLock lock(*images_and_fonts_lock_);
-
-  // Another thread raced the load and has already cached the image.
-  if (images_.count(resource_id))
-    return images_[resource_id];
-
-  images_[resource_id] = image;
-  return images_[resource_id];
+  return images_.Insert(resource_id, image);
 }
 
 }  // namespace ui
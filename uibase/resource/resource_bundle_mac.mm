@@ -100,17 +100,15 @@ gfx::Image& ResourceBundle::GetNativeImageNamed(int resource_id, ImageRTL rtl) {
   DCHECK_EQ(rtl, RTL_DISABLED);
 
   // Check to see if the image is already in the cache.
-  {
-    base::AutoLock lock(*images_and_fonts_lock_);
-    if (images_.count(resource_id)) {
-      if (!images_[resource_id].HasRepresentation(gfx::Image::kImageRepCocoa)) {
-        DLOG(WARNING) << "ResourceBundle::GetNativeImageNamed() is returning a"
-          << " cached gfx::Image that isn't backed by an NSImage. The image"
-          << " will be converted, rather than going through the NSImage loader."
-          << " resource_id = " << resource_id;
-      }
-      return images_[resource_id];
+  gfx::Image* cached_image = images_.Lookup(resource_id);
+  if (cached_image) {
+    if (!cached_image->HasRepresentation(gfx::Image::kImageRepCocoa)) {
+      DLOG(WARNING) << "ResourceBundle::GetNativeImageNamed() is returning a"
+        << " cached gfx::Image that isn't backed by an NSImage. The image"
+        << " will be converted, rather than going through the NSImage loader."
+        << " resource_id = " << resource_id;
     }
+    return *cached_image;
   }
 
   gfx::Image image;
@@ -146,14 +144,7 @@ gfx::Image& ResourceBundle::GetNativeImageNamed(int resource_id, ImageRTL rtl) {
     image = gfx::Image(ns_image.release());
   }
 
-  base::AutoLock lock(*images_and_fonts_lock_);
-
-  // Another thread raced the load and has already cached the image.
-  if (images_.count(resource_id))
-    return images_[resource_id];
-
-  images_[resource_id] = image;
-  return images_[resource_id];
+  return images_.Insert(resource_id, image);
 }
 
 }  // namespace ui
@@ -0,0 +1,98 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "uibase/resource/resource_image_cache.h"
+
+#include "base/logging.h"
+
+namespace ui {
+
+ResourceImageCache::Shard::Shard()
+    : load_finished(&lock) {
+}
+
+ResourceImageCache::Shard::~Shard() {
+}
+
+ResourceImageCache::ResourceImageCache() {
+}
+
+ResourceImageCache::~ResourceImageCache() {
+}
+
+gfx::Image* ResourceImageCache::Lookup(int resource_id) {
+  Shard& shard = GetShard(resource_id);
+  base::AutoLock lock_scope(shard.lock);
+  ImageMap::iterator found = shard.images.find(resource_id);
+  return found == shard.images.end() ? NULL : &found->second;
+}
+
+bool ResourceImageCache::BeginLoad(int resource_id, gfx::Image** image) {
+  Shard& shard = GetShard(resource_id);
+  base::AutoLock lock_scope(shard.lock);
+  for (;;) {
+    ImageMap::iterator found = shard.images.find(resource_id);
+    if (found != shard.images.end()) {
+      *image = &found->second;
+      return false;
+    }
+    if (!shard.loading.count(resource_id))
+      break;
+    shard.load_finished.Wait();
+  }
+  shard.loading.insert(resource_id);
+  *image = NULL;
+  return true;
+}
+
+gfx::Image& ResourceImageCache::FinishLoad(int resource_id,
+                                           const gfx::Image& image) {
+  Shard& shard = GetShard(resource_id);
+  base::AutoLock lock_scope(shard.lock);
+  DCHECK(shard.loading.count(resource_id));
+  shard.loading.erase(resource_id);
+  shard.load_finished.Broadcast();
+
+  // An Insert() may have raced the load; keep the image callers already have.
+  ImageMap::iterator found = shard.images.find(resource_id);
+  if (found != shard.images.end())
+    return found->second;
+  return shard.images[resource_id] = image;
+}
+
+void ResourceImageCache::AbortLoad(int resource_id) {
+  Shard& shard = GetShard(resource_id);
+  base::AutoLock lock_scope(shard.lock);
+  DCHECK(shard.loading.count(resource_id));
+  shard.loading.erase(resource_id);
+  shard.load_finished.Broadcast();
+}
+
+gfx::Image& ResourceImageCache::Insert(int resource_id,
+                                       const gfx::Image& image) {
+  Shard& shard = GetShard(resource_id);
+  base::AutoLock lock_scope(shard.lock);
+
+  // Another thread raced the load and has already cached the image.
+  ImageMap::iterator found = shard.images.find(resource_id);
+  if (found != shard.images.end())
+    return found->second;
+  return shard.images[resource_id] = image;
+}
+
+void ResourceImageCache::Clear() {
+  for (int i = 0; i < kNumShards; ++i) {
+    base::AutoLock lock_scope(shards_[i].lock);
+    DCHECK(shards_[i].loading.empty());
+    shards_[i].images.clear();
+  }
+}
+
+ResourceImageCache::Shard& ResourceImageCache::GetShard(int resource_id) {
+  // Resource ids are allocated sequentially by GRIT, so the low bits spread
+  // neighbouring resources over different shards.
+  return shards_[static_cast<unsigned>(resource_id) & (kNumShards - 1)];
+}
+
+}  // namespace ui
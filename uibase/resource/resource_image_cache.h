@@ -0,0 +1,88 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef UI_BASE_RESOURCE_RESOURCE_IMAGE_CACHE_H_
+#define UI_BASE_RESOURCE_RESOURCE_IMAGE_CACHE_H_
+
+#include <map>
+#include <set>
+
+#include "base/basictypes.h"
+#include "base/synchronization/condition_variable.h"
+#include "base/synchronization/lock.h"
+#include "uibase/ui_export.h"
+#include "gfx/image/image.h"
+
+namespace ui {
+
+// The image cache behind ResourceBundle. Images are spread over a fixed
+// number of shards by resource id, each guarded by its own lock, so threads
+// looking up different resources rarely contend. Decoding happens outside of
+// any lock, and at most one thread decodes a given resource: other threads
+// asking for the same id wait for that load to finish instead of decoding it
+// again.
+//
+// Cached images are never removed before Clear(), so references returned by
+// this class stay valid until then.
+class UI_EXPORT ResourceImageCache {
+ public:
+  ResourceImageCache();
+  ~ResourceImageCache();
+
+  // Returns the cached image for |resource_id|, or NULL if it isn't loaded.
+  gfx::Image* Lookup(int resource_id);
+
+  // Called before loading |resource_id|. If the image is already cached,
+  // returns false and sets |image| to it. Otherwise returns true and the
+  // caller becomes responsible for loading the image and then calling
+  // FinishLoad() or AbortLoad(). If another thread is loading the same
+  // resource, blocks until that load finishes.
+  bool BeginLoad(int resource_id, gfx::Image** image);
+
+  // Publishes |image| as the loaded image for |resource_id| and wakes up the
+  // threads waiting for it. Returns the cached image.
+  gfx::Image& FinishLoad(int resource_id, const gfx::Image& image);
+
+  // Gives up on loading |resource_id|; a waiting thread will retry the load.
+  void AbortLoad(int resource_id);
+
+  // Caches |image| for |resource_id| unless an image is already cached for
+  // it, and returns the cached image. Unlike FinishLoad() this doesn't need a
+  // matching BeginLoad().
+  gfx::Image& Insert(int resource_id, const gfx::Image& image);
+
+  // Drops every cached image. Must not race with any other call.
+  void Clear();
+
+ private:
+  typedef std::map<int, gfx::Image> ImageMap;
+
+  // Power of two so that the shard is picked with a mask.
+  static const int kNumShards = 16;
+
+  struct Shard {
+    Shard();
+    ~Shard();
+
+    base::Lock lock;
+
+    // Signaled whenever a load in |loading| finishes or is aborted.
+    base::ConditionVariable load_finished;
+
+    ImageMap images;
+
+    // Ids currently being loaded by some thread.
+    std::set<int> loading;
+  };
+
+  Shard& GetShard(int resource_id);
+
+  Shard shards_[kNumShards];
+
+  DISALLOW_COPY_AND_ASSIGN(ResourceImageCache);
+};
+
+}  // namespace ui
+
+#endif  // UI_BASE_RESOURCE_RESOURCE_IMAGE_CACHE_H_
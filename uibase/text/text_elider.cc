@@ -9,6 +9,7 @@
 
 #include "uibase/text/text_elider.h"
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -18,9 +19,13 @@
 #include "base/string_split.h"
 #include "base/string_util.h"
 #include "base/sys_string_conversions.h"
+#include "base/third_party/icu/icu_utf.h"
 #include "base/utf_string_conversions.h"
 #include "googleurl/src/gurl.h"
 #include "gfx/font.h"
+#include "gfx/rect.h"
+#include "gfx/render_text.h"
+#include "gfx/selection_model.h"
 
 
 namespace ui {
@@ -50,29 +55,46 @@ class StringSlicer {
   string16 CutString(size_t length, bool insert_ellipsis) {
     const string16 ellipsis_text = insert_ellipsis ? ellipsis_ : string16();
 
-    if (!elide_in_middle_)
-      return text_.substr(0, FindValidBoundaryBefore(length)) + ellipsis_text;
+    size_t prefix_length = 0;
+    size_t suffix_start = 0;
+    GetCutBoundaries(length, &prefix_length, &suffix_start);
+    return text_.substr(0, prefix_length) + ellipsis_text +
+           text_.substr(suffix_start);
+  }
+
+  // Computes the pieces of |text_| kept by CutString(|length|): the prefix
+  // [0, |prefix_length|) and the suffix [|suffix_start|, text_.length()).
+  // The suffix is empty unless eliding in the middle.
+  void GetCutBoundaries(size_t length,
+                        size_t* prefix_length,
+                        size_t* suffix_start) const {
+    if (!elide_in_middle_) {
+      *prefix_length = FindValidBoundaryBefore(length);
+      *suffix_start = text_.length();
+      return;
+    }
 
     // We put the extra character, if any, before the cut.
     const size_t half_length = length / 2;
-    const size_t prefix_length = FindValidBoundaryBefore(length - half_length);
-    const size_t suffix_start_guess = text_.length() - half_length;
-    const size_t suffix_start = FindValidBoundaryAfter(suffix_start_guess);
-    const size_t suffix_length =
-        half_length - (suffix_start_guess - suffix_start);
-    return text_.substr(0, prefix_length) + ellipsis_text +
-           text_.substr(suffix_start, suffix_length);
+    *prefix_length = FindValidBoundaryBefore(length - half_length);
+    *suffix_start = FindValidBoundaryAfter(text_.length() - half_length);
   }
 
  private:
   // Returns a valid cut boundary at or before |index|.
   size_t FindValidBoundaryBefore(size_t index) const {
-    return 0;
+    DCHECK_LE(index, text_.length());
+    if (index != text_.length() && CBU16_IS_TRAIL(text_[index]))
+      --index;
+    return index;
   }
 
   // Returns a valid cut boundary at or after |index|.
   size_t FindValidBoundaryAfter(size_t index) const {
-      return 0;
+    DCHECK_LE(index, text_.length());
+    if (index != text_.length() && CBU16_IS_TRAIL(text_[index]))
+      ++index;
+    return index;
   }
 
   // The text to be sliced.
@@ -87,6 +109,71 @@ class StringSlicer {
   DISALLOW_COPY_AND_ASSIGN(StringSlicer);
 };
 
+// Returns true if the advance of every character in |text| is independent of
+// its neighbours, so that the width of any substring is the sum of the
+// advances of its characters. This holds for the simple scripts below modulo
+// kerning; scripts that combine, reorder or form contextual ligatures (Arabic,
+// Indic, Thai, combining marks, bidi controls, ...) are excluded.
+bool HasAdditiveAdvances(const string16& text) {
+  for (size_t i = 0; i < text.length(); ++i) {
+    const char16 c = text[i];
+    if (c < 0x0300 ||                     // Latin, Latin-1, Latin Extended.
+        (c >= 0x0370 && c < 0x0483) ||    // Greek, Cyrillic.
+        (c >= 0x2010 && c < 0x2028) ||    // Punctuation, incl. the ellipsis.
+        (c >= 0x2030 && c < 0x205F) ||
+        (c >= 0x3000 && c < 0xA000) ||    // CJK symbols, kana, ideographs.
+        (c >= 0xAC00 && c < 0xD7A4) ||    // Hangul syllables.
+        (c >= 0xFF01 && c < 0xFF61)) {    // Full-width forms.
+      continue;
+    }
+    return false;
+  }
+  return true;
+}
+
+// Shapes a string once and records the horizontal position of every
+// character boundary, so that the width of any prefix or suffix can be read
+// back without reshaping.
+class AdvanceTable {
+ public:
+  AdvanceTable(const string16& text, const gfx::Font& font)
+      : total_width_(0) {
+    scoped_ptr<gfx::RenderText> render_text(
+        gfx::RenderText::CreateInstance());
+    render_text->SetFont(font);
+    render_text->SetText(text);
+    render_text->SetCursorEnabled(false);
+    total_width_ = render_text->GetStringSize().width();
+    // Make the display rect wide enough that the text is never panned.
+    render_text->SetDisplayRect(
+        gfx::Rect(0, 0, std::max(total_width_, 1), font.GetHeight()));
+
+    positions_.resize(text.length() + 1);
+    for (size_t i = 0; i <= text.length(); ++i) {
+      positions_[i] = render_text->GetCursorBounds(
+          gfx::SelectionModel(i, gfx::CURSOR_FORWARD), true).x();
+    }
+  }
+
+  int total_width() const { return total_width_; }
+
+  // Returns the width of the characters in [start, end).
+  int GetWidth(size_t start, size_t end) const {
+    DCHECK_LE(start, end);
+    DCHECK_LT(end, positions_.size());
+    return positions_[end] - positions_[start];
+  }
+
+ private:
+  int total_width_;
+
+  // |positions_[i]| is the x coordinate of the left edge of character |i|;
+  // the last entry is the right edge of the text.
+  std::vector<int> positions_;
+
+  DISALLOW_COPY_AND_ASSIGN(AdvanceTable);
+};
+
 // Build a path from the first |num_components| elements in |path_elements|.
 // Prepends |path_prefix|, appends |filename|, inserts ellipsis if appropriate.
 string16 BuildPathFromComponents(const string16& path_prefix,
@@ -304,6 +391,62 @@ string16 ElideText(const string16& text,
   return slicer.CutString(guess, insert_ellipsis);
 }
 
+string16 ElideTextWithAdvances(const string16& text,
+                               const gfx::Font& font,
+                               int available_pixel_width,
+                               ElideBehavior elide_behavior) {
+  if (text.empty())
+    return text;
+
+  if (!HasAdditiveAdvances(text) ||
+      base::i18n::StringContainsStrongRTLChars(text)) {
+    return ElideText(text, font, available_pixel_width, elide_behavior);
+  }
+
+  const AdvanceTable advances(text, font);
+  // See ElideText() regarding Pango width overflow on absurdly long strings.
+  if (advances.total_width() <= 0)
+    return ElideText(text, font, available_pixel_width, elide_behavior);
+
+  if (advances.total_width() <= available_pixel_width)
+    return text;
+
+  const string16 kEllipsisUTF16 = UTF8ToUTF16(kEllipsis);
+  const bool elide_in_middle = (elide_behavior == ELIDE_IN_MIDDLE);
+  const bool insert_ellipsis = (elide_behavior != TRUNCATE_AT_END);
+  const int ellipsis_width = font.GetStringWidth(kEllipsisUTF16);
+  if (ellipsis_width > available_pixel_width)
+    return string16();
+
+  StringSlicer slicer(text, kEllipsisUTF16, elide_in_middle);
+
+  // Same search as ElideText(), but each probe is a table lookup instead of a
+  // full measurement.
+  size_t lo = 0;
+  size_t hi = text.length() - 1;
+  size_t guess;
+  for (guess = (lo + hi) / 2; lo <= hi; guess = (lo + hi) / 2) {
+    size_t prefix_length = 0;
+    size_t suffix_start = 0;
+    slicer.GetCutBoundaries(guess, &prefix_length, &suffix_start);
+    int guess_length = advances.GetWidth(0, prefix_length) +
+        advances.GetWidth(suffix_start, text.length());
+    if (insert_ellipsis)
+      guess_length += ellipsis_width;
+    if (guess_length > available_pixel_width)
+      hi = guess - 1;
+    else
+      lo = guess + 1;
+  }
+
+  // Kerning across the cut can still make the result slightly wider than
+  // the sum of its pieces; measure the result once to be exact.
+  const string16 result = slicer.CutString(guess, insert_ellipsis);
+  if (font.GetStringWidth(result) > available_pixel_width)
+    return ElideText(text, font, available_pixel_width, elide_behavior);
+  return result;
+}
+
 bool ElideString(const string16& input, int max_len, string16* output) {
   DCHECK_GE(max_len, 0);
   if (static_cast<int>(input.length()) <= max_len) {
@@ -52,6 +52,16 @@ UI_EXPORT string16 ElideText(const string16& text,
                              int available_pixel_width,
                              ElideBehavior elide_behavior);
 
+// Same as ElideText(), but shapes |text| only once and finds the cut point
+// from the cumulative advances of its characters instead of re-measuring
+// every candidate. Text whose advances are not additive (complex scripts,
+// RTL) goes through ElideText(). Prefer this when eliding many strings, e.g.
+// table cells.
+UI_EXPORT string16 ElideTextWithAdvances(const string16& text,
+                                         const gfx::Font& font,
+                                         int available_pixel_width,
+                                         ElideBehavior elide_behavior);
+
 // Elide a filename to fit a given pixel width, with an emphasis on not hiding
 // the extension unless we have to. If filename contains a path, the path will
 // be removed if filename doesn't fit into available_pixel_width. The elided
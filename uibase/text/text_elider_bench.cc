@@ -0,0 +1,134 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// This small program compares the cost of ui::ElideText(), which measures
+// every candidate cut with the font, against ui::ElideTextWithAdvances(),
+// which shapes the text once and searches a table of character advances.
+// It elides a set of generated strings of the given length to the given
+// width, repeated for the given number of iterations, and prints the average
+// time per elision for both paths. The text size cache is disabled unless
+// -cache is passed, so that every measurement actually shapes the text.
+
+#include <stdio.h>
+
+#include <vector>
+
+#include "base/at_exit.h"
+#include "base/basictypes.h"
+#include "base/command_line.h"
+#include "base/format_macros.h"
+#include "base/string_number_conversions.h"
+#include "base/string16.h"
+#include "base/time.h"
+#include "base/utf_string_conversions.h"
+#include "uibase/text/text_elider.h"
+#include "gfx/font.h"
+#include "gfx/text_size_cache.h"
+
+namespace {
+
+const int kDefaultIterations = 100;
+const int kDefaultStrings = 200;
+const int kDefaultLength = 80;
+const int kDefaultWidth = 150;
+
+typedef string16 (*ElideFunction)(const string16&,
+                                  const gfx::Font&,
+                                  int,
+                                  ui::ElideBehavior);
+
+// Builds |count| distinct strings of |length| characters that look like
+// table cell contents.
+std::vector<string16> BuildStrings(int count, int length) {
+  const char kAlphabet[] = "abcdefghijklmnopqrstuvwxyz ABCDEFGHIJ0123456789.";
+  std::vector<string16> strings;
+  for (int i = 0; i < count; ++i) {
+    std::string text = base::IntToString(i) + " ";
+    for (int j = static_cast<int>(text.length()); j < length; ++j)
+      text += kAlphabet[(i * 7 + j * 13) % (arraysize(kAlphabet) - 1)];
+    strings.push_back(ASCIIToUTF16(text));
+  }
+  return strings;
+}
+
+// Returns the average time in microseconds of one elision with |function|.
+double TimeElide(ElideFunction function,
+                 const std::vector<string16>& strings,
+                 const gfx::Font& font,
+                 int width,
+                 ui::ElideBehavior behavior,
+                 int iterations) {
+  const base::TimeTicks start = base::TimeTicks::Now();
+  size_t total_length = 0;
+  for (int i = 0; i < iterations; ++i) {
+    for (size_t j = 0; j < strings.size(); ++j)
+      total_length += function(strings[j], font, width, behavior).length();
+  }
+  const int64 elapsed_us = (base::TimeTicks::Now() - start).InMicroseconds();
+  // Keep the results alive so the calls can't be optimized away.
+  if (total_length == 0)
+    printf("(all strings elided to nothing)\n");
+  return static_cast<double>(elapsed_us) / (iterations * strings.size());
+}
+
+void Usage() {
+  printf("text_elider_bench [-iterations i] [-strings n] [-length l] "
+         "[-width w] [-middle] [-cache] [-help]\n"
+         "  -iterations i: elide every string i times (default:%d)\n"
+         "  -strings n: number of distinct strings (default:%d)\n"
+         "  -length l: length of each string in characters (default:%d)\n"
+         "  -width w: available width in pixels (default:%d)\n"
+         "  -middle: elide in the middle instead of at the end\n"
+         "  -cache: keep the text size cache enabled\n"
+         "  -help: prints this help and exits\n",
+         kDefaultIterations, kDefaultStrings, kDefaultLength, kDefaultWidth);
+}
+
+bool GetIntSwitch(const CommandLine* command_line,
+                  const char* name,
+                  int* value) {
+  if (!command_line->HasSwitch(name))
+    return true;
+  return base::StringToInt(command_line->GetSwitchValueASCII(name), value) &&
+         *value > 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  base::AtExitManager exit_manager;
+  CommandLine::Init(argc, argv);
+  const CommandLine* command_line = CommandLine::ForCurrentProcess();
+
+  int iterations = kDefaultIterations;
+  int num_strings = kDefaultStrings;
+  int length = kDefaultLength;
+  int width = kDefaultWidth;
+  if (command_line->HasSwitch("help") ||
+      !GetIntSwitch(command_line, "iterations", &iterations) ||
+      !GetIntSwitch(command_line, "strings", &num_strings) ||
+      !GetIntSwitch(command_line, "length", &length) ||
+      !GetIntSwitch(command_line, "width", &width)) {
+    Usage();
+    return 1;
+  }
+  const ui::ElideBehavior behavior = command_line->HasSwitch("middle") ?
+      ui::ELIDE_IN_MIDDLE : ui::ELIDE_AT_END;
+  gfx::TextSizeCache::GetInstance()->set_enabled(
+      command_line->HasSwitch("cache"));
+
+  const gfx::Font font;
+  const std::vector<string16> strings = BuildStrings(num_strings, length);
+
+  const double exact_us = TimeElide(&ui::ElideText, strings, font, width,
+                                    behavior, iterations);
+  const double advances_us = TimeElide(&ui::ElideTextWithAdvances, strings,
+                                       font, width, behavior, iterations);
+
+  printf("ElideText:             %.2f us/elision\n", exact_us);
+  printf("ElideTextWithAdvances: %.2f us/elision\n", advances_us);
+  if (advances_us > 0)
+    printf("speedup: %.2fx\n", exact_us / advances_us);
+  return 0;
+}
@@ -50,6 +50,10 @@ const char kOldCheckboxStyle[] = "old-checkbox-style";
 // do not have a user interface.
 const char kNoMessageBox[] = "no-message-box";
 
+// Asks the OS to read ahead the hot range of resource packs written in
+// access order (see ui::DataPack::WritePack()) as soon as they are loaded.
+const char kPrefetchHotResources[] = "prefetch-hot-resources";
+
 // Enable support for touch events.
 const char kTouchEvents[] = "touch-events";
 
@@ -24,6 +24,7 @@ UI_EXPORT extern const char kLang[];
 UI_EXPORT extern const char kLocalePak[];
 UI_EXPORT extern const char kOldCheckboxStyle[];
 UI_EXPORT extern const char kNoMessageBox[];
+UI_EXPORT extern const char kPrefetchHotResources[];
 UI_EXPORT extern const char kTouchEvents[];
 UI_EXPORT extern const char kTouchEventsAuto[];
 UI_EXPORT extern const char kTouchEventsDisabled[];
@@ -4,6 +4,7 @@
 
 #include "views/controls/table/table_view_views.h"
 
+#include <algorithm>
 #include <map>
 
 #include "base/i18n/rtl.h"
@@ -59,12 +60,15 @@ void GetModelIndexToRangeStart(TableGrouper* grouper,
 
 } // namespace
 
-// Used as the comparator to sort the contents of the table.
+// Used as the comparator to sort the contents of the table. Rows that compare
+// equal keep their model order, so the order doesn't depend on how the rows
+// were sorted and a merge of re-sorted rows matches a full sort.
 struct TableView::SortHelper {
   explicit SortHelper(TableView* table) : table(table) {}
 
   bool operator()(int model_index1, int model_index2) {
-    return table->CompareRows( model_index1, model_index2) < 0;
+    const int result = table->CompareRows(model_index1, model_index2);
+    return result == 0 ? model_index1 < model_index2 : result < 0;
   }
 
   TableView* table;
@@ -144,6 +148,7 @@ void TableView::SetModel(ui::TableModel* model) {
     model_->SetObserver(NULL);
   model_ = model;
   selection_model_.Clear();
+  sort_keys_.clear();
   if (model_)
     model_->SetObserver(this);
 }
@@ -346,16 +351,54 @@ bool TableView::OnMouseDragged(const ui::MouseEvent& event) {
 
 void TableView::OnModelChanged() {
   selection_model_.Clear();
+  sort_keys_.clear();
+  SortItemsAndUpdateMapping();
   NumRowsChanged();
 }
 
 void TableView::OnItemsChanged(int start, int length) {
-  SortItemsAndUpdateMapping();
+  UpdateSortKeysForRows(start, length);
+  if (!CanUpdateMappingIncrementally(RowCount())) {
+    SortItemsAndUpdateMapping();
+    return;
+  }
+
+  // Pull the changed rows out of the mapping. The remaining rows are still
+  // sorted, so only the changed rows need to be sorted and merged back in.
+  int first_view_index = static_cast<int>(view_to_model_.size());
+  size_t kept = 0;
+  for (size_t i = 0; i < view_to_model_.size(); ++i) {
+    const int model_index = view_to_model_[i];
+    if (model_index >= start && model_index < start + length) {
+      first_view_index = std::min(first_view_index, static_cast<int>(i));
+      continue;
+    }
+    view_to_model_[kept++] = model_index;
+  }
+  view_to_model_.resize(kept);
+  MergeRowsIntoMapping(start, length, first_view_index);
+  SchedulePaint();
 }
 
 void TableView::OnItemsAdded(int start, int length) {
   for (int i = 0; i < length; ++i)
     selection_model_.IncrementFrom(start);
+
+  for (SortKeys::iterator i = sort_keys_.begin(); i != sort_keys_.end(); ++i)
+    i->second.insert(i->second.begin() + start, length, std::string());
+  UpdateSortKeysForRows(start, length);
+
+  if (CanUpdateMappingIncrementally(RowCount() - length)) {
+    for (size_t i = 0; i < view_to_model_.size(); ++i) {
+      if (view_to_model_[i] >= start)
+        view_to_model_[i] += length;
+    }
+    model_to_view_.insert(model_to_view_.begin() + start, length, 0);
+    MergeRowsIntoMapping(start, length,
+                         static_cast<int>(view_to_model_.size()));
+  } else {
+    SortItemsAndUpdateMapping();
+  }
   NumRowsChanged();
 }
 
@@ -370,6 +413,32 @@ void TableView::OnItemsRemoved(int start, int length) {
         model_to_view_[previously_selected_model_index];
   for (int i = 0; i < length; ++i)
     selection_model_.DecrementFrom(start);
+
+  for (SortKeys::iterator i = sort_keys_.begin(); i != sort_keys_.end(); ++i) {
+    i->second.erase(i->second.begin() + start,
+                    i->second.begin() + start + length);
+  }
+
+  if (CanUpdateMappingIncrementally(RowCount() + length)) {
+    // Removing rows doesn't change the order of the remaining rows.
+    int first_view_index = RowCount();
+    size_t kept = 0;
+    for (size_t i = 0; i < view_to_model_.size(); ++i) {
+      const int model_index = view_to_model_[i];
+      if (model_index >= start && model_index < start + length) {
+        first_view_index = std::min(first_view_index, static_cast<int>(i));
+        continue;
+      }
+      view_to_model_[kept++] =
+          model_index < start ? model_index : model_index - length;
+    }
+    view_to_model_.resize(kept);
+    model_to_view_.erase(model_to_view_.begin() + start,
+                         model_to_view_.begin() + start + length);
+    UpdateModelToView(first_view_index);
+  } else {
+    SortItemsAndUpdateMapping();
+  }
   NumRowsChanged();
   // If the selection was empty and is no longer empty select the same visual
   // index.
@@ -461,7 +530,6 @@ void TableView::OnBlur() {
 }
 
 void TableView::NumRowsChanged() {
-  SortItemsAndUpdateMapping();
   PreferredSizeChanged();
   SchedulePaint();
 }
@@ -472,6 +540,7 @@ void TableView::SetSortDescriptors(const SortDescriptors& sort_descriptors) {
 }
 
 void TableView::SortItemsAndUpdateMapping() {
+  UpdateSortKeys();
   if (!is_sorted()) {
     view_to_model_.clear();
     model_to_view_.clear();
@@ -496,14 +565,92 @@ void TableView::SortItemsAndUpdateMapping() {
   SchedulePaint();
 }
 
+bool TableView::CanUpdateMappingIncrementally(int old_row_count) const {
+  // With a grouper the position of a row depends on the first row of its
+  // group, which any change may move, so grouped tables are always re-sorted.
+  return is_sorted() && !grouper_ &&
+      static_cast<int>(view_to_model_.size()) == old_row_count;
+}
+
+void TableView::MergeRowsIntoMapping(int start, int length,
+                                     int first_view_index) {
+  if (length <= 0) {
+    UpdateModelToView(first_view_index);
+    return;
+  }
+
+  SortHelper sort_helper(this);
+  std::vector<int> rows(length);
+  for (int i = 0; i < length; ++i)
+    rows[i] = start + i;
+  std::sort(rows.begin(), rows.end(), sort_helper);
+
+  // Rows before the insertion point of the first merged row keep their view
+  // index.
+  const size_t old_size = view_to_model_.size();
+  const int insert_index = static_cast<int>(
+      std::lower_bound(view_to_model_.begin(), view_to_model_.end(), rows[0],
+                       sort_helper) - view_to_model_.begin());
+  view_to_model_.insert(view_to_model_.end(), rows.begin(), rows.end());
+  std::inplace_merge(view_to_model_.begin(), view_to_model_.begin() + old_size,
+                     view_to_model_.end(), sort_helper);
+  UpdateModelToView(std::min(first_view_index, insert_index));
+}
+
+void TableView::UpdateModelToView(int first_view_index) {
+  const int row_count = static_cast<int>(view_to_model_.size());
+  model_to_view_.resize(row_count);
+  for (int i = first_view_index; i < row_count; ++i)
+    model_to_view_[view_to_model_[i]] = i;
+}
+
+void TableView::UpdateSortKeys() {
+  if (!model_ || !is_sorted() || !model_->HasSortKeys()) {
+    sort_keys_.clear();
+    return;
+  }
+
+  // Drop the keys of columns that are no longer sorted, but keep the others
+  // so that toggling the sort order doesn't recompute them.
+  SortKeys sort_keys;
+  const int row_count = RowCount();
+  for (size_t i = 0; i < sort_descriptors_.size(); ++i) {
+    const int column_id = sort_descriptors_[i].column_id;
+    std::vector<std::string>& keys = sort_keys[column_id];
+    SortKeys::iterator cached = sort_keys_.find(column_id);
+    if (cached != sort_keys_.end() &&
+        static_cast<int>(cached->second.size()) == row_count) {
+      keys.swap(cached->second);
+      continue;
+    }
+    keys.resize(row_count);
+    for (int row = 0; row < row_count; ++row)
+      keys[row] = model_->GetSortKey(row, column_id);
+  }
+  sort_keys_.swap(sort_keys);
+}
+
+void TableView::UpdateSortKeysForRows(int start, int length) {
+  for (SortKeys::iterator i = sort_keys_.begin(); i != sort_keys_.end(); ++i) {
+    for (int row = start; row < start + length; ++row)
+      i->second[row] = model_->GetSortKey(row, i->first);
+  }
+}
+
+int TableView::CompareValues(int model_row1, int model_row2, int column_id) {
+  SortKeys::const_iterator keys = sort_keys_.find(column_id);
+  if (keys == sort_keys_.end())
+    return model_->CompareValues(model_row1, model_row2, column_id);
+  return keys->second[model_row1].compare(keys->second[model_row2]);
+}
+
 int TableView::CompareRows(int model_row1, int model_row2) {
-  const int sort_result = model_->CompareValues(
+  const int sort_result = CompareValues(
       model_row1, model_row2, sort_descriptors_[0].column_id);
   if (sort_result == 0 && sort_descriptors_.size() > 1) {
     // Try the secondary sort.
     return SwapCompareResult(
-        model_->CompareValues(model_row1, model_row2,
-                              sort_descriptors_[1].column_id),
+        CompareValues(model_row1, model_row2, sort_descriptors_[1].column_id),
         sort_descriptors_[1].ascending);
   }
   return SwapCompareResult(sort_result, sort_descriptors_[0].ascending);
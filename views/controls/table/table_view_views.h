@@ -5,6 +5,8 @@
 #ifndef UI_VIEWS_CONTROLS_TABLE_TABLE_VIEW_VIEWS_H_
 #define UI_VIEWS_CONTROLS_TABLE_TABLE_VIEW_VIEWS_H_
 
+#include <map>
+#include <string>
 #include <vector>
 
 #include "base/memory/scoped_ptr.h"
@@ -29,7 +31,10 @@
 // convert to view coordinates use ModelToView().
 //
 // Sorting is done by a locale sensitive string sort. You can customize the
-// sort by way of overriding TableModel::CompareValues().
+// sort by way of overriding TableModel::CompareValues(). Models that also
+// provide sort keys (TableModel::HasSortKeys()) have the keys of the sorted
+// columns cached per row, and changes to the model only re-sort the rows that
+// changed.
 namespace views {
 
 struct GroupRange;
@@ -224,6 +229,31 @@ class VIEWS_EXPORT TableView
   // |model_to_view_|) appropriately.
   void SortItemsAndUpdateMapping();
 
+  // Returns true if the mappings can be patched for a change to the model
+  // rather than rebuilt by SortItemsAndUpdateMapping(). |old_row_count| is the
+  // number of rows before the change.
+  bool CanUpdateMappingIncrementally(int old_row_count) const;
+
+  // Merges the model rows [start, start + length), which must not be in
+  // |view_to_model_|, into the sorted |view_to_model_| and patches
+  // |model_to_view_| from the first view index that moved. |first_view_index|
+  // is the first view index already known to have changed.
+  void MergeRowsIntoMapping(int start, int length, int first_view_index);
+
+  // Recomputes |model_to_view_| for the view indices >= |first_view_index|.
+  void UpdateModelToView(int first_view_index);
+
+  // Makes |sort_keys_| hold the keys of the columns in |sort_descriptors_|,
+  // computing the keys of columns that aren't cached yet.
+  void UpdateSortKeys();
+
+  // Recomputes the cached sort keys of the model rows [start, start + length).
+  void UpdateSortKeysForRows(int start, int length);
+
+  // Compares the values of |column_id| of the two rows, using the cached sort
+  // keys if available.
+  int CompareValues(int model_row1, int model_row2, int column_id);
+
   // Used to sort the two rows. Returns a value < 0, == 0 or > 0 indicating
   // whether the row2 comes before row1, row2 is the same as row1 or row1 comes
   // after row2. This invokes CompareValues on the model with the sorted column.
@@ -309,6 +339,11 @@ class VIEWS_EXPORT TableView
   std::vector<int> view_to_model_;
   std::vector<int> model_to_view_;
 
+  // Sort keys of every model row, by column id. Only holds the columns in
+  // |sort_descriptors_|, and is empty if the model has no sort keys.
+  typedef std::map<int, std::vector<std::string> > SortKeys;
+  SortKeys sort_keys_;
+
   scoped_ptr<TableViewRowBackgroundPainter> row_background_painter_;
 
   TableGrouper* grouper_;
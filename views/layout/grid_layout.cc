@@ -682,10 +682,12 @@ GridLayout* GridLayout::CreatePanel(View* host) {
 
 void GridLayout::SetInsets(int top, int left, int bottom, int right) {
   insets_.Set(top, left, bottom, right);
+  host_->InvalidateLayout();
 }
 
 void GridLayout::SetInsets(const gfx::Insets& insets) {
   insets_ = insets;
+  host_->InvalidateLayout();
 }
 
 ColumnSet* GridLayout::AddColumnSet(int id) {
@@ -995,6 +997,8 @@ void GridLayout::AddRow(Row* row) {
   rows_.push_back(row);
   current_row_col_set_ = row->column_set();
   SkipPaddingColumns();
+  // A row changes the preferred size the host may have cached.
+  host_->InvalidateLayout();
 }
 
 void GridLayout::UpdateRemainingHeightFromRows(ViewState* view_state) {
@@ -182,7 +182,10 @@ class VIEWS_EXPORT GridLayout : public LayoutManager {
 
   virtual int GetPreferredHeightForWidth(View* host, int width) OVERRIDE;
 
-  void set_minimum_size(const gfx::Size& size) { minimum_size_ = size; }
+  void set_minimum_size(const gfx::Size& size) {
+    minimum_size_ = size;
+    host_->InvalidateLayout();
+  }
 
  private:
   // As both Layout and GetPreferredSize need to do nearly the same thing,
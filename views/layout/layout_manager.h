@@ -41,7 +41,10 @@ class VIEWS_EXPORT LayoutManager {
   virtual void Layout(View* host) = 0;
 
   // Return the preferred size which is the size required to give each
-  // children their respective preferred size.
+  // children their respective preferred size. The host caches the result, and
+  // that of GetPreferredHeightForWidth(), until its layout is invalidated, so
+  // a LayoutManager whose parameters change after it is installed must call
+  // InvalidateLayout() on the host.
   virtual gfx::Size GetPreferredSize(View* host) = 0;
 
   // Returns the preferred height for the specified width. The default
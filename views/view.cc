@@ -11,11 +11,13 @@
 
 #include "base/command_line.h"
 #include "base/debug/trace_event.h"
+#include "base/lazy_instance.h"
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/message_loop.h"
 #include "base/stringprintf.h"
 #include "base/utf_string_conversions.h"
+#include "third_party/skia/include/core/SkPicture.h"
 #include "third_party/skia/include/core/SkRect.h"
 #include "uibase/accessibility/accessibility_types.h"
 #include "uibase/dragdrop/drag_drop_types.h"
@@ -36,6 +38,7 @@
 #include "views/context_menu_controller.h"
 #include "views/drag_controller.h"
 #include "views/layout/layout_manager.h"
+#include "views/view_hit_test_index.h"
 #include "views/views_delegate.h"
 #include "views/widget/native_widget_private.h"
 #include "views/widget/root_view.h"
@@ -88,6 +91,10 @@ const views::View* GetHierarchyRoot(const views::View* view) {
   return root;
 }
 
+// Layout work done by all views. See View::GetLayoutCounters().
+base::LazyInstance<views::View::LayoutCounters> layout_counters =
+    LAZY_INSTANCE_INITIALIZER;
+
 }  // namespace
 
 namespace views {
@@ -114,7 +121,11 @@ View::View()
       registered_for_visible_bounds_notification_(false),
       clip_insets_(0, 0, 0, 0),
       needs_layout_(true),
+      preferred_size_valid_(false),
+      next_height_for_width_(0),
       focus_border_(FocusBorder::CreateDashedFocusBorder()),
+      retain_paint_(false),
+      retained_paint_scale_factor_(ui::SCALE_FACTOR_NONE),
       flip_canvas_on_paint_for_rtl_ui_(false),
       paint_to_layer_(false),
       accelerator_registration_delayed_(false),
@@ -127,6 +138,7 @@ View::View()
       context_menu_controller_(NULL),
       drag_controller_(NULL),
       in_on_focus_(false) {
+  ClearPreferredSizeCache();
 }
 
 View::~View() {
@@ -179,6 +191,12 @@ void View::AddChildViewAt(View* view, int index) {
   // Let's insert the view.
   view->parent_ = this;
   children_.insert(children_.begin() + index, view);
+  if (child_hit_test_index_.get())
+    child_hit_test_index_->ChildAdded(view);
+
+  // The new child may change the preferred size of this view and of its
+  // ancestors; clear their caches once before notifying the subtree.
+  InvalidatePreferredSizeCaches();
 
   for (View* v = this; v; v = v->parent_)
     v->ViewHierarchyChangedImpl(false, true, this, view);
@@ -230,6 +248,8 @@ void View::ReorderChildView(View* view, int index) {
   // Add it in the specified index now.
   InitFocusSiblings(view, index);
   children_.insert(children_.begin() + index, view);
+  if (child_hit_test_index_.get())
+    child_hit_test_index_->ChildrenReordered();
 
   if (use_acceleration_when_possible)
     ReorderLayers();
@@ -364,9 +384,16 @@ gfx::Rect View::GetBoundsInScreen() const {
 }
 
 gfx::Size View::GetPreferredSize() {
-  if (layout_manager_.get())
-    return layout_manager_->GetPreferredSize(this);
-  return gfx::Size();
+  if (!layout_manager_.get())
+    return gfx::Size();
+  if (preferred_size_valid_) {
+    ++layout_counters.Get().cache_hits;
+    return preferred_size_;
+  }
+  ++layout_counters.Get().measures;
+  preferred_size_ = layout_manager_->GetPreferredSize(this);
+  preferred_size_valid_ = true;
+  return preferred_size_;
 }
 
 int View::GetBaseline() const {
@@ -388,9 +415,24 @@ gfx::Size View::GetMaximumSize() {
 }
 
 int View::GetHeightForWidth(int w) {
-  if (layout_manager_.get())
-    return layout_manager_->GetPreferredHeightForWidth(this, w);
-  return GetPreferredSize().height();
+  if (!layout_manager_.get())
+    return GetPreferredSize().height();
+  for (size_t i = 0; i < kHeightForWidthCacheSize; ++i) {
+    if (heights_for_width_[i].width == w) {
+      ++layout_counters.Get().cache_hits;
+      return heights_for_width_[i].height;
+    }
+  }
+  ++layout_counters.Get().measures;
+  const int height = layout_manager_->GetPreferredHeightForWidth(this, w);
+  // Layouts usually ask for one or two widths, such as the current width and
+  // the width available with a scroll bar, so replace the oldest entry.
+  HeightForWidth& entry = heights_for_width_[next_height_for_width_];
+  entry.width = w;
+  entry.height = height;
+  next_height_for_width_ = (next_height_for_width_ + 1) %
+      kHeightForWidthCacheSize;
+  return height;
 }
 
 void View::SetVisible(bool visible) {
@@ -401,6 +443,10 @@ void View::SetVisible(bool visible) {
       SchedulePaint();
 
     visible_ = visible;
+    UpdateHitTestIndexInParent();
+    // Layout managers skip hidden children.
+    if (parent_)
+      parent_->InvalidatePreferredSizeCaches();
 
     // Notify the parent.
     if (parent_)
@@ -453,6 +499,7 @@ void View::SetTransform(const gfx::Transform& transform) {
     layer()->SetTransform(transform);
     layer()->ScheduleDraw();
   }
+  UpdateHitTestIndexInParent();
 }
 
 void View::SetPaintToLayer(bool paint_to_layer) {
@@ -507,6 +554,7 @@ int View::GetMirroredXWithWidthInView(int x, int w) const {
 
 void View::Layout() {
   needs_layout_ = false;
+  ++layout_counters.Get().layouts;
 
   // If we have a layout manager, let it handle the layout for us.
   if (layout_manager_.get())
@@ -531,6 +579,7 @@ void View::InvalidateLayout() {
   // Always invalidate up. This is needed to handle the case of us already being
   // valid, but not our parent.
   needs_layout_ = true;
+  ClearPreferredSizeCache();
   if (parent_)
     parent_->InvalidateLayout();
 }
@@ -546,6 +595,23 @@ void View::SetLayoutManager(LayoutManager* layout_manager) {
   layout_manager_.reset(layout_manager);
   if (layout_manager_.get())
     layout_manager_->Installed(this);
+  InvalidatePreferredSizeCaches();
+}
+
+View::LayoutCounters::LayoutCounters()
+    : layouts(0),
+      measures(0),
+      cache_hits(0) {
+}
+
+// static
+const View::LayoutCounters& View::GetLayoutCounters() {
+  return layout_counters.Get();
+}
+
+// static
+void View::ResetLayoutCounters() {
+  layout_counters.Get() = LayoutCounters();
 }
 
 // Attributes ------------------------------------------------------------------
@@ -697,6 +763,9 @@ void View::SchedulePaint() {
 }
 
 void View::SchedulePaintInRect(const gfx::Rect& rect) {
+  // Whatever changed may change what OnPaint() draws, even while hidden.
+  retained_paint_.clear();
+
   if (!visible_)
     return;
 
@@ -705,8 +774,27 @@ void View::SchedulePaintInRect(const gfx::Rect& rect) {
   } else if (parent_) {
     // Translate the requested paint rect to the parent's coordinate system
     // then pass this notification up to the parent.
-    parent_->SchedulePaintInRect(ConvertRectToParent(rect));
+    parent_->SchedulePaintInRectForChild(ConvertRectToParent(rect));
+  }
+}
+
+void View::SchedulePaintInRectForChild(const gfx::Rect& rect) {
+  // The root goes through SchedulePaintInRect(), which RootView overrides to
+  // invalidate the widget.
+  if (!parent_) {
+    SchedulePaintInRect(rect);
+    return;
   }
+
+  // Unlike SchedulePaintInRect(), keep |retained_paint_|: a child repainting
+  // doesn't change what this view's OnPaint() draws.
+  if (!visible_)
+    return;
+
+  if (layer())
+    layer()->SchedulePaint(rect);
+  else
+    parent_->SchedulePaintInRectForChild(ConvertRectToParent(rect));
 }
 
 void View::Paint(gfx::Canvas* canvas) {
@@ -736,6 +824,11 @@ void View::Paint(gfx::Canvas* canvas) {
   PaintCommon(canvas);
 }
 
+void View::SetRetainPaint(bool retain_paint) {
+  retain_paint_ = retain_paint;
+  retained_paint_.clear();
+}
+
 ui::ThemeProvider* View::GetThemeProvider() const {
   const Widget* widget = GetWidget();
   return widget ? widget->GetThemeProvider() : NULL;
@@ -763,19 +856,31 @@ bool View::get_use_acceleration_when_possible() {
 View* View::GetEventHandlerForPoint(const gfx::Point& point) {
   // Walk the child Views recursively looking for the View that most
   // tightly encloses the specified point.
-  for (int i = child_count() - 1; i >= 0; --i) {
-    View* child = child_at(i);
-    if (!child->visible())
-      continue;
+  if (child_hit_test_index_.get()) {
+    Views children;
+    child_hit_test_index_->GetChildrenAt(point, &children);
+    for (size_t i = 0; i < children.size(); ++i) {
+      View* handler = GetEventHandlerForPointInChild(children[i], point);
+      if (handler)
+        return handler;
+    }
+    return this;
+  }
 
-    gfx::Point point_in_child_coords(point);
-    ConvertPointToTarget(this, child, &point_in_child_coords);
-    if (child->HitTestPoint(point_in_child_coords))
-      return child->GetEventHandlerForPoint(point_in_child_coords);
+  for (int i = child_count() - 1; i >= 0; --i) {
+    View* handler = GetEventHandlerForPointInChild(child_at(i), point);
+    if (handler)
+      return handler;
   }
   return this;
 }
 
+void View::SetUseChildHitTestIndex(bool use) {
+  if (use == !!child_hit_test_index_.get())
+    return;
+  child_hit_test_index_.reset(use ? new ViewHitTestIndex(this) : NULL);
+}
+
 gfx::NativeCursor View::GetCursor(const ui::MouseEvent& event) {
 #if defined(OS_WIN)
 #if defined(USE_AURA)
@@ -1140,9 +1245,25 @@ void View::NativeViewHierarchyChanged(bool attached,
 
 void View::PaintChildren(gfx::Canvas* canvas) {
   TRACE_EVENT0("views", "View::PaintChildren");
+  // Paint() clips to the child's bounds and gives up when the clip is empty.
+  // Skip the children outside the clip up front instead, so they don't cost
+  // a canvas save and restore each.
+  gfx::Rect clip_bounds;
+  if (!canvas->GetClipBounds(&clip_bounds))
+    return;
+
+  if (child_hit_test_index_.get()) {
+    Views children;
+    child_hit_test_index_->GetChildrenInRect(clip_bounds, &children);
+    for (Views::reverse_iterator i = children.rbegin(); i != children.rend();
+         ++i) {
+      PaintChildIfInClip(*i, canvas, clip_bounds);
+    }
+    return;
+  }
+
   for (int i = 0, count = child_count(); i < count; ++i)
-    if (!child_at(i)->layer())
-      child_at(i)->Paint(canvas);
+    PaintChildIfInClip(child_at(i), canvas, clip_bounds);
 }
 
 void View::OnPaint(gfx::Canvas* canvas) {
@@ -1544,12 +1665,44 @@ void View::PaintCommon(gfx::Canvas* canvas) {
       canvas->Scale(-1, 1);
     }
 
-    OnPaint(canvas);
+    if (retain_paint_)
+      PaintRetained(canvas);
+    else
+      OnPaint(canvas);
   }
 
   PaintChildren(canvas);
 }
 
+void View::InvalidatePreferredSizeCaches() {
+  for (View* view = this; view; view = view->parent_)
+    view->ClearPreferredSizeCache();
+}
+
+void View::ClearPreferredSizeCache() {
+  preferred_size_valid_ = false;
+  for (size_t i = 0; i < kHeightForWidthCacheSize; ++i)
+    heights_for_width_[i].width = -1;
+}
+
+void View::PaintRetained(gfx::Canvas* canvas) {
+  if (!retained_paint_ ||
+      retained_paint_->width() != width() ||
+      retained_paint_->height() != height() ||
+      retained_paint_scale_factor_ != canvas->scale_factor()) {
+    TRACE_EVENT0("views", "View::PaintRetained record");
+    retained_paint_ = skia::AdoptRef(new SkPicture);
+    scoped_ptr<gfx::Canvas> recording_canvas(
+        gfx::Canvas::CreateCanvasWithoutScaling(
+            retained_paint_->beginRecording(width(), height()),
+            canvas->scale_factor()));
+    OnPaint(recording_canvas.get());
+    retained_paint_->endRecording();
+    retained_paint_scale_factor_ = canvas->scale_factor();
+  }
+  canvas->sk_canvas()->drawPicture(*retained_paint_);
+}
+
 // Tree operations -------------------------------------------------------------
 
 void View::DoRemoveChildView(View* view,
@@ -1572,6 +1725,7 @@ void View::DoRemoveChildView(View* view,
 
     if (GetWidget())
       UnregisterChildrenForVisibleBoundsNotification(view);
+    InvalidatePreferredSizeCaches();
     view->PropagateRemoveNotifications(this);
     view->parent_ = NULL;
     view->UpdateLayerVisibility();
@@ -1580,6 +1734,8 @@ void View::DoRemoveChildView(View* view,
       view_to_be_deleted.reset(view);
 
     children_.erase(i);
+    if (child_hit_test_index_.get())
+      child_hit_test_index_->ChildRemoved(view);
   }
 
   if (update_tool_tip)
@@ -1659,6 +1815,7 @@ void View::ViewHierarchyChangedImpl(bool register_accelerators,
 void View::PropagateNativeThemeChanged(const ui::NativeTheme* theme) {
   for (int i = 0, count = child_count(); i < count; ++i)
     child_at(i)->PropagateNativeThemeChanged(theme);
+  retained_paint_.clear();
   OnNativeThemeChanged(theme);
 }
 
@@ -1675,6 +1832,8 @@ void View::VisibilityChangedImpl(View* starting_from, bool is_visible) {
 }
 
 void View::BoundsChanged(const gfx::Rect& previous_bounds) {
+  UpdateHitTestIndexInParent();
+
   if (visible_) {
     // Paint the new bounds.
     SchedulePaintBoundsChanged(
@@ -1928,6 +2087,36 @@ void View::DestroyLayer() {
 
 // Input -----------------------------------------------------------------------
 
+View* View::GetEventHandlerForPointInChild(View* child,
+                                           const gfx::Point& point) {
+  if (!child->visible())
+    return NULL;
+
+  gfx::Point point_in_child_coords(point);
+  ConvertPointToTarget(this, child, &point_in_child_coords);
+  if (child->HitTestPoint(point_in_child_coords))
+    return child->GetEventHandlerForPoint(point_in_child_coords);
+  return NULL;
+}
+
+void View::PaintChildIfInClip(View* child,
+                              gfx::Canvas* canvas,
+                              const gfx::Rect& clip_bounds) {
+  if (child->layer() || !child->visible())
+    return;
+  // The same rect Paint() clips to.
+  gfx::Rect child_clip_rect = child->bounds();
+  child_clip_rect.Inset(child->clip_insets_);
+  child_clip_rect.set_x(GetMirroredXForRect(child_clip_rect));
+  if (child_clip_rect.Intersects(clip_bounds))
+    child->Paint(canvas);
+}
+
+void View::UpdateHitTestIndexInParent() {
+  if (parent_ && parent_->child_hit_test_index_.get())
+    parent_->child_hit_test_index_->ChildChanged(this);
+}
+
 bool View::ProcessMousePressed(const ui::MouseEvent& event,
                                DragInfo* drag_info) {
   int drag_operations =
@@ -2123,12 +2312,14 @@ void View::InitFocusSiblings(View* v, int index) {
 void View::PropagateThemeChanged() {
   for (int i = child_count() - 1; i >= 0; --i)
     child_at(i)->PropagateThemeChanged();
+  retained_paint_.clear();
   OnThemeChanged();
 }
 
 void View::PropagateLocaleChanged() {
   for (int i = child_count() - 1; i >= 0; --i)
     child_at(i)->PropagateLocaleChanged();
+  retained_paint_.clear();
   OnLocaleChanged();
 }
 
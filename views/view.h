@@ -21,11 +21,13 @@
 #include "uibase/dragdrop/os_exchange_data.h"
 #include "uibase/events/event.h"
 #include "uibase/events/event_target.h"
+#include "uibase/layout.h"
 #include "compositor/layer_delegate.h"
 #include "compositor/layer_owner.h"
 #include "gfx/native_widget_types.h"
 #include "gfx/rect.h"
 #include "gfx/vector2d.h"
+#include "skia/ext/refptr.h"
 #include "views/background.h"
 #include "views/border.h"
 #include "views/focus_border.h"
@@ -36,6 +38,8 @@
 
 using ui::OSExchangeData;
 
+class SkPicture;
+
 namespace gfx {
 class Canvas;
 class Insets;
@@ -66,6 +70,7 @@ class FocusTraversable;
 class InputMethod;
 class LayoutManager;
 class ScrollView;
+class ViewHitTestIndex;
 class Widget;
 
 namespace internal {
@@ -214,6 +219,10 @@ class VIEWS_EXPORT View : public ui::LayerDelegate,
   virtual int GetBaseline() const;
 
   // Get the size the View would like to be, if enough space were available.
+  // View's implementation asks the layout manager, and caches the result
+  // until InvalidateLayout() is called or a child is added, removed, shown or
+  // hidden. A view whose preferred size changes for any other reason must
+  // call PreferredSizeChanged().
   virtual gfx::Size GetPreferredSize();
 
   // Convenience method that sizes this view to its preferred size.
@@ -230,7 +239,8 @@ class VIEWS_EXPORT View : public ui::LayerDelegate,
   // Return the height necessary to display this view with the provided width.
   // View's implementation returns the value from getPreferredSize.cy.
   // Override if your View's preferred height depends upon the width (such
-  // as with Labels).
+  // as with Labels). The heights computed by the layout manager for the last
+  // few widths are cached like the preferred size.
   virtual int GetHeightForWidth(int w);
 
   // Set whether this view is visible. Painting is scheduled as needed.
@@ -349,6 +359,23 @@ class VIEWS_EXPORT View : public ui::LayerDelegate,
   LayoutManager* GetLayoutManager() const;
   void SetLayoutManager(LayoutManager* layout);
 
+  // Counts of the layout work done by all views since the last
+  // ResetLayoutCounters(), to see how much re-measuring a relayout triggers.
+  struct LayoutCounters {
+    LayoutCounters();
+
+    // Calls to View::Layout().
+    int layouts;
+
+    // Preferred sizes and heights for width computed by layout managers.
+    int measures;
+
+    // Preferred sizes and heights for width returned from the caches.
+    int cache_hits;
+  };
+  static const LayoutCounters& GetLayoutCounters();
+  static void ResetLayoutCounters();
+
   // Attributes ----------------------------------------------------------------
 
   // The view class name.
@@ -451,13 +478,26 @@ class VIEWS_EXPORT View : public ui::LayerDelegate,
   // the hierarchy beneath it.
   virtual void Paint(gfx::Canvas* canvas);
 
+  // When true, the output of OnPaint() is recorded into a picture that is
+  // played back by later paints, instead of calling OnPaint() every time a
+  // descendant repaints. The picture is discarded when this view schedules a
+  // paint, or when its size, theme or locale changes, so the view must call
+  // SchedulePaint() whenever what OnPaint() draws changes. OnPaint() must only
+  // draw through the canvas' Skia interface, not the platform canvas. Worth
+  // turning on for static chrome such as backgrounds, borders, labels and
+  // images. Defaults to false.
+  void SetRetainPaint(bool retain_paint);
+
   // The background object is owned by this object and may be NULL.
   void set_background(Background* b) { background_.reset(b); }
   const Background* background() const { return background_.get(); }
   Background* background() { return background_.get(); }
 
   // The border object is owned by this object and may be NULL.
-  void set_border(Border* b) { border_.reset(b); }
+  void set_border(Border* b) {
+    border_.reset(b);
+    InvalidatePreferredSizeCaches();
+  }
   const Border* border() const { return border_.get(); }
   Border* border() { return border_.get(); }
 
@@ -519,6 +559,13 @@ class VIEWS_EXPORT View : public ui::LayerDelegate,
   // Returns the deepest visible descendant that contains the specified point.
   virtual View* GetEventHandlerForPoint(const gfx::Point& point);
 
+  // When true, this view keeps a spatial index of its children so that
+  // GetEventHandlerForPoint() only tests the children near the point, and
+  // PaintChildren() only visits the children inside the clip, instead of all
+  // of them. Worth turning on for containers with many children. The
+  // children must not accept hits outside their bounds. Defaults to false.
+  void SetUseChildHitTestIndex(bool use);
+
   // Return the cursor that should be used for this view or the default cursor.
   // The event location is in the receiver's coordinate system. The caller is
   // responsible for managing the lifetime of the returned object, though that
@@ -1158,6 +1205,10 @@ class VIEWS_EXPORT View : public ui::LayerDelegate,
     SCHEDULE_PAINT_SIZE_CHANGED
   };
 
+  // SchedulePaintInRect() on behalf of a child. |rect| is in this view's
+  // coordinates.
+  void SchedulePaintInRectForChild(const gfx::Rect& rect);
+
   // Invoked before and after the bounds change to schedule painting the old and
   // new bounds.
   void SchedulePaintBoundsChanged(SchedulePaintType type);
@@ -1166,6 +1217,19 @@ class VIEWS_EXPORT View : public ui::LayerDelegate,
   // invoke OnPaint() on the View.
   void PaintCommon(gfx::Canvas* canvas);
 
+  // Paints the output of OnPaint() from |retained_paint_|, recording it first
+  // if it is missing or stale.
+  void PaintRetained(gfx::Canvas* canvas);
+
+  // Layout --------------------------------------------------------------------
+
+  // Clears the cached preferred size and heights for width of this view and
+  // of its ancestors, whose layout managers may have measured this view.
+  void InvalidatePreferredSizeCaches();
+
+  // Clears the caches of this view only.
+  void ClearPreferredSizeCache();
+
   // Tree operations -----------------------------------------------------------
 
   // Removes |view| from the hierarchy tree.  If |update_focus_cycle| is true,
@@ -1287,6 +1351,21 @@ class VIEWS_EXPORT View : public ui::LayerDelegate,
 
   // Input ---------------------------------------------------------------------
 
+  // Returns the deepest descendant of |child| that contains |point|, or NULL
+  // if |child| is hidden or doesn't contain |point|. |point| is in this
+  // view's coordinates.
+  View* GetEventHandlerForPointInChild(View* child, const gfx::Point& point);
+
+  // Paints |child| unless it has its own layer, is hidden, or lies outside
+  // |clip_bounds|, the clip bounds of |canvas| in this view's coordinates.
+  void PaintChildIfInClip(View* child,
+                          gfx::Canvas* canvas,
+                          const gfx::Rect& clip_bounds);
+
+  // Tells the parent's child hit test index, if any, that the bounds,
+  // visibility or transform of this view changed.
+  void UpdateHitTestIndexInParent();
+
   // RootView invokes these. These in turn invoke the appropriate OnMouseXXX
   // method. If a drag is detected, DoDrag is invoked.
   bool ProcessMousePressed(const ui::MouseEvent& event, DragInfo* drop_info);
@@ -1399,6 +1478,10 @@ class VIEWS_EXPORT View : public ui::LayerDelegate,
   // This flag is initialized to false.
   bool notify_enter_exit_on_child_;
 
+  // Index of the children's bounds used by GetEventHandlerForPoint() and
+  // PaintChildren(). NULL unless SetUseChildHitTestIndex(true) was called.
+  scoped_ptr<ViewHitTestIndex> child_hit_test_index_;
+
   // Whether or not RegisterViewForVisibleBoundsNotification on the RootView
   // has been invoked.
   bool registered_for_visible_bounds_notification_;
@@ -1417,6 +1500,18 @@ class VIEWS_EXPORT View : public ui::LayerDelegate,
   // Whether the view needs to be laid out.
   bool needs_layout_;
 
+  // The preferred size and heights for width last computed by
+  // |layout_manager_|. See InvalidatePreferredSizeCaches().
+  bool preferred_size_valid_;
+  gfx::Size preferred_size_;
+  enum { kHeightForWidthCacheSize = 2 };
+  struct HeightForWidth {
+    int width;
+    int height;
+  };
+  HeightForWidth heights_for_width_[kHeightForWidthCacheSize];
+  size_t next_height_for_width_;
+
   // The View's LayoutManager defines the sizing heuristics applied to child
   // Views. The default is absolute positioning according to bounds_.
   scoped_ptr<LayoutManager> layout_manager_;
@@ -1432,6 +1527,14 @@ class VIEWS_EXPORT View : public ui::LayerDelegate,
   // Focus border.
   scoped_ptr<FocusBorder> focus_border_;
 
+  // Whether SetRetainPaint(true) was called.
+  bool retain_paint_;
+
+  // The recorded output of OnPaint() when |retain_paint_| is true, and the
+  // scale factor it was recorded for. NULL until the next paint if stale.
+  skia::RefPtr<SkPicture> retained_paint_;
+  ui::ScaleFactor retained_paint_scale_factor_;
+
   // RTL painting --------------------------------------------------------------
 
   // Indicates whether or not the gfx::Canvas object passed to View::Paint()
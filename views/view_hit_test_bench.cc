@@ -0,0 +1,104 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// This small program measures the cost of dispatching a mouse move to a
+// container with many small children, such as a grid of cells. For each
+// child count it lays the children out in a square grid, then looks up the
+// event handler for a fixed sequence of pseudo-random points with
+// View::GetEventHandlerForPoint(), with and without the child hit test index
+// (View::SetUseChildHitTestIndex()). The average cost of one lookup is
+// printed in microseconds.
+
+#include <stdio.h>
+
+#include "base/at_exit.h"
+#include "base/basictypes.h"
+#include "base/command_line.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/string_number_conversions.h"
+#include "base/time.h"
+#include "gfx/point.h"
+#include "views/view.h"
+
+namespace {
+
+const int kDefaultMoves = 100000;
+const int kCellSize = 24;
+const int kChildCounts[] = { 16, 256, 1024, 4096, 16384 };
+
+// Returns the number of columns of the grid for |child_count| children.
+int GetColumnCount(int child_count) {
+  int columns = 1;
+  while (columns * columns < child_count)
+    ++columns;
+  return columns;
+}
+
+// Creates a container with |child_count| children laid out in a grid of
+// kCellSize cells, with a one pixel gap between them.
+views::View* CreateContainer(int child_count) {
+  const int columns = GetColumnCount(child_count);
+  views::View* container = new views::View;
+  container->SetBounds(0, 0, columns * kCellSize,
+                       (child_count + columns - 1) / columns * kCellSize);
+  for (int i = 0; i < child_count; ++i) {
+    views::View* child = new views::View;
+    child->SetBounds(i % columns * kCellSize, i / columns * kCellSize,
+                     kCellSize - 1, kCellSize - 1);
+    container->AddChildView(child);
+  }
+  return container;
+}
+
+// Returns the average time in microseconds of a GetEventHandlerForPoint()
+// call on |container|.
+double TimeMoves(views::View* container, int moves) {
+  // A simple LCG so that every run visits the same points.
+  uint32 seed = 12345;
+  const base::TimeTicks start = base::TimeTicks::HighResNow();
+  for (int i = 0; i < moves; ++i) {
+    seed = seed * 1103515245 + 12345;
+    int x = static_cast<int>((seed >> 8) % container->width());
+    seed = seed * 1103515245 + 12345;
+    int y = static_cast<int>((seed >> 8) % container->height());
+    container->GetEventHandlerForPoint(gfx::Point(x, y));
+  }
+  const base::TimeDelta elapsed = base::TimeTicks::HighResNow() - start;
+  return elapsed.InMillisecondsF() * 1000 / moves;
+}
+
+void Usage() {
+  printf("view_hit_test_bench [-moves n] [-help]\n"
+         "  -moves n: mouse moves per measurement (default:%d)\n"
+         "  -help: prints this help and exits\n",
+         kDefaultMoves);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  base::AtExitManager exit_manager;
+  CommandLine::Init(argc, argv);
+  const CommandLine* command_line = CommandLine::ForCurrentProcess();
+
+  int moves = kDefaultMoves;
+  if (command_line->HasSwitch("help") ||
+      (command_line->HasSwitch("moves") &&
+       !base::StringToInt(command_line->GetSwitchValueASCII("moves"),
+                          &moves)) ||
+      moves <= 0) {
+    Usage();
+    return 1;
+  }
+
+  printf("%8s %12s %12s\n", "children", "linear(us)", "indexed(us)");
+  for (size_t i = 0; i < arraysize(kChildCounts); ++i) {
+    scoped_ptr<views::View> container(CreateContainer(kChildCounts[i]));
+    const double linear_us = TimeMoves(container.get(), moves);
+    container->SetUseChildHitTestIndex(true);
+    const double indexed_us = TimeMoves(container.get(), moves);
+    printf("%8d %12.3f %12.3f\n", kChildCounts[i], linear_us, indexed_us);
+  }
+  return 0;
+}
@@ -0,0 +1,228 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "views/view_hit_test_index.h"
+
+#include <algorithm>
+
+#include "base/logging.h"
+#include "gfx/point.h"
+#include "gfx/transform.h"
+#include "views/view.h"
+
+namespace views {
+
+namespace {
+
+// Size of a grid cell, in pixels.
+const int kCellSize = 64;
+
+// Children that would be put in more cells than this are returned from every
+// query instead. Large children are usually few, and this keeps moving them
+// cheap.
+const int kMaxCellsPerChild = 64;
+
+// Returns the grid column or row of |coordinate|, rounding towards negative
+// infinity so that negative coordinates get their own cells.
+int CellIndex(int coordinate) {
+  return coordinate >= 0 ? coordinate / kCellSize :
+      -((-coordinate + kCellSize - 1) / kCellSize);
+}
+
+}  // namespace
+
+class ViewHitTestIndex::ZOrderGreater {
+ public:
+  explicit ZOrderGreater(const Entries& entries) : entries_(&entries) {}
+
+  bool operator()(View* a, View* b) const {
+    return entries_->find(a)->second.z_order >
+        entries_->find(b)->second.z_order;
+  }
+
+ private:
+  const Entries* entries_;
+};
+
+ViewHitTestIndex::Entry::Entry()
+    : z_order(0),
+      unbounded(false) {
+}
+
+ViewHitTestIndex::ViewHitTestIndex(View* host)
+    : host_(host),
+      next_z_order_(0),
+      needs_rebuild_(true) {
+}
+
+ViewHitTestIndex::~ViewHitTestIndex() {
+}
+
+void ViewHitTestIndex::ChildAdded(View* child) {
+  if (needs_rebuild_)
+    return;
+  // Children are usually appended, which doesn't change the order of the
+  // others.
+  if (host_->child_at(host_->child_count() - 1) != child) {
+    needs_rebuild_ = true;
+    return;
+  }
+  Entry& entry = entries_[child];
+  entry.z_order = next_z_order_++;
+  Insert(child, &entry);
+}
+
+void ViewHitTestIndex::ChildRemoved(View* child) {
+  if (needs_rebuild_)
+    return;
+  // Removing a child doesn't change the relative order of the others.
+  Entries::iterator i = entries_.find(child);
+  DCHECK(i != entries_.end());
+  Erase(child, &i->second);
+  entries_.erase(i);
+}
+
+void ViewHitTestIndex::ChildChanged(View* child) {
+  if (needs_rebuild_)
+    return;
+  Entries::iterator i = entries_.find(child);
+  DCHECK(i != entries_.end());
+  Erase(child, &i->second);
+  Insert(child, &i->second);
+}
+
+void ViewHitTestIndex::ChildrenReordered() {
+  needs_rebuild_ = true;
+}
+
+void ViewHitTestIndex::GetChildrenAt(const gfx::Point& point,
+                                     std::vector<View*>* children) {
+  if (needs_rebuild_)
+    Rebuild();
+
+  children->clear();
+  // The grid holds the unmirrored bounds of the children, so mirror the
+  // point instead.
+  Cell cell(CellIndex(host_->GetMirroredXWithWidthInView(point.x(), 1)),
+            CellIndex(point.y()));
+  Cells::const_iterator i = cells_.find(cell);
+  if (i != cells_.end())
+    children->assign(i->second.begin(), i->second.end());
+  children->insert(children->end(),
+                   unbounded_children_.begin(),
+                   unbounded_children_.end());
+  std::sort(children->begin(), children->end(), ZOrderGreater(entries_));
+}
+
+void ViewHitTestIndex::GetChildrenInRect(const gfx::Rect& rect,
+                                         std::vector<View*>* children) {
+  if (needs_rebuild_)
+    Rebuild();
+
+  children->clear();
+  if (rect.IsEmpty())
+    return;
+  // The grid holds the unmirrored bounds of the children, so mirror the
+  // rect instead.
+  const int x = host_->GetMirroredXForRect(rect);
+  const int left = CellIndex(x);
+  const int top = CellIndex(rect.y());
+  const int right = CellIndex(x + rect.width() - 1);
+  const int bottom = CellIndex(rect.bottom() - 1);
+  const int64 cell_count = static_cast<int64>(right - left + 1) *
+      (bottom - top + 1);
+  if (cell_count > static_cast<int64>(cells_.size())) {
+    // Large rects, such as a full repaint, cover more cells than are filled.
+    for (Cells::const_iterator i = cells_.begin(); i != cells_.end(); ++i) {
+      const Cell& cell = i->first;
+      if (cell.first >= left && cell.first <= right &&
+          cell.second >= top && cell.second <= bottom) {
+        children->insert(children->end(), i->second.begin(), i->second.end());
+      }
+    }
+  } else {
+    for (int row = top; row <= bottom; ++row) {
+      for (int column = left; column <= right; ++column) {
+        Cells::const_iterator i = cells_.find(Cell(column, row));
+        if (i != cells_.end()) {
+          children->insert(children->end(),
+                           i->second.begin(), i->second.end());
+        }
+      }
+    }
+  }
+  children->insert(children->end(),
+                   unbounded_children_.begin(),
+                   unbounded_children_.end());
+  // A child that spans several cells was added once per cell.
+  ZOrderGreater z_order_greater(entries_);
+  std::sort(children->begin(), children->end(), z_order_greater);
+  children->erase(std::unique(children->begin(), children->end()),
+                  children->end());
+}
+
+void ViewHitTestIndex::Rebuild() {
+  entries_.clear();
+  cells_.clear();
+  unbounded_children_.clear();
+  for (int i = 0; i < host_->child_count(); ++i) {
+    View* child = host_->child_at(i);
+    Entry& entry = entries_[child];
+    entry.z_order = i;
+    Insert(child, &entry);
+  }
+  next_z_order_ = host_->child_count();
+  needs_rebuild_ = false;
+}
+
+void ViewHitTestIndex::Insert(View* child, Entry* entry) {
+  DCHECK(entry->cells.IsEmpty());
+  DCHECK(!entry->unbounded);
+  const gfx::Rect& bounds = child->bounds();
+  if (!child->visible() || bounds.IsEmpty())
+    return;
+
+  gfx::Rect cells;
+  if (child->GetTransform().IsIdentity()) {
+    int left = CellIndex(bounds.x());
+    int top = CellIndex(bounds.y());
+    cells.SetRect(left, top,
+                  CellIndex(bounds.right() - 1) - left + 1,
+                  CellIndex(bounds.bottom() - 1) - top + 1);
+  }
+  if (cells.IsEmpty() || cells.width() * cells.height() > kMaxCellsPerChild) {
+    entry->unbounded = true;
+    unbounded_children_.insert(child);
+    return;
+  }
+
+  entry->cells = cells;
+  for (int y = cells.y(); y < cells.bottom(); ++y) {
+    for (int x = cells.x(); x < cells.right(); ++x)
+      cells_[Cell(x, y)].push_back(child);
+  }
+}
+
+void ViewHitTestIndex::Erase(View* child, Entry* entry) {
+  if (entry->unbounded) {
+    unbounded_children_.erase(child);
+    entry->unbounded = false;
+    return;
+  }
+
+  const gfx::Rect& cells = entry->cells;
+  for (int y = cells.y(); y < cells.bottom(); ++y) {
+    for (int x = cells.x(); x < cells.right(); ++x) {
+      Cells::iterator i = cells_.find(Cell(x, y));
+      DCHECK(i != cells_.end());
+      std::vector<View*>& views = i->second;
+      views.erase(std::find(views.begin(), views.end(), child));
+      if (views.empty())
+        cells_.erase(i);
+    }
+  }
+  entry->cells = gfx::Rect();
+}
+
+}  // namespace views
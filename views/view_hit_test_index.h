@@ -0,0 +1,110 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef VIEWS_VIEW_HIT_TEST_INDEX_H_
+#define VIEWS_VIEW_HIT_TEST_INDEX_H_
+
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "gfx/rect.h"
+
+namespace gfx {
+class Point;
+}
+
+namespace views {
+
+class View;
+
+// A uniform grid over the bounds of the children of a View. It lets
+// View::GetEventHandlerForPoint() test only the children near a point, and
+// View::PaintChildren() visit only the children inside the clip, instead of
+// every child. The host View keeps the index up to date as
+// children are added, removed, reordered, moved, shown or hidden. See
+// View::SetUseChildHitTestIndex().
+//
+// Children with a transform, and children that span many cells, are not put
+// in the grid. They are returned from every query, so the caller's exact hit
+// test still decides for them.
+class ViewHitTestIndex {
+ public:
+  explicit ViewHitTestIndex(View* host);
+  ~ViewHitTestIndex();
+
+  // Called after |child| has been added to or removed from the host.
+  void ChildAdded(View* child);
+  void ChildRemoved(View* child);
+
+  // Called when the bounds, visibility or transform of |child| changed.
+  void ChildChanged(View* child);
+
+  // Called when the z-order of the host's children changed.
+  void ChildrenReordered();
+
+  // Sets |children| to the visible children of the host that may contain
+  // |point|, topmost first. |point| is in the host's coordinates.
+  void GetChildrenAt(const gfx::Point& point, std::vector<View*>* children);
+
+  // Sets |children| to the visible children of the host that may intersect
+  // |rect|, topmost first. |rect| is in the host's coordinates.
+  void GetChildrenInRect(const gfx::Rect& rect, std::vector<View*>* children);
+
+ private:
+  // Grid column and row.
+  typedef std::pair<int, int> Cell;
+  typedef std::map<Cell, std::vector<View*> > Cells;
+
+  struct Entry {
+    Entry();
+
+    // Position of the child in the host's z-order. Only the relative order
+    // of the entries matters.
+    int z_order;
+
+    // Columns and rows of the cells that hold the child. Empty if the child
+    // is not in the grid.
+    gfx::Rect cells;
+
+    // True if the child is in |unbounded_children_|.
+    bool unbounded;
+  };
+  typedef std::map<View*, Entry> Entries;
+
+  // Orders children topmost first.
+  class ZOrderGreater;
+
+  // Reassigns the z-order of all children and refills the grid.
+  void Rebuild();
+
+  // Adds |child| to the grid or to |unbounded_children_|, or to neither if it
+  // is hidden.
+  void Insert(View* child, Entry* entry);
+
+  // Undoes Insert().
+  void Erase(View* child, Entry* entry);
+
+  View* host_;
+
+  Entries entries_;
+  Cells cells_;
+
+  // Children that are returned from every query.
+  std::set<View*> unbounded_children_;
+
+  int next_z_order_;
+
+  // True when a child was inserted anywhere but on top, or the children were
+  // reordered. The index is rebuilt by the next query.
+  bool needs_rebuild_;
+
+  DISALLOW_COPY_AND_ASSIGN(ViewHitTestIndex);
+};
+
+}  // namespace views
+
+#endif  // VIEWS_VIEW_HIT_TEST_INDEX_H_
@@ -0,0 +1,133 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// This small program measures the cost of relaying out a dialog-like
+// hierarchy after one leaf changed its preferred size, such as a label whose
+// text changed. The root uses a GridLayout with one row per panel, and each
+// panel lays out its leaves with a horizontal BoxLayout. After a leaf changes,
+// the root is resized to its preferred height for its width and laid out.
+// For each panel count the average time of one relayout is printed in
+// microseconds, with the View::GetLayoutCounters() it incurred: the layout
+// manager measurements, the measurements returned from the caches, and the
+// calls to View::Layout().
+
+#include <stdio.h>
+
+#include "base/at_exit.h"
+#include "base/basictypes.h"
+#include "base/command_line.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/string_number_conversions.h"
+#include "base/time.h"
+#include "gfx/size.h"
+#include "views/layout/box_layout.h"
+#include "views/layout/grid_layout.h"
+#include "views/view.h"
+
+namespace {
+
+const int kDefaultRelayouts = 1000;
+const int kLeavesPerPanel = 8;
+const int kPanelCounts[] = { 4, 16, 64, 256 };
+
+// A leaf with a settable preferred size.
+class LeafView : public views::View {
+ public:
+  LeafView() : preferred_size_(40, 20) {}
+
+  void SetPreferredWidth(int width) {
+    preferred_size_.set_width(width);
+    PreferredSizeChanged();
+  }
+
+  virtual gfx::Size GetPreferredSize() OVERRIDE {
+    return preferred_size_;
+  }
+
+ private:
+  gfx::Size preferred_size_;
+
+  DISALLOW_COPY_AND_ASSIGN(LeafView);
+};
+
+// Creates the root view with |panel_count| panels, and sets |changing_leaf|
+// to the leaf that changes between relayouts.
+views::View* CreateRoot(int panel_count, LeafView** changing_leaf) {
+  views::View* root = new views::View;
+  views::GridLayout* layout = new views::GridLayout(root);
+  root->SetLayoutManager(layout);
+  views::ColumnSet* column_set = layout->AddColumnSet(0);
+  column_set->AddColumn(views::GridLayout::FILL, views::GridLayout::FILL, 1,
+                        views::GridLayout::USE_PREF, 0, 0);
+  for (int i = 0; i < panel_count; ++i) {
+    views::View* panel = new views::View;
+    panel->SetLayoutManager(
+        new views::BoxLayout(views::BoxLayout::kHorizontal, 2, 2, 4));
+    for (int j = 0; j < kLeavesPerPanel; ++j) {
+      LeafView* leaf = new LeafView;
+      panel->AddChildView(leaf);
+      if (i == panel_count / 2 && j == 0)
+        *changing_leaf = leaf;
+    }
+    layout->StartRow(0, 0);
+    layout->AddView(panel);
+  }
+  return root;
+}
+
+// Relays out |root| |relayouts| times, changing |leaf| before each one.
+// Returns the average time of one relayout in microseconds.
+double TimeRelayouts(views::View* root, LeafView* leaf, int relayouts) {
+  const int width = root->GetPreferredSize().width();
+  views::View::ResetLayoutCounters();
+  const base::TimeTicks start = base::TimeTicks::HighResNow();
+  for (int i = 0; i < relayouts; ++i) {
+    leaf->SetPreferredWidth(40 + i % 2);
+    root->SetBounds(0, 0, width, root->GetHeightForWidth(width));
+    root->Layout();
+  }
+  const base::TimeDelta elapsed = base::TimeTicks::HighResNow() - start;
+  return elapsed.InMillisecondsF() * 1000 / relayouts;
+}
+
+void Usage() {
+  printf("view_layout_bench [-relayouts n] [-help]\n"
+         "  -relayouts n: relayouts per measurement (default:%d)\n"
+         "  -help: prints this help and exits\n",
+         kDefaultRelayouts);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  base::AtExitManager exit_manager;
+  CommandLine::Init(argc, argv);
+  const CommandLine* command_line = CommandLine::ForCurrentProcess();
+
+  int relayouts = kDefaultRelayouts;
+  if (command_line->HasSwitch("help") ||
+      (command_line->HasSwitch("relayouts") &&
+       !base::StringToInt(command_line->GetSwitchValueASCII("relayouts"),
+                          &relayouts)) ||
+      relayouts <= 0) {
+    Usage();
+    return 1;
+  }
+
+  printf("%6s %12s %9s %11s %8s\n",
+         "panels", "relayout(us)", "measures", "cache hits", "layouts");
+  for (size_t i = 0; i < arraysize(kPanelCounts); ++i) {
+    LeafView* leaf = NULL;
+    scoped_ptr<views::View> root(CreateRoot(kPanelCounts[i], &leaf));
+    const double relayout_us = TimeRelayouts(root.get(), leaf, relayouts);
+    const views::View::LayoutCounters& counters =
+        views::View::GetLayoutCounters();
+    printf("%6d %12.3f %9.1f %11.1f %8.1f\n",
+           kPanelCounts[i], relayout_us,
+           static_cast<double>(counters.measures) / relayouts,
+           static_cast<double>(counters.cache_hits) / relayouts,
+           static_cast<double>(counters.layouts) / relayouts);
+  }
+  return 0;
+}
@@ -0,0 +1,145 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// This small program measures the cost of repainting a small dirty rect of a
+// container with many small children, such as a grid of cells where one cell
+// changed. For each child count it lays the children out in a square grid
+// and paints the container into a canvas clipped to a fixed sequence of
+// pseudo-random cell sized rects: once calling Paint() on every child the way
+// View::PaintChildren() used to, once with the clip culling of
+// View::PaintChildren(), and once with the child index as well
+// (View::SetUseChildHitTestIndex()). The average cost of one repaint is
+// printed in microseconds.
+
+#include <stdio.h>
+
+#include "base/at_exit.h"
+#include "base/basictypes.h"
+#include "base/command_line.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/string_number_conversions.h"
+#include "base/time.h"
+#include "gfx/canvas.h"
+#include "gfx/rect.h"
+#include "views/view.h"
+
+namespace {
+
+const int kDefaultPaints = 10000;
+const int kCellSize = 24;
+const int kChildCounts[] = { 16, 256, 1024, 4096, 16384 };
+
+// A cell that fills its bounds.
+class CellView : public views::View {
+ public:
+  CellView() {}
+
+  virtual void OnPaint(gfx::Canvas* canvas) OVERRIDE {
+    canvas->FillRect(GetLocalBounds(), SK_ColorBLUE);
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(CellView);
+};
+
+// A container that paints all of its children, letting each one find out
+// that it is outside the clip.
+class UnculledContainerView : public views::View {
+ public:
+  UnculledContainerView() {}
+
+  virtual void PaintChildren(gfx::Canvas* canvas) OVERRIDE {
+    for (int i = 0, count = child_count(); i < count; ++i)
+      if (!child_at(i)->layer())
+        child_at(i)->Paint(canvas);
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(UnculledContainerView);
+};
+
+// Returns the number of columns of the grid for |child_count| children.
+int GetColumnCount(int child_count) {
+  int columns = 1;
+  while (columns * columns < child_count)
+    ++columns;
+  return columns;
+}
+
+// Lays out |child_count| cells in |container| in a grid of kCellSize cells,
+// with a one pixel gap between them, and returns |container|.
+views::View* FillContainer(views::View* container, int child_count) {
+  const int columns = GetColumnCount(child_count);
+  container->SetBounds(0, 0, columns * kCellSize,
+                       (child_count + columns - 1) / columns * kCellSize);
+  for (int i = 0; i < child_count; ++i) {
+    views::View* child = new CellView;
+    child->SetBounds(i % columns * kCellSize, i / columns * kCellSize,
+                     kCellSize - 1, kCellSize - 1);
+    container->AddChildView(child);
+  }
+  return container;
+}
+
+// Returns the average time in microseconds of painting |container| into a
+// canvas clipped to a cell sized rect.
+double TimePaints(views::View* container, int paints) {
+  gfx::Canvas canvas(container->size(), ui::SCALE_FACTOR_100P, true);
+  // A simple LCG so that every run repaints the same rects.
+  uint32 seed = 12345;
+  const base::TimeTicks start = base::TimeTicks::HighResNow();
+  for (int i = 0; i < paints; ++i) {
+    seed = seed * 1103515245 + 12345;
+    int x = static_cast<int>((seed >> 8) % container->width());
+    seed = seed * 1103515245 + 12345;
+    int y = static_cast<int>((seed >> 8) % container->height());
+    canvas.Save();
+    canvas.ClipRect(gfx::Rect(x, y, kCellSize, kCellSize));
+    container->Paint(&canvas);
+    canvas.Restore();
+  }
+  const base::TimeDelta elapsed = base::TimeTicks::HighResNow() - start;
+  return elapsed.InMillisecondsF() * 1000 / paints;
+}
+
+void Usage() {
+  printf("view_paint_bench [-paints n] [-help]\n"
+         "  -paints n: repaints per measurement (default:%d)\n"
+         "  -help: prints this help and exits\n",
+         kDefaultPaints);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  base::AtExitManager exit_manager;
+  CommandLine::Init(argc, argv);
+  const CommandLine* command_line = CommandLine::ForCurrentProcess();
+
+  int paints = kDefaultPaints;
+  if (command_line->HasSwitch("help") ||
+      (command_line->HasSwitch("paints") &&
+       !base::StringToInt(command_line->GetSwitchValueASCII("paints"),
+                          &paints)) ||
+      paints <= 0) {
+    Usage();
+    return 1;
+  }
+
+  printf("%8s %13s %12s %12s\n",
+         "children", "unculled(us)", "culled(us)", "indexed(us)");
+  for (size_t i = 0; i < arraysize(kChildCounts); ++i) {
+    scoped_ptr<views::View> unculled(
+        FillContainer(new UnculledContainerView, kChildCounts[i]));
+    const double unculled_us = TimePaints(unculled.get(), paints);
+    scoped_ptr<views::View> container(
+        FillContainer(new views::View, kChildCounts[i]));
+    const double culled_us = TimePaints(container.get(), paints);
+    container->SetUseChildHitTestIndex(true);
+    const double indexed_us = TimePaints(container.get(), paints);
+    printf("%8d %13.3f %12.3f %12.3f\n",
+           kChildCounts[i], unculled_us, culled_us, indexed_us);
+  }
+  return 0;
+}
@@ -334,6 +334,8 @@
         'view.h',
         'view_constants.cc',
         'view_constants.h',
+        'view_hit_test_index.cc',
+        'view_hit_test_index.h',
         'view_aura.cc',
         'view_model.cc',
         'view_model.h',
@@ -989,5 +991,53 @@
         }],
       ],
     },  # target_name: views_examples_with_content_exe
+    {
+      'target_name': 'view_hit_test_bench',
+      'type': 'executable',
+      'dependencies': [
+        '../../base/base.gyp:base',
+        '../../skia/skia.gyp:skia',
+        '../ui.gyp:ui',
+        'views',
+      ],
+      'include_dirs': [
+        '..',
+      ],
+      'sources': [
+        'view_hit_test_bench.cc',
+      ],
+    },  # target_name: view_hit_test_bench
+    {
+      'target_name': 'view_paint_bench',
+      'type': 'executable',
+      'dependencies': [
+        '../../base/base.gyp:base',
+        '../../skia/skia.gyp:skia',
+        '../ui.gyp:ui',
+        'views',
+      ],
+      'include_dirs': [
+        '..',
+      ],
+      'sources': [
+        'view_paint_bench.cc',
+      ],
+    },  # target_name: view_paint_bench
+    {
+      'target_name': 'view_layout_bench',
+      'type': 'executable',
+      'dependencies': [
+        '../../base/base.gyp:base',
+        '../../skia/skia.gyp:skia',
+        '../ui.gyp:ui',
+        'views',
+      ],
+      'include_dirs': [
+        '..',
+      ],
+      'sources': [
+        'view_layout_bench.cc',
+      ],
+    },  # target_name: view_layout_bench
   ],
 }